@@ -0,0 +1,255 @@
+// Microbenchmarks for the engine's hot paths: the per tick object updates, the bullet and spike collision
+// checks from Game::Update (the same functions the game calls), an object's model matrix (cached and worked out
+// again), the player's steering, filling a particle system's vertices and loading a text file. Each one runs at
+// 100, 1000, ... up to max_count items and the results go to stdout as JSON (ns per item and items per second),
+// so runs from two builds can be diffed.
+// Everything runs without a window, the GL objects are never drawn.
+//
+// usage: apd_bench [max_count] [filter]   (default 100000, only benchmarks with filter in their name run)
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "collision_checks.h"
+#include "command_buffer.h"
+#include "enemy_game_object.h"
+#include "file_utils.h"
+#include "particles.h"
+#include "player_game_object.h"
+#include "projectile_game_object.h"
+#include "random_streams.h"
+#include "spatial_grid.h"
+#include "swept_circle.h"
+
+#include "bench_util.h"
+
+using namespace game;
+using namespace bench;
+
+namespace {
+
+    // keep running a benchmark until it has taken at least this long
+    const double min_seconds_g = 0.25;
+
+    struct Result {
+        std::string name;
+        int count;
+        long iterations;
+        double ns_per_op;
+        double items_per_sec;
+    };
+
+    // Run body (one pass over count items) once to warm up, then over and over until enough time has passed
+    template <typename Body>
+    Result Measure(const std::string &name, int count, Body body)
+    {
+        body();
+
+        long iterations = 0;
+        double time = 0.0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        do {
+            body();
+            iterations++;
+            time = Seconds(start);
+        } while (time < min_seconds_g || iterations < 3);
+
+        double items = static_cast<double>(iterations) * count;
+        Result result = { name, count, iterations, time / items * 1e9, items / time };
+        std::cerr << name << "/" << count << ": " << result.ns_per_op << " ns/op" << std::endl;
+        return result;
+    }
+
+    // spread things over a world that grows with the count so density stays about the same as in game
+    std::vector<glm::vec3> Scatter(Random &random, int count)
+    {
+        float half = 2.0f * sqrtf(static_cast<float>(count));
+        std::vector<glm::vec3> positions;
+        for (int i = 0; i < count; i++) {
+            positions.push_back(glm::vec3(random.Range(-half, half), random.Range(-half, half), 0.0f));
+        }
+        return positions;
+    }
+
+    void PrintJson(std::ostream &out, const std::vector<Result> &results, int max_count)
+    {
+        out << std::fixed;
+        out << "{" << std::endl;
+        out << "  \"context\": {\"max_count\": " << max_count << ", \"hardware_threads\": " << std::thread::hardware_concurrency()
+            << ", \"swept_circles\": \"" << SweepCirclesPath() << "\"}," << std::endl;
+        out << "  \"benchmarks\": [" << std::endl;
+        for (int i = 0; i < results.size(); i++) {
+            const Result &r = results[i];
+            out << "    {\"name\": \"" << r.name << "\", \"count\": " << r.count << ", \"iterations\": " << r.iterations
+                << ", \"ns_per_op\": " << std::setprecision(3) << r.ns_per_op
+                << ", \"items_per_sec\": " << std::setprecision(0) << r.items_per_sec << "}"
+                << ((i + 1 < results.size()) ? "," : "") << std::endl;
+        }
+        out << "  ]" << std::endl;
+        out << "}" << std::endl;
+    }
+
+} // namespace
+
+
+int main(int argc, char **argv)
+{
+    int max_count = (argc > 1) ? atoi(argv[1]) : 100000;
+    std::string filter = (argc > 2) ? argv[2] : "";
+    if (max_count <= 0) {
+        std::cerr << "usage: " << argv[0] << " [max_count] [filter]" << std::endl;
+        return 1;
+    }
+
+    const double dt = 1.0 / 60.0;
+    RandomStreams::Default().Seed(2501);
+    Random random(2501);
+
+    std::vector<Result> results;
+    SpatialGrid enemy_grid(1.0f);
+    CommandBuffer commands(1);
+    CollisionScratch scratch;
+
+    for (int count = 100; count <= max_count; count *= 10) {
+        std::vector<glm::vec3> enemy_positions = Scatter(random, count);
+        std::vector<glm::vec3> bullet_positions = Scatter(random, count);
+
+        // half the enemies patrol and half are chasing something, like once the player gets close
+        // (held in an EntityMap like the game's, which the collision checks read them from)
+        EntityMap<EnemyGameObject> enemies;
+        for (int i = 0; i < count; i++) {
+            enemies.Add(new EnemyGameObject(enemy_positions[i], NULL, NULL, 0, 1, i % 2));
+            if (i % 2) enemies[i]->SetTarget(glm::vec3(0.0f, 0.0f, 0.0f));
+        }
+
+        // bullets move about this far in a tick
+        std::vector<ProjectileGameObject *> bullets;
+        for (int i = 0; i < count; i++) {
+            bullets.push_back(new ProjectileGameObject(bullet_positions[i], NULL, NULL, 0));
+            bullets.back()->SetVelocity(glm::vec3(random.Range(-0.2f, 0.2f), random.Range(-0.2f, 0.2f), 0.0f));
+            bullets.back()->SetRotation(random.Range(0.0f, 6.28f));
+        }
+
+        if (std::string("EnemyGameObject::Update").find(filter) != std::string::npos) {
+            results.push_back(Measure("EnemyGameObject::Update", count, [&]() {
+                for (int i = 0; i < count; i++) enemies[i]->Update(dt);
+            }));
+        }
+
+        if (std::string("ProjectileGameObject::Update").find(filter) != std::string::npos) {
+            results.push_back(Measure("ProjectileGameObject::Update", count, [&]() {
+                for (int i = 0; i < count; i++) bullets[i]->Update(dt);
+            }));
+        }
+
+        // the collision passes read the enemies through the grid, built once a tick in the game
+        enemy_grid.Clear();
+        for (int j = 0; j < count; j++) {
+            enemy_grid.Insert(j, enemies[j]->GetPosition());
+        }
+        enemy_grid.Build();
+
+        // the bullets dont move between runs here, only the collision work is timed: the same checks the game's
+        // collision passes make, and the commands they emit
+        if (std::string("Game::Update bullets").find(filter) != std::string::npos) {
+            results.push_back(Measure("Game::Update bullets", count, [&]() {
+                commands.Clear();
+                for (int i = 0; i < count; i++) {
+                    unsigned int order = CommandBuffer::Order(2, i);
+                    int target = FindBulletHit(bullet_positions[i], bullets[i]->GetVelocity(), enemy_grid, enemies, scratch);
+                    if (target >= 0) {
+                        commands.Emit(0, order, Command::Damage(Command::ENEMY, target, 1));
+                        commands.Emit(0, order, Command::Kill(Command::BULLET, i));
+                    }
+                    else if (bullets[i]->GetTimer() == 2) {
+                        commands.Emit(0, order, Command::Kill(Command::BULLET, i));
+                    }
+                }
+            }));
+        }
+
+        if (std::string("Game::Update spikes").find(filter) != std::string::npos) {
+            results.push_back(Measure("Game::Update spikes", count, [&]() {
+                commands.Clear();
+                for (int i = 0; i < count; i++) {
+                    unsigned int order = CommandBuffer::Order(3, i);
+                    int j = FindSpikeHit(bullet_positions[i], enemy_grid, scratch);
+                    if (j >= 0) {
+                        commands.Emit(0, order, Command::Damage(Command::ENEMY, j, 1));
+                        commands.Emit(0, order, Command::Kill(Command::SPIKE, i));
+                    }
+                }
+            }));
+        }
+
+        // objects that didnt move get their matrix from the transform store's cache, ones that did have it worked out again
+        if (std::string("GameObject::GetTransformation").find(filter) != std::string::npos) {
+            results.push_back(Measure("GameObject::GetTransformation", count, [&]() {
+                float check = 0.0f;
+                for (int i = 0; i < count; i++) check += bullets[i]->GetTransformation(0.5f)[3][0];
+                sink_g = check;
+            }));
+        }
+
+        if (std::string("GameObject::GetTransformation moving").find(filter) != std::string::npos) {
+            results.push_back(Measure("GameObject::GetTransformation moving", count, [&]() {
+                float check = 0.0f;
+                for (int i = 0; i < count; i++) {
+                    bullets[i]->SetPosition(bullets[i]->GetPosition());
+                    check += bullets[i]->GetTransformation(0.5f)[3][0];
+                }
+                sink_g = check;
+            }));
+        }
+
+        if (std::string("PlayerGameObject::SetVelocity").find(filter) != std::string::npos) {
+            PlayerGameObject player(glm::vec3(0.0f, 0.0f, 0.0f), NULL, NULL, 0);
+            glm::vec3 pushes[] = { glm::vec3(0.001f, 0.0f, 0.0f), glm::vec3(0.0f, 0.001f, 0.0f), glm::vec3(-0.001f, 0.0f, 0.0f), glm::vec3(0.0f, -0.001f, 0.0f) };
+            results.push_back(Measure("PlayerGameObject::SetVelocity", count, [&]() {
+                for (int i = 0; i < count; i++) player.SetVelocity(pushes[i % 4]);
+                sink_g = player.GetVelocity().x;
+            }));
+        }
+
+        // count is the number of particle vertices here, the game makes NUM_PARTICLES of them per system
+        if (std::string("Particles::CreateGeometry").find(filter) != std::string::npos) {
+            Particles particles;
+            std::vector<GLfloat> vertices;
+            results.push_back(Measure("Particles::CreateGeometry", count, [&]() {
+                particles.BuildVertices(vertices, count);
+                sink_g = vertices[0];
+            }));
+        }
+
+        // count is the number of lines in the file, a shader is around 50
+        if (std::string("LoadTextFile").find(filter) != std::string::npos) {
+            const char *filename = "apd_bench_text.tmp";
+            std::ofstream file(filename);
+            for (int i = 0; i < count; i++) {
+                file << "    gl_Position = view_matrix * transformation_matrix * vec4(vertex, 0.0, 1.0);\n";
+            }
+            file.close();
+
+            results.push_back(Measure("LoadTextFile", count, [&]() {
+                sink_g = static_cast<float>(LoadTextFile(filename).size());
+            }));
+            remove(filename);
+        }
+
+        for (int i = 0; i < count; i++) {
+            delete bullets[i];
+        }
+    }
+
+    PrintJson(std::cout, results, max_count);
+
+    return 0;
+}
@@ -0,0 +1,20 @@
+#ifndef BENCH_UTIL_H_
+#define BENCH_UTIL_H_
+
+#include <chrono>
+
+// What every benchmark needs, each one is its own program so these are only ever in one translation unit
+namespace bench {
+
+    // results go here so the compiler cant throw the work away
+    static volatile float sink_g;
+
+    // Seconds since start
+    inline double Seconds(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+} // namespace bench
+
+#endif // BENCH_UTIL_H_
@@ -0,0 +1,143 @@
+// Broadphase benchmark: times the collision passes from Game::Update done the old brute force way
+// and through SpatialGrid, for growing numbers of enemies and projectiles.
+//
+// usage: apd_broadphase_bench [max_count]   (default 10000)
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "spatial_grid.h"
+
+#include "bench_util.h"
+
+using namespace game;
+using namespace bench;
+
+namespace {
+
+    struct Scene {
+        std::vector<glm::vec3> enemies;
+        std::vector<glm::vec3> bullets;
+        std::vector<glm::vec3> velocities;
+    };
+
+    float Random(float lo, float hi)
+    {
+        return lo + (hi - lo) * (rand() / static_cast<float>(RAND_MAX));
+    }
+
+    // spread things over a world that grows with the count so density stays about the same as in game
+    Scene MakeScene(int count)
+    {
+        Scene scene;
+        float half = 2.0f * sqrtf(static_cast<float>(count));
+        for (int i = 0; i < count; i++) {
+            scene.enemies.push_back(glm::vec3(Random(-half, half), Random(-half, half), 0.0f));
+            scene.bullets.push_back(glm::vec3(Random(-half, half), Random(-half, half), 0.0f));
+            // bullets move about this far in a tick
+            scene.velocities.push_back(glm::vec3(Random(-0.2f, 0.2f), Random(-0.2f, 0.2f), 0.0f));
+        }
+        return scene;
+    }
+
+    // the same swept circle test Game::Update uses for bullets
+    bool SweptHit(const glm::vec3 &start, const glm::vec3 &d, const glm::vec3 &centre)
+    {
+        glm::vec3 sc = start - centre;
+        double a = glm::dot(d, d);
+        double b = 2 * glm::dot(d, sc);
+        double c = glm::dot(sc, sc) - 0.1f;
+        double disc = b * b - 4 * a * c;
+        if (disc < 0) return false;
+        disc = sqrt(disc);
+        double t1 = (-b - disc) / (2 * a);
+        double t2 = (-b + disc) / (2 * a);
+        return t1 <= 0 && t2 >= 1;
+    }
+
+    // bullets against enemies and spikes (same shape as bullets here) against enemies, checking every pair
+    long BruteForce(const Scene &scene)
+    {
+        long hits = 0;
+        for (int i = 0; i < scene.bullets.size(); i++) {
+            for (int j = 0; j < scene.enemies.size(); j++) {
+                if (SweptHit(scene.bullets[i], scene.velocities[i], scene.enemies[j])) hits++;
+            }
+            for (int j = 0; j < scene.enemies.size(); j++) {
+                if (glm::length(scene.bullets[i] - scene.enemies[j]) < 0.8f) hits++;
+            }
+        }
+        return hits;
+    }
+
+    long Grid(const Scene &scene, SpatialGrid &grid, std::vector<int> &nearby)
+    {
+        grid.Clear();
+        for (int j = 0; j < scene.enemies.size(); j++) {
+            grid.Insert(j, scene.enemies[j]);
+        }
+        grid.Build();
+
+        long hits = 0;
+        for (int i = 0; i < scene.bullets.size(); i++) {
+            nearby.clear();
+            grid.QuerySegment(scene.bullets[i], scene.bullets[i] + scene.velocities[i], 0.32f, nearby);
+            for (int n = 0; n < nearby.size(); n++) {
+                if (SweptHit(scene.bullets[i], scene.velocities[i], scene.enemies[nearby[n]])) hits++;
+            }
+
+            nearby.clear();
+            grid.QueryRadius(scene.bullets[i], 0.8f, nearby);
+            hits += nearby.size();
+        }
+        return hits;
+    }
+
+} // namespace
+
+
+int main(int argc, char **argv)
+{
+    int max_count = (argc > 1) ? atoi(argv[1]) : 10000;
+    if (max_count <= 0) {
+        std::cerr << "usage: " << argv[0] << " [max_count]" << std::endl;
+        return 1;
+    }
+
+    srand(2501);
+
+    SpatialGrid grid(1.0f);
+    std::vector<int> nearby;
+
+    std::cout << "count\tbrute ms/tick\tgrid ms/tick\tspeedup\thits" << std::endl;
+
+    for (int count = 100; count <= max_count; count *= 10) {
+        Scene scene = MakeScene(count);
+
+        // brute force gets very slow at the top end, so run it fewer times
+        int brute_runs = (count >= 10000) ? 1 : 10;
+        int grid_runs = 100;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        long brute_hits = 0;
+        for (int r = 0; r < brute_runs; r++) brute_hits = BruteForce(scene);
+        double brute = Seconds(start) / brute_runs;
+
+        start = std::chrono::steady_clock::now();
+        long grid_hits = 0;
+        for (int r = 0; r < grid_runs; r++) grid_hits = Grid(scene, grid, nearby);
+        double fast = Seconds(start) / grid_runs;
+
+        if (brute_hits != grid_hits) {
+            std::cerr << "mismatch at " << count << ": brute force found " << brute_hits << " hits, grid found " << grid_hits << std::endl;
+            return 1;
+        }
+
+        std::cout << count << "\t" << brute * 1000.0 << "\t" << fast * 1000.0 << "\t" << brute / fast << "x\t" << grid_hits << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+// Culling benchmark: checks ViewCuller never throws away a circle that reaches onto the screen (against the exact
+// circle and rectangle test, for the game's camera and for a turned one), then times culling count objects spread
+// over the 100 unit ocean with the game's camera, and how many of them would still be drawn.
+//
+// usage: apd_cull_bench [max_count] [cases]   (default 1000000 objects, 1000000 cases)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "view_culler.h"
+
+#include "bench_util.h"
+
+using namespace game;
+using namespace bench;
+
+namespace {
+
+    float Random(float lo, float hi)
+    {
+        return lo + (hi - lo) * (rand() / static_cast<float>(RAND_MAX));
+    }
+
+    // The game's view, as Game::Render builds it: the window's aspect, zoomed out to a quarter, then turned by angle
+    // and moved to the camera (written out, the camera never turns in the game but the culler shouldn't care)
+    glm::mat4 View(float aspect, float zoom, float angle, const glm::vec3 &camera)
+    {
+        float c = cosf(angle);
+        float s = sinf(angle);
+        glm::mat4 view(1.0f);
+        view[0][0] = zoom * c / aspect;
+        view[0][1] = zoom * s;
+        view[1][0] = -zoom * s / aspect;
+        view[1][1] = zoom * c;
+        view[3][0] = -(view[0][0] * camera.x + view[1][0] * camera.y);
+        view[3][1] = -(view[0][1] * camera.x + view[1][1] * camera.y);
+        return view;
+    }
+
+    // The exact test: the circle, taken into the camera's turned frame, reaches the screen's rectangle
+    bool Reference(float aspect, float zoom, float angle, const glm::vec3 &camera, float x, float y, float r)
+    {
+        float c = cosf(angle);
+        float s = sinf(angle);
+        float dx = x - camera.x;
+        float dy = y - camera.y;
+        float lx = c * dx - s * dy;
+        float ly = s * dx + c * dy;
+        float hw = aspect / zoom;
+        float hh = 1.0f / zoom;
+        float ox = std::max(fabsf(lx) - hw, 0.0f);
+        float oy = std::max(fabsf(ly) - hh, 0.0f);
+        return ox * ox + oy * oy <= r * r;
+    }
+
+} // namespace
+
+
+int main(int argc, char **argv)
+{
+    int max_count = (argc > 1) ? atoi(argv[1]) : 1000000;
+    int cases = (argc > 2) ? atoi(argv[2]) : 1000000;
+    if (max_count <= 0 || cases <= 0) {
+        std::cerr << "usage: " << argv[0] << " [max_count] [cases]" << std::endl;
+        return 1;
+    }
+
+    const float aspect = 800.0f / 600.0f;
+    const float zoom = 0.25f;
+
+    // the culler only has the four edges to go on, so a circle just off a corner can get through, but one that
+    // reaches the screen must never be culled
+    srand(1);
+    long dropped = 0;
+    long kept_off_screen = 0;
+    long on_screen = 0;
+    ViewCuller culler;
+    for (int i = 0; i < cases; i++) {
+        float angle = (i % 2) ? Random(-3.14159f, 3.14159f) : 0.0f;
+        glm::vec3 camera(Random(-50.0f, 50.0f), Random(-50.0f, 50.0f), 0.0f);
+        float x = camera.x + Random(-12.0f, 12.0f);
+        float y = camera.y + Random(-12.0f, 12.0f);
+        float r = Random(0.0f, 4.0f);
+
+        // skip cases right on the edge, where float rounding can go either way
+        float c = cosf(angle);
+        float s = sinf(angle);
+        float lx = c * (x - camera.x) - s * (y - camera.y);
+        float ly = s * (x - camera.x) + c * (y - camera.y);
+        if (fabsf(fabsf(lx) - aspect / zoom - r) < 1e-3f || fabsf(fabsf(ly) - 1.0f / zoom - r) < 1e-3f) continue;
+
+        culler.SetView(View(aspect, zoom, angle, camera));
+        bool kept = culler.IsVisible(x, y, r);
+        bool seen = Reference(aspect, zoom, angle, camera, x, y, r);
+        if (seen) on_screen++;
+        if (seen && !kept) dropped++;
+        if (!seen && kept) kept_off_screen++;
+    }
+    std::cout << "cases: " << cases << ", on screen " << on_screen << ", culled while on screen " << dropped
+              << ", kept while off screen " << kept_off_screen << std::endl;
+    if (dropped > 0) {
+        std::cerr << "FAILED: circles that reach the screen were culled" << std::endl;
+        return 1;
+    }
+
+    // the game's view on an ocean full of sprites, about the size of enemies and bullets
+    std::cout << "count\tns per object\tdrawn\tculled" << std::endl;
+    culler.SetView(View(aspect, zoom, 0.0f, glm::vec3(0.0f)));
+    for (int count = 1000; count <= max_count; count *= 10) {
+        std::vector<float> x(count), y(count), radius(count);
+        std::vector<int> visible(count);
+        for (int i = 0; i < count; i++) {
+            x[i] = Random(-50.0f, 50.0f);
+            y[i] = Random(-50.0f, 50.0f);
+            radius[i] = Random(0.1f, 0.8f);
+        }
+
+        // enough rounds to see past the timer's resolution even for small counts
+        int rounds = std::max(10, 20000000 / count);
+        int drawn = 0;
+        culler.ResetCounts();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            drawn = culler.Cull(x.data(), y.data(), radius.data(), count, visible.data());
+        }
+        double seconds = Seconds(start);
+
+        std::cout << count << "\t" << seconds / (static_cast<double>(rounds) * count) * 1e9 << "\t" << drawn << "\t"
+                  << culler.GetCulled() / rounds << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+// Fast trig benchmark: checks FastSinCos, FastAtan2, their batched versions and WrapAngle against libm on
+// random cases (exiting with an error if any is outside its bound), then times libm against them over
+// count angles, the bearing and patrol math the game does once per object per tick.
+//
+// usage: apd_fast_math_bench [count] [cases]   (default 100000 objects, 1000000 cases)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "fast_math.h"
+#include "random_streams.h"
+
+#include "bench_util.h"
+
+using namespace game;
+using namespace bench;
+
+namespace {
+
+    // Print the worst error seen and whether it's inside the bound
+    bool Check(const char *name, double worst, double bound)
+    {
+        std::cout << name << ": max error " << worst << " (bound " << bound << ")" << (worst <= bound ? "" : "  FAILED") << std::endl;
+        return worst <= bound;
+    }
+
+    // Run body over the arrays enough times to get past the timer's resolution, returns ns per item
+    template <typename Body>
+    double Time(int count, Body body)
+    {
+        int runs = std::max(10, 20000000 / count);
+        body();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int r = 0; r < runs; r++) body();
+        return Seconds(start) / (static_cast<double>(runs) * count) * 1e9;
+    }
+
+} // namespace
+
+
+int main(int argc, char **argv)
+{
+    int count = (argc > 1) ? atoi(argv[1]) : 100000;
+    int cases = (argc > 2) ? atoi(argv[2]) : 1000000;
+    if (count <= 0 || cases <= 0) {
+        std::cerr << "usage: " << argv[0] << " [count] [cases]" << std::endl;
+        return 1;
+    }
+
+    Random random(17);
+
+    // accuracy, over angles as big as a patrol phase gets and vectors of any length and direction
+    std::vector<float> angles(cases), ys(cases), xs(cases);
+    for (int i = 0; i < cases; i++) {
+        angles[i] = random.Range(-10000.0f, 10000.0f);
+        ys[i] = random.Range(-100.0f, 100.0f) * ((i % 4 == 0) ? 1e-3f : 1.0f);
+        xs[i] = random.Range(-100.0f, 100.0f);
+    }
+    // the axes and the origin, where atan2 changes octant or has nothing to go on
+    const float edges[][2] = { { 0.0f, 1.0f }, { 1.0f, 0.0f }, { 0.0f, -1.0f }, { -1.0f, 0.0f }, { 1.0f, 1.0f }, { -1.0f, -1.0f }, { 0.0f, 0.0f } };
+    for (int e = 0; e < 7 && e < cases; e++) {
+        ys[e] = edges[e][0];
+        xs[e] = edges[e][1];
+    }
+
+    std::vector<float> s(cases), c(cases), t(cases);
+    SinCosBatch(angles.data(), s.data(), c.data(), cases);
+    Atan2Batch(ys.data(), xs.data(), t.data(), cases);
+
+    double sincos_error = 0.0, batch_sincos_error = 0.0, atan2_error = 0.0, batch_atan2_error = 0.0, wrap_error = 0.0;
+    long batch_mismatches = 0;
+    for (int i = 0; i < cases; i++) {
+        double a = angles[i];
+        float fs, fc;
+        FastSinCos(angles[i], fs, fc);
+        sincos_error = std::max(sincos_error, std::max(fabs(fs - sin(a)), fabs(fc - cos(a))));
+        batch_sincos_error = std::max(batch_sincos_error, std::max(fabs(s[i] - sin(a)), fabs(c[i] - cos(a))));
+
+        double reference = atan2(static_cast<double>(ys[i]), static_cast<double>(xs[i]));
+        float ft = FastAtan2(ys[i], xs[i]);
+        atan2_error = std::max(atan2_error, fabs(ft - reference));
+        batch_atan2_error = std::max(batch_atan2_error, fabs(t[i] - reference));
+
+        if (fs != s[i] || fc != c[i] || ft != t[i]) batch_mismatches++;
+
+        // how far the wrapped angle is from the real one round the circle, in [0, 2pi) and the same direction
+        float w = WrapAngle(angles[i]);
+        double wrap_diff = fabs(remainder(static_cast<double>(w) - a, 2.0 * M_PI));
+        if (w < 0.0f || w >= 6.2831853f) wrap_diff = 1.0;
+        wrap_error = std::max(wrap_error, wrap_diff);
+    }
+
+    std::cout << "path: " << FastMathPath() << ", " << cases << " cases" << std::endl;
+    bool ok = true;
+    ok = Check("FastSinCos", sincos_error, 2e-7) && ok;
+    ok = Check("SinCosBatch", batch_sincos_error, 2e-7) && ok;
+    ok = Check("FastAtan2", atan2_error, 4e-7) && ok;
+    ok = Check("Atan2Batch", batch_atan2_error, 4e-7) && ok;
+    ok = Check("WrapAngle", wrap_error, 1e-6) && ok;
+    std::cout << "batched results differing from the single versions: " << batch_mismatches << std::endl;
+    if (!ok) return 1;
+
+    // throughput, angles like the objects' rotations and directions like their steps
+    angles.resize(count);
+    ys.resize(count);
+    xs.resize(count);
+    s.resize(count);
+    c.resize(count);
+    t.resize(count);
+    for (int i = 0; i < count; i++) {
+        angles[i] = random.Range(0.0f, 6.2831853f);
+    }
+
+    std::cout << count << " objects" << std::endl;
+    std::cout << "function\tlibm ns/op\tfast ns/op\tbatch ns/op\tspeedup (batch)" << std::endl;
+
+    double libm = Time(count, [&]() {
+        for (int i = 0; i < count; i++) {
+            s[i] = sinf(angles[i]);
+            c[i] = cosf(angles[i]);
+        }
+        sink_g = s[count / 2];
+    });
+    double fast = Time(count, [&]() {
+        for (int i = 0; i < count; i++) FastSinCos(angles[i], s[i], c[i]);
+        sink_g = s[count / 2];
+    });
+    double batch = Time(count, [&]() {
+        SinCosBatch(angles.data(), s.data(), c.data(), count);
+        sink_g = s[count / 2];
+    });
+    std::cout << "sincos\t" << libm << "\t" << fast << "\t" << batch << "\t" << libm / batch << "x" << std::endl;
+
+    for (int i = 0; i < count; i++) {
+        ys[i] = s[i] * random.Range(0.1f, 2.0f);
+        xs[i] = c[i] * random.Range(0.1f, 2.0f);
+    }
+
+    libm = Time(count, [&]() {
+        for (int i = 0; i < count; i++) t[i] = atan2f(ys[i], xs[i]);
+        sink_g = t[count / 2];
+    });
+    fast = Time(count, [&]() {
+        for (int i = 0; i < count; i++) t[i] = FastAtan2(ys[i], xs[i]);
+        sink_g = t[count / 2];
+    });
+    batch = Time(count, [&]() {
+        Atan2Batch(ys.data(), xs.data(), t.data(), count);
+        sink_g = t[count / 2];
+    });
+    std::cout << "atan2\t" << libm << "\t" << fast << "\t" << batch << "\t" << libm / batch << "x" << std::endl;
+
+    // wrapping has no batched version, the loop vectorizes well enough by itself
+    for (int i = 0; i < count; i++) {
+        angles[i] = random.Range(-20.0f, 20.0f);
+    }
+    libm = Time(count, [&]() {
+        for (int i = 0; i < count; i++) {
+            float a = fmodf(angles[i], 6.2831853f);
+            t[i] = (a < 0.0f) ? a + 6.2831853f : a;
+        }
+        sink_g = t[count / 2];
+    });
+    fast = Time(count, [&]() {
+        for (int i = 0; i < count; i++) t[i] = WrapAngle(angles[i]);
+        sink_g = t[count / 2];
+    });
+    std::cout << "wrap\t" << libm << "\t" << fast << "\t-\t" << libm / fast << "x" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Tentacle IK benchmark: solves chains of the kraken's shape (tapering segments rooted round a centre)
+// reaching for targets that move every tick, for 8 up to max_chains chains of 4 up to max_segments
+// segments, on 1 thread and on threads threads. It checks first that every segment keeps its length and
+// that tips reach targets in range (exiting with an error if not).
+//
+// usage: apd_ik_bench [max_chains] [max_segments] [threads]   (default 4096 chains, 32 segments, one per hardware thread)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <glm/glm.hpp>
+
+#include "ik_solver.h"
+#include "job_system.h"
+
+#include "bench_util.h"
+
+using namespace game;
+using namespace bench;
+
+namespace {
+
+    // chains spread round circles like a crowd of krakens, each one first segment 0.35 long tapering by 0.9
+    void Build(IkSolver &solver, int chains, int segments)
+    {
+        solver.Clear();
+        for (int c = 0; c < chains; c++) {
+            float angle = 2.0f * 3.14159265f * (c % 8) / 8.0f;
+            glm::vec3 centre(static_cast<float>(c / 8 % 64) * 10.0f, static_cast<float>(c / 512) * 10.0f, 0.0f);
+            solver.AddChain(centre + 0.4f * glm::vec3(cosf(angle), sinf(angle), 0.0f), segments, 0.35f, 0.9f, angle);
+        }
+    }
+
+    // Point every chain somewhere new, swinging round its root at about 0.7 of its reach
+    void Aim(IkSolver &solver, int tick)
+    {
+        for (int c = 0; c < solver.GetChainCount(); c++) {
+            glm::vec3 root = solver.GetJoint(c, 0);
+            float swing = 0.05f * tick + c;
+            solver.SetTarget(c, root + 0.7f * solver.GetReach(c) * glm::vec3(cosf(swing), sinf(swing), 0.0f));
+        }
+    }
+
+} // namespace
+
+
+int main(int argc, char **argv)
+{
+    int max_chains = (argc > 1) ? atoi(argv[1]) : 4096;
+    int max_segments = (argc > 2) ? atoi(argv[2]) : 32;
+    int threads = (argc > 3) ? atoi(argv[3]) : 0;
+    if (max_chains <= 0 || max_segments <= 0 || threads < 0) {
+        std::cerr << "usage: " << argv[0] << " [max_chains] [max_segments] [threads]" << std::endl;
+        return 1;
+    }
+
+    JobSystem jobs(threads);
+
+    // check the solver before timing it: lengths kept, and tips on target once it's had a few ticks to get there
+    {
+        IkSolver solver;
+        Build(solver, 64, 12);
+        float worst_length = 0.0f;
+        float worst_tip = 0.0f;
+        for (int tick = 0; tick < 200; tick++) {
+            Aim(solver, tick);
+            solver.Solve(&jobs);
+            for (int c = 0; c < solver.GetChainCount(); c++) {
+                for (int s = 0; s < solver.GetSegmentCount(c); s++) {
+                    float length = glm::length(solver.GetJoint(c, s + 1) - solver.GetJoint(c, s));
+                    worst_length = std::max(worst_length, fabsf(length - solver.GetLength(c, s)));
+                }
+                float swing = 0.05f * tick + c;
+                glm::vec3 target = solver.GetJoint(c, 0) + 0.7f * solver.GetReach(c) * glm::vec3(cosf(swing), sinf(swing), 0.0f);
+                if (tick > 10) worst_tip = std::max(worst_tip, glm::length(solver.GetJoint(c, solver.GetSegmentCount(c)) - target));
+            }
+        }
+        std::cout << "worst segment length error " << worst_length << ", worst tip miss " << worst_tip << std::endl;
+        if (worst_length > 1e-3f || worst_tip > 0.05f) {
+            std::cerr << "FAILED: chains stretched or missed targets in reach" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "threads: " << jobs.GetThreadCount() << std::endl;
+    std::cout << "chains\tsegments\tus/tick 1 thread\tus/tick " << jobs.GetThreadCount() << " threads\tns/joint 1 thread" << std::endl;
+
+    for (int chains = 8; chains <= max_chains; chains *= 8) {
+        for (int segments = 4; segments <= max_segments; segments *= 2) {
+            IkSolver solver;
+            Build(solver, chains, segments);
+
+            // enough ticks to see past the timer's resolution even for small counts
+            int ticks = std::max(20, 20000000 / (chains * segments));
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (int tick = 0; tick < ticks; tick++) {
+                Aim(solver, tick);
+                solver.Solve();
+            }
+            double single = Seconds(start) / ticks;
+
+            Build(solver, chains, segments);
+            start = std::chrono::steady_clock::now();
+            for (int tick = 0; tick < ticks; tick++) {
+                Aim(solver, tick);
+                solver.Solve(&jobs);
+            }
+            double parallel = Seconds(start) / ticks;
+
+            sink_g = solver.GetJoint(0, segments).x;
+
+            std::cout << chains << "\t" << segments << "\t" << single * 1e6 << "\t" << parallel * 1e6 << "\t"
+                      << single / (static_cast<double>(chains) * segments) * 1e9 << std::endl;
+        }
+    }
+
+    return 0;
+}
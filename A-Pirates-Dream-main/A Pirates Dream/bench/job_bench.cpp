@@ -0,0 +1,106 @@
+// Job system scaling benchmark: the enemy patrol update (orbit a centre, ease the heading round) over a
+// TransformStore full of enemies, run through JobSystem::ParallelFor on 1 up to max_threads threads.
+// Speedup is against the 1 thread run, which does everything inline like the game used to.
+//
+// usage: apd_job_bench [max_threads] [count]   (default 16 threads, 1000000 enemies)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "job_system.h"
+#include "transform_store.h"
+
+#include "bench_util.h"
+
+using namespace game;
+using namespace bench;
+
+namespace {
+
+    // what EnemyGameObject keeps outside the transform for its patrol
+    struct Patrol {
+        float centre_x;
+        float centre_y;
+        float radius;
+        float phase;
+    };
+
+    // one tick of patrol movement for rows [begin, end), the same shape of work as EnemyGameObject::Update
+    void PatrolRange(TransformStore &store, std::vector<Patrol> &patrols, float dt, int begin, int end)
+    {
+        for (int i = begin; i < end; i++) {
+            Patrol &p = patrols[i];
+            p.phase += dt;
+            float target_x = p.centre_x + p.radius * cosf(p.phase);
+            float target_y = p.centre_y + p.radius * sinf(p.phase);
+            float dx = target_x - store.X(i);
+            float dy = target_y - store.Y(i);
+            float length = sqrtf(dx * dx + dy * dy) + 1e-6f;
+            store.VelocityX(i) = dx / length;
+            store.VelocityY(i) = dy / length;
+            store.X(i) += store.VelocityX(i) * dt;
+            store.Y(i) += store.VelocityY(i) * dt;
+            store.Angle(i) = atan2f(dy, dx);
+        }
+    }
+
+} // namespace
+
+
+int main(int argc, char **argv)
+{
+    int max_threads = (argc > 1) ? atoi(argv[1]) : 16;
+    int count = (argc > 2) ? atoi(argv[2]) : 1000000;
+    if (max_threads <= 0 || count <= 0) {
+        std::cerr << "usage: " << argv[0] << " [max_threads] [count]" << std::endl;
+        return 1;
+    }
+
+    const float dt = 1.0f / 60.0f;
+    const int grain = 64;
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << ", enemies: " << count << std::endl;
+    std::cout << "threads\tms/tick\tns/entity\tspeedup" << std::endl;
+
+    // enough ticks to see past the timer's resolution even for small counts
+    int ticks = std::max(10, 50000000 / count);
+    double single_time = 0.0;
+
+    for (int threads = 1; threads <= max_threads; threads = (threads < 2) ? 2 : threads + 2) {
+        // fresh state per run so every thread count does the same work
+        TransformStore store;
+        std::vector<Patrol> patrols(count);
+        for (int i = 0; i < count; i++) {
+            store.Create(glm::vec3((i % 1000) * 0.5f, (i / 1000) * 0.5f, 0.0f));
+            patrols[i].centre_x = store.X(i);
+            patrols[i].centre_y = store.Y(i);
+            patrols[i].radius = 1.0f + (i % 7) * 0.25f;
+            patrols[i].phase = (i % 13) * 0.5f;
+        }
+
+        JobSystem jobs(threads);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; t++) {
+            jobs.ParallelFor(count, grain, [&](int begin, int end) {
+                PatrolRange(store, patrols, dt, begin, end);
+            });
+        }
+        double time = Seconds(start);
+        if (threads == 1) single_time = time;
+
+        float check = 0.0f;
+        for (int i = 0; i < count; i++) check += store.X(i);
+        sink_g = check;
+
+        std::cout << threads << "\t" << time / ticks * 1e3 << "\t" << time / (static_cast<double>(ticks) * count) * 1e9 << "\t"
+                  << single_time / time << "x" << std::endl;
+    }
+
+    return 0;
+}
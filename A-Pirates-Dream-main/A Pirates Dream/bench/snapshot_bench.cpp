@@ -0,0 +1,95 @@
+// Snapshot benchmark: fills a headless game with count entities through a stress scenario, then times
+// Game::SaveSnapshot and Game::LoadSnapshot. It also checks that a save, load and save again gives the
+// same bytes, and that rolling back and replaying some ticks ends in the same state as the first time
+// (exiting with an error if either doesnt).
+//
+// usage: apd_snapshot_bench [count]   (default 10000 entities)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "game.h"
+#include "game_config.h"
+#include "snapshot.h"
+
+#include "bench_util.h"
+
+using namespace game;
+using namespace bench;
+
+
+int main(int argc, char **argv)
+{
+    int count = (argc > 1) ? atoi(argv[1]) : 10000;
+    if (count <= 0) {
+        std::cerr << "usage: " << argv[0] << " [count]" << std::endl;
+        return 1;
+    }
+
+    // about what a busy game has, mostly enemies, a fifth collectibles and a tenth bullets (each with its trail)
+    GameConfig config;
+    config.headless = true;
+    config.threads = 1;
+    config.seed = 1;
+    config.stress = true;
+    config.scenario.Set("navy_ships", std::to_string(count / 2));
+    config.scenario.Set("sea_monsters", std::to_string(std::max(1, count / 5)));
+    config.scenario.Set("collectibles", std::to_string(std::max(1, count / 5)));
+    config.scenario.Set("projectiles", std::to_string(std::max(1, count / 10)));
+    config.scenario.Set("extent", "50");
+
+    Game game;
+    game.Init(config);
+    game.Setup();
+
+    // a few ticks first so the enemies are mid chase, bullets mid flight and explosions going off
+    for (int t = 0; t < 30; t++) game.Step();
+
+    Snapshot snapshot;
+    game.SaveSnapshot(snapshot);
+    std::cout << "entities: " << count << ", snapshot: " << snapshot.GetSize() << " bytes" << std::endl;
+
+    // enough rounds to see past the timer's resolution even for small counts
+    int rounds = std::max(20, 2000000 / count);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) game.SaveSnapshot(snapshot);
+    double save_time = Seconds(start) / rounds;
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) game.LoadSnapshot(snapshot);
+    double load_time = Seconds(start) / rounds;
+
+    double megabytes = snapshot.GetSize() / 1e6;
+    std::cout << "save\t" << save_time * 1e6 << " us\t" << megabytes / save_time << " MB/s" << std::endl;
+    std::cout << "load\t" << load_time * 1e6 << " us\t" << megabytes / load_time << " MB/s" << std::endl;
+
+    // loading a snapshot and saving again has to give back the same bytes
+    Snapshot again;
+    game.LoadSnapshot(snapshot);
+    game.SaveSnapshot(again);
+    if (!(again == snapshot)) {
+        std::cerr << "FAILED: saving a loaded snapshot gave different bytes" << std::endl;
+        return 1;
+    }
+
+    // and rolling back has to play out the same ticks the same way
+    const int ticks = 120;
+    Snapshot before, first, second;
+    game.SaveSnapshot(before);
+    for (int t = 0; t < ticks; t++) game.Step();
+    game.SaveSnapshot(first);
+    game.LoadSnapshot(before);
+    for (int t = 0; t < ticks; t++) game.Step();
+    game.SaveSnapshot(second);
+    if (!(first == second)) {
+        std::cerr << "FAILED: rolling back " << ticks << " ticks and playing them again ended somewhere else" << std::endl;
+        return 1;
+    }
+
+    std::cout << "round trip and rollback over " << ticks << " ticks: same bytes" << std::endl;
+    return 0;
+}
@@ -0,0 +1,109 @@
+// Chunk streaming benchmark: a headless stress game with the same number of enemies and collectibles per unit
+// of sea on seas from 100 units across up to twice max_extent, with far chunks asleep, while the player sails
+// loops through them. Prints the time per tick, what's awake and what's asleep (and the bytes that takes), then
+// the same with streaming off for the seas small enough to run that way. It checks along the way that nothing
+// gets lost or doubled going to sleep and waking up (exiting with an error if it does).
+//
+// usage: apd_stream_bench [max_extent] [ticks]   (default 800 units, 1200 ticks)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "game.h"
+#include "game_config.h"
+
+#include "bench_util.h"
+
+using namespace game;
+using namespace bench;
+
+namespace {
+
+    // enemies and collectibles per square unit, about what the classic game has round the player
+    const double enemy_density_g = 0.01;
+    const double collectible_density_g = 0.0025;
+
+    // Run one sea, returns false if the population didn't add up
+    bool Run(int extent, int ticks, bool streaming)
+    {
+        double area = 4.0 * extent * extent;
+        int enemies = std::max(1, static_cast<int>(enemy_density_g * area));
+        int collectibles = std::max(1, static_cast<int>(collectible_density_g * area));
+
+        GameConfig config;
+        config.headless = true;
+        config.threads = 1;
+        config.seed = 1;
+        config.stress = true;
+        config.scenario.Set("navy_ships", std::to_string(enemies - enemies / 5));
+        config.scenario.Set("sea_monsters", std::to_string(enemies / 5));
+        config.scenario.Set("collectibles", std::to_string(collectibles));
+        config.scenario.Set("projectiles", "20");
+        config.scenario.Set("extent", std::to_string(extent));
+        config.scenario.Set("streaming", streaming ? "true" : "false");
+
+        Game game;
+        game.Init(config);
+        game.Setup();
+
+        // fill the sea first, with streaming the pools only hold the awake share so it takes a while
+        const ChunkStreamer &chunks = game.GetChunks();
+        int warmup = 0;
+        while (warmup < 100000 && game.GetEnemyCount() + chunks.GetSleeping(ChunkStreamer::ENEMY) < enemies)
+        {
+            game.Step(0);
+            warmup++;
+        }
+
+        // sail forward, turning every so often, so the player keeps crossing into new chunks
+        long awake = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; t++)
+        {
+            game.Step(INPUT_FORWARD | ((t % 300 < 40) ? INPUT_TURN_LEFT : 0));
+            awake += game.GetEnemyCount();
+
+            // kills are topped back up on the next tick, but there can never be more than the scenario's
+            if (game.GetEnemyCount() + chunks.GetSleeping(ChunkStreamer::ENEMY) > enemies ||
+                game.GetCollectibleCount() + chunks.GetSleeping(ChunkStreamer::COLLECTIBLE) > collectibles + enemies)
+            {
+                std::cerr << "FAILED: more objects awake and asleep than the scenario has" << std::endl;
+                return false;
+            }
+        }
+        double seconds = Seconds(start);
+
+        std::cout << 2 * extent << "\t" << enemies << "\t" << (streaming ? "on" : "off") << "\t" << seconds / ticks * 1e6 << "\t"
+                  << awake / ticks << "\t" << chunks.GetSleeping(ChunkStreamer::ENEMY) << "\t" << chunks.GetChunkCount() << "\t"
+                  << chunks.GetBytes() / 1024 << std::endl;
+        return true;
+    }
+
+} // namespace
+
+
+int main(int argc, char **argv)
+{
+    int max_extent = (argc > 1) ? atoi(argv[1]) : 800;
+    int ticks = (argc > 2) ? atoi(argv[2]) : 1200;
+    if (max_extent <= 0 || ticks <= 0) {
+        std::cerr << "usage: " << argv[0] << " [max_extent] [ticks]" << std::endl;
+        return 1;
+    }
+
+    std::cout << "sea width\tenemies\tstreaming\tus/tick\tenemies awake\tenemies asleep\tchunks\tKB asleep" << std::endl;
+
+    for (int extent = 50; extent <= max_extent; extent *= 4) {
+        if (!Run(extent, ticks, true)) return 1;
+    }
+
+    // everything awake gets slow quickly, so only the smaller seas
+    for (int extent = 50; extent <= std::min(max_extent, 200); extent *= 4) {
+        if (!Run(extent, ticks, false)) return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,163 @@
+// Swept circle benchmark: checks SweepCircles against the mixed double/float math Game::Update used to do
+// for every bullet and enemy pair, then times both.
+//
+// usage: apd_swept_bench [cases]   (default 1000000)
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "swept_circle.h"
+
+#include "bench_util.h"
+
+using namespace game;
+using namespace bench;
+
+namespace {
+
+    float Random(float lo, float hi)
+    {
+        return lo + (hi - lo) * (rand() / static_cast<float>(RAND_MAX));
+    }
+
+    // the old test, exactly as Game::Update had it
+    bool Reference(const glm::vec3 &start, const glm::vec3 &d, const glm::vec3 &centre)
+    {
+        glm::vec3 sc = start - centre;
+
+        double a = glm::dot(d, d);
+        double b = 2 * glm::dot(d, sc);
+        double c = glm::dot(sc, sc) - 0.1f;
+
+        float disc = pow(b, 2) - 4 * a * c;
+
+        if (disc >= 0)
+        {
+            disc = sqrt(disc);
+
+            float t1 = ((-b) - disc) / (2 * a);
+            float t2 = ((-b) + disc) / (2 * a);
+
+            if(t1 <= 0 && t2 >= 1) return true;
+        }
+        return false;
+    }
+
+    // how far a case is from flipping, both ends of the step have to be inside the circle to hit
+    float Margin(const glm::vec3 &start, const glm::vec3 &d, const glm::vec3 &centre)
+    {
+        float begin = glm::dot(start - centre, start - centre) - 0.1f;
+        float end = glm::dot(start + d - centre, start + d - centre) - 0.1f;
+        return fminf(fabsf(begin), fabsf(end));
+    }
+
+} // namespace
+
+
+int main(int argc, char **argv)
+{
+    int cases = (argc > 1) ? atoi(argv[1]) : 1000000;
+    if (cases <= 0) {
+        std::cerr << "usage: " << argv[0] << " [cases]" << std::endl;
+        return 1;
+    }
+
+    srand(2501);
+
+    std::cout << "kernel: " << SweepCirclesPath() << std::endl;
+
+    // correctness: one bullet step against a batch of enemies scattered around it, over and over
+    // batches of 13 so every build runs both the vector body and the scalar tail
+    const int batch_size = 13;
+    CircleBatch batch;
+    std::vector<glm::vec3> centres(batch_size);
+    std::vector<unsigned char> hit;
+    std::vector<float> toi;
+
+    long checked = 0;
+    long hits = 0;
+    long boundary = 0;
+    for (int n = 0; n < cases; n += batch_size) {
+        glm::vec3 start(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), 0.0f);
+        glm::vec3 d(Random(-0.3f, 0.3f), Random(-0.3f, 0.3f), 0.0f);
+
+        batch.Clear();
+        for (int k = 0; k < batch_size; k++) {
+            centres[k] = glm::vec3(Random(-1.2f, 1.2f), Random(-1.2f, 1.2f), 0.0f);
+            batch.Add(centres[k], 0.1f);
+        }
+
+        int best = SweepCircles(start, d, batch, hit, toi);
+
+        for (int k = 0; k < batch_size; k++) {
+            bool expected = Reference(start, d, centres[k]);
+            if (expected != (hit[k] != 0)) {
+                // float and double can only disagree right on the edge of the circle
+                if (Margin(start, d, centres[k]) > 1e-5f) {
+                    std::cerr << "mismatch: start (" << start.x << ", " << start.y << "), step (" << d.x << ", " << d.y
+                              << "), centre (" << centres[k].x << ", " << centres[k].y << "), expected " << expected << std::endl;
+                    return 1;
+                }
+                boundary++;
+            }
+            if (hit[k]) {
+                hits++;
+                if (toi[k] > 0.0f || toi[k] < toi[best]) {
+                    std::cerr << "bad time of impact " << toi[k] << " for circle " << k << std::endl;
+                    return 1;
+                }
+            }
+            checked++;
+        }
+        if (best == -1) {
+            for (int k = 0; k < batch_size; k++) {
+                if (hit[k]) {
+                    std::cerr << "hit reported without an earliest impact" << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    std::cout << "checked " << checked << " pairs, " << hits << " hits, " << boundary << " differed on the boundary" << std::endl;
+
+    // speed: one step against a big packed batch, the way a bullet sees a crowded area
+    const int packed = 4096;
+    batch.Clear();
+    std::vector<glm::vec3> enemies(packed);
+    for (int k = 0; k < packed; k++) {
+        enemies[k] = glm::vec3(Random(-1.2f, 1.2f), Random(-1.2f, 1.2f), 0.0f);
+        batch.Add(enemies[k], 0.1f);
+    }
+
+    int runs = 2000;
+    glm::vec3 start(0.1f, -0.05f, 0.0f);
+    glm::vec3 d(0.02f, 0.01f, 0.0f);
+
+    std::chrono::steady_clock::time_point clock = std::chrono::steady_clock::now();
+    long reference_hits = 0;
+    for (int r = 0; r < runs; r++) {
+        for (int k = 0; k < packed; k++) {
+            if (Reference(start, d, enemies[k])) reference_hits++;
+        }
+    }
+    double reference = Seconds(clock);
+
+    clock = std::chrono::steady_clock::now();
+    long kernel_hits = 0;
+    for (int r = 0; r < runs; r++) {
+        SweepCircles(start, d, batch, hit, toi);
+        for (int k = 0; k < packed; k++) kernel_hits += hit[k];
+    }
+    double kernel = Seconds(clock);
+
+    double pairs = static_cast<double>(runs) * packed;
+    std::cout << "reference: " << reference / pairs * 1e9 << " ns/pair (" << reference_hits << " hits)" << std::endl;
+    std::cout << "kernel:    " << kernel / pairs * 1e9 << " ns/pair (" << kernel_hits << " hits), " << reference / kernel << "x" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Transform storage benchmark: the per tick transform work (save the previous transform, then move by velocity)
+// done over separately allocated objects the way GameObject used to hold its transform, and over TransformStore's arrays.
+// Run it under "perf stat -e cache-misses,cache-references" to see the cache side of the difference.
+//
+// usage: apd_transform_bench [max_count]   (default 1000000)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "transform_store.h"
+
+#include "bench_util.h"
+
+using namespace game;
+using namespace bench;
+
+namespace {
+
+    // the old GameObject layout: transform fields interleaved with everything else, one heap block per object
+    class OldObject {
+
+        public:
+            OldObject(const glm::vec3 &position) : position_(position), velocity_(0.01f, 0.02f, 0.0f), scale_(1.0f), angle_(0.0f),
+                previous_position_(position), previous_angle_(0.0f), time_(0.0), timer_(0), geometry_(NULL), shader_(NULL), texture_(0) {}
+            virtual ~OldObject() {}
+
+            inline void SavePreviousTransform(void) { previous_position_ = position_; previous_angle_ = angle_; }
+
+            virtual void Update(double delta_time)
+            {
+                position_.x += velocity_.x * static_cast<float>(delta_time);
+                position_.y += velocity_.y * static_cast<float>(delta_time);
+                time_ += delta_time;
+            }
+
+            inline float GetX(void) const { return position_.x; }
+
+        private:
+            glm::vec3 position_;
+            glm::vec3 velocity_;
+            float scale_;
+            float angle_;
+            glm::vec3 previous_position_;
+            float previous_angle_;
+            double time_;
+            int timer_;
+            void *geometry_;
+            void *shader_;
+            unsigned int texture_;
+    };
+
+} // namespace
+
+
+int main(int argc, char **argv)
+{
+    int max_count = (argc > 1) ? atoi(argv[1]) : 1000000;
+    if (max_count <= 0) {
+        std::cerr << "usage: " << argv[0] << " [max_count]" << std::endl;
+        return 1;
+    }
+
+    srand(2501);
+    const double dt = 1.0 / 60.0;
+
+    std::cout << "count\tobjects ns/entity\tstore ns/entity\tspeedup" << std::endl;
+
+    for (int count = 1000; count <= max_count; count *= 10) {
+        // objects get allocated alongside other things in a real game, and get visited in an order that has
+        // nothing to do with where they landed in memory, so shuffle the list and leave gaps between them
+        std::vector<OldObject*> objects;
+        std::vector<char*> filler;
+        for (int i = 0; i < count; i++) {
+            objects.push_back(new OldObject(glm::vec3(i * 0.1f, 0.0f, 0.0f)));
+            filler.push_back(new char[16 + rand() % 112]);
+        }
+        std::mt19937 rng(count);
+        std::shuffle(objects.begin(), objects.end(), rng);
+
+        TransformStore store;
+        for (int i = 0; i < count; i++) {
+            int row = store.Create(glm::vec3(i * 0.1f, 0.0f, 0.0f));
+            store.VelocityX(row) = 0.01f;
+            store.VelocityY(row) = 0.02f;
+        }
+
+        // enough ticks to see past the timer's resolution even for small counts
+        int ticks = std::max(10, 20000000 / count);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; t++) {
+            for (int i = 0; i < count; i++) objects[i]->SavePreviousTransform();
+            for (int i = 0; i < count; i++) objects[i]->Update(dt);
+        }
+        double old_time = Seconds(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; t++) {
+            store.SaveAll();
+            for (int i = 0; i < count; i++) {
+                store.X(i) += store.VelocityX(i) * static_cast<float>(dt);
+                store.Y(i) += store.VelocityY(i) * static_cast<float>(dt);
+            }
+        }
+        double store_time = Seconds(start);
+
+        float check = 0.0f;
+        for (int i = 0; i < count; i++) check += objects[i]->GetX() - store.X(i);
+        sink_g = check;
+
+        double entity_ticks = static_cast<double>(ticks) * count;
+        std::cout << count << "\t" << old_time / entity_ticks * 1e9 << "\t" << store_time / entity_ticks * 1e9 << "\t"
+                  << old_time / store_time << "x" << std::endl;
+
+        for (int i = 0; i < count; i++) {
+            delete objects[i];
+            delete[] filler[i];
+        }
+    }
+
+    return 0;
+}
@@ -1,13 +1,19 @@
 #include "child_game_object.h"
+#include "fast_math.h"
+#include "snapshot.h"
 
 namespace game {
 
-ChildGameObject::ChildGameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture, GameObject *parent, int mode)
+ChildGameObject::ChildGameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture, const EntityTable *parents, EntityHandle parent, int mode)
 	: GameObject(position, geom, shader, texture) 
     {
+        parents_ = parents;
         parent_ = parent;
         angle_offset_ = 0;
         mode_ = mode;
+
+        // our transform hangs off the parent's, so a limb made of children of children bends all the way down
+        SetTransformParent(parents_->Lookup(parent_));
     }
 
 void ChildGameObject::SetRotation(float angle)
@@ -24,17 +30,31 @@ void ChildGameObject::SetRotation(float angle)
 // Update function for moving the player object around
 void ChildGameObject::Update(double delta_time) {
 
-	position_.x = parent_->GetPosition().x + 1.0f * scale_;
-    position_.y = parent_->GetPosition().y + 1.0f * scale_;
+    // our position is an offset from the parent, in the parent's frame so it turns with it
+    // if the parent is gone the game cleans us up before we're drawn again
+    PositionX() = 1.0f * GetScale();
+    PositionY() = 1.0f * GetScale();
 
-    if (static_cast<int>( time_ * 30 ) < static_cast<int>( (time_ + delta_time) * 30 ) ) 
-    {
-        angle_ = (static_cast<float>( static_cast<int>( (time_ + delta_time) * 30 ) % 360 )  * glm::pi<float>() / 180.0f) + angle_offset_;
-        //std::cout << angle_ << std::endl;
-    }
+    // turn a little every tick, 30 degrees a second
+    Angle() = (static_cast<float>( WrapPeriod( (time_ + delta_time) * 30.0, 360.0 ) )  * glm::pi<float>() / 180.0f) + angle_offset_;
+    //std::cout << Angle() << std::endl;
 
 	// Call the parent's update method to move the object in standard way, if desired
 	GameObject::Update(delta_time);
 }
 
+void ChildGameObject::Save(Snapshot &snapshot) const
+{
+    GameObject::Save(snapshot);
+    snapshot.Put(angle_offset_);
+    snapshot.Put(mode_);
+}
+
+void ChildGameObject::Load(Snapshot &snapshot)
+{
+    GameObject::Load(snapshot);
+    angle_offset_ = snapshot.Get<float>();
+    mode_ = snapshot.Get<int>();
+}
+
 } // namespace game
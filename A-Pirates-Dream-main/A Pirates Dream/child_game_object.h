@@ -2,6 +2,7 @@
 #define CHILD_GAME_OBJECT_H_
 
 #include "game_object.h"
+#include "entity_map.h"
 
 namespace game {
 
@@ -9,15 +10,31 @@ namespace game {
     class ChildGameObject : public GameObject {
 
         public:
-            ChildGameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture, GameObject *parent, int mode = 0);
+            // parent is looked up in parents every update, so the child never holds on to a deleted object
+            ChildGameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture, const EntityTable *parents, EntityHandle parent, int mode = 0);
 
             void SetRotation(float angle);
 
             // Update function for moving the blades object around
             void Update(double delta_time) override;
 
+            // true once the object this child hangs off has been destroyed
+            inline bool IsOrphaned(void) const { return !parents_->Lookup(parent_); }
+
+            // where the parent lives
+            inline const EntityTable *GetParents(void) const { return parents_; }
+
+            // Hang the child off another object, for restoring a snapshot once every parent exists again
+            inline void SetParent(const EntityTable *parents, EntityHandle parent) { parents_ = parents; parent_ = parent; SetTransformParent(parents_->Lookup(parent_)); }
+            inline EntityHandle GetParent(void) const { return parent_; }
+
+            // Save and load the angle and mode along with the rest of the object
+            void Save(Snapshot &snapshot) const override;
+            void Load(Snapshot &snapshot) override;
+
         private:
-            GameObject * parent_;
+            const EntityTable *parents_;
+            EntityHandle parent_;
             float angle_offset_;
             int mode_;
 
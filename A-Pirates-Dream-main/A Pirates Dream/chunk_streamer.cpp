@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "chunk_streamer.h"
+
+namespace game {
+
+ChunkStreamer::ChunkStreamer(float chunk_size, int radius)
+{
+    enabled_ = true;
+    centre_x_ = 0;
+    centre_y_ = 0;
+    for (int k = 0; k < NUM_KINDS; k++) sleeping_[k] = 0;
+    Configure(chunk_size, radius);
+}
+
+
+void ChunkStreamer::Configure(float chunk_size, int radius)
+{
+    if (!(chunk_size > 0.0f) || radius < 0) {
+        throw(std::invalid_argument(std::string("Chunks need a positive size and a radius of at least 0")));
+    }
+    chunk_size_ = chunk_size;
+    radius_ = radius;
+}
+
+
+void ChunkStreamer::Recentre(const glm::vec3 &position)
+{
+    centre_x_ = static_cast<int>(floorf(position.x / chunk_size_));
+    centre_y_ = static_cast<int>(floorf(position.y / chunk_size_));
+}
+
+
+Snapshot &ChunkStreamer::Sleep(Kind kind, const glm::vec3 &position)
+{
+    int x = static_cast<int>(floorf(position.x / chunk_size_));
+    int y = static_cast<int>(floorf(position.y / chunk_size_));
+
+    // a new chunk starts out with nothing in it
+    Chunk &chunk = chunks_[Key(x, y)];
+
+    // the object's bytes start wherever the record ends now
+    chunk.starts[kind].push_back(chunk.records[kind].GetSize());
+    sleeping_[kind]++;
+    return chunk.records[kind];
+}
+
+
+int ChunkStreamer::Wake(Kind kind, int room, Snapshot &records)
+{
+    if (chunks_.empty()) return 0;
+
+    // row by row through the window, so the same world always wakes in the same order
+    for (int y = centre_y_ - radius_; y <= centre_y_ + radius_; y++) {
+        for (int x = centre_x_ - radius_; x <= centre_x_ + radius_; x++) {
+            std::unordered_map<long long, Chunk>::iterator found = chunks_.find(Key(x, y));
+            if (found == chunks_.end()) continue;
+
+            Chunk &chunk = found->second;
+            int count = chunk.starts[kind].size();
+            if (count == 0) continue;
+
+            // the pools are full, so nothing can wake anywhere
+            if (room <= 0) return 0;
+
+            if (count <= room) {
+                // everything fits, hand the record over whole rather than copying it
+                std::swap(records, chunk.records[kind]);
+                chunk.records[kind] = Snapshot();
+                chunk.starts[kind].clear();
+            }
+            else {
+                // only the first room objects wake, the rest stay asleep in what's left of the record
+                Snapshot &record = chunk.records[kind];
+                std::vector<long long> &starts = chunk.starts[kind];
+                long long split = starts[room];
+
+                records = Snapshot();
+                records.PutArray(record.GetData(), split);
+                Snapshot rest;
+                rest.PutArray(record.GetData() + split, record.GetSize() - split);
+                std::swap(record, rest);
+
+                starts.erase(starts.begin(), starts.begin() + room);
+                for (int n = 0; n < starts.size(); n++) starts[n] -= split;
+                count = room;
+            }
+            sleeping_[kind] -= count;
+
+            // a chunk with nothing left asleep in it goes
+            bool empty = true;
+            for (int k = 0; k < NUM_KINDS; k++) empty = empty && chunk.starts[k].empty();
+            if (empty) chunks_.erase(found);
+
+            return count;
+        }
+    }
+
+    return 0;
+}
+
+
+void ChunkStreamer::Clear(void)
+{
+    chunks_.clear();
+    for (int k = 0; k < NUM_KINDS; k++) sleeping_[k] = 0;
+}
+
+
+size_t ChunkStreamer::GetBytes(void) const
+{
+    size_t bytes = 0;
+    for (std::unordered_map<long long, Chunk>::const_iterator c = chunks_.begin(); c != chunks_.end(); ++c) {
+        for (int k = 0; k < NUM_KINDS; k++) bytes += c->second.records[k].GetSize();
+    }
+    return bytes;
+}
+
+
+void ChunkStreamer::Print(std::ostream &out) const
+{
+    // whoever printed last may have left the stream on fixed point
+    std::streamsize precision = out.precision(6);
+    std::ios_base::fmtflags flags = out.flags(std::ios_base::dec);
+
+    out << "Chunks: " << sleeping_[ENEMY] << " enemies and " << sleeping_[COLLECTIBLE] << " collectibles asleep in "
+        << chunks_.size() << " chunks (" << GetBytes() << " bytes), " << chunk_size_ << " units wide, awake within "
+        << radius_ << " of the player's" << std::endl;
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+
+void ChunkStreamer::Save(Snapshot &snapshot) const
+{
+    std::vector<long long> keys;
+    keys.reserve(chunks_.size());
+    for (std::unordered_map<long long, Chunk>::const_iterator c = chunks_.begin(); c != chunks_.end(); ++c) {
+        keys.push_back(c->first);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    snapshot.Put(centre_x_);
+    snapshot.Put(centre_y_);
+    snapshot.Put(static_cast<int>(keys.size()));
+    for (int i = 0; i < keys.size(); i++) {
+        const Chunk &chunk = chunks_.find(keys[i])->second;
+        snapshot.Put(keys[i]);
+        for (int k = 0; k < NUM_KINDS; k++) {
+            snapshot.Put(static_cast<int>(chunk.starts[k].size()));
+            snapshot.PutArray(chunk.starts[k].data(), chunk.starts[k].size());
+            snapshot.Put(static_cast<long long>(chunk.records[k].GetSize()));
+            snapshot.PutArray(chunk.records[k].GetData(), chunk.records[k].GetSize());
+        }
+    }
+}
+
+
+void ChunkStreamer::Load(Snapshot &snapshot)
+{
+    Clear();
+
+    centre_x_ = snapshot.Get<int>();
+    centre_y_ = snapshot.Get<int>();
+    int count = snapshot.Get<int>();
+
+    std::vector<unsigned char> bytes;
+    for (int i = 0; i < count; i++) {
+        Chunk &chunk = chunks_[snapshot.Get<long long>()];
+        for (int k = 0; k < NUM_KINDS; k++) {
+            int objects = snapshot.Get<int>();
+            if (objects < 0 || objects > (snapshot.GetSize() - snapshot.GetPosition()) / sizeof(long long)) {
+                throw(std::ios_base::failure(std::string("Snapshot is cut short")));
+            }
+            chunk.starts[k].resize(objects);
+            snapshot.GetArray(chunk.starts[k].data(), objects);
+            sleeping_[k] += objects;
+
+            long long size = snapshot.Get<long long>();
+            if (size < 0 || size > snapshot.GetSize() - snapshot.GetPosition()) {
+                throw(std::ios_base::failure(std::string("Snapshot is cut short")));
+            }
+
+            // every object has to start inside the record, in the order they went to sleep
+            for (int n = 0; n < objects; n++) {
+                if (chunk.starts[k][n] < (n ? chunk.starts[k][n - 1] : 0) || chunk.starts[k][n] >= size) {
+                    throw(std::ios_base::failure(std::string("Snapshot has a chunk that doesnt add up")));
+                }
+            }
+            bytes.resize(size);
+            snapshot.GetArray(bytes.data(), size);
+            chunk.records[k].PutArray(bytes.data(), size);
+        }
+    }
+}
+
+} // namespace game
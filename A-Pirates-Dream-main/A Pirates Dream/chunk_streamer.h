@@ -0,0 +1,104 @@
+#ifndef CHUNK_STREAMER_H_
+#define CHUNK_STREAMER_H_
+
+#include <cmath>
+#include <cstdlib>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "snapshot.h"
+
+namespace game {
+
+    /*
+        ChunkStreamer cuts the sea into square chunks, keyed by their grid coordinates, and keeps only the ones
+        near the player awake. An object that ends up in a chunk outside that window goes to sleep: the game
+        saves it into the chunk's record (the same bytes a snapshot holds for it) and hands the object back to
+        its pool. Once the player comes close enough that the chunk is in the window again, Wake() gives the
+        record back and the game rebuilds the objects from it.
+
+        Only chunks with something asleep in them exist, so an empty sea costs nothing however big it is, and
+        the awake objects (so the per tick work) only ever come from the few chunks round the player.
+    */
+    class ChunkStreamer {
+
+        public:
+            // What goes to sleep, each kind keeps its own record in a chunk since they wake into different pools
+            enum Kind { ENEMY, COLLECTIBLE, NUM_KINDS };
+
+            // Chunks chunk_size wide, the ones up to radius chunks from the player's stay awake
+            ChunkStreamer(float chunk_size = 16.0f, int radius = 2);
+
+            // Change the chunk size and radius, throws on a size that isnt positive or a negative radius
+            void Configure(float chunk_size, int radius);
+
+            // Whether anything ever goes to sleep, the game can turn it off
+            inline bool IsEnabled(void) const { return enabled_; }
+            inline void SetEnabled(bool enabled) { enabled_ = enabled; }
+
+            inline float GetChunkSize(void) const { return chunk_size_; }
+            inline int GetRadius(void) const { return radius_; }
+
+            // Keep the chunks round the one position is in awake from now on
+            void Recentre(const glm::vec3 &position);
+
+            // Whether a position is in an awake chunk
+            inline bool IsActive(const glm::vec3 &position) const
+            {
+                int x = static_cast<int>(floorf(position.x / chunk_size_));
+                int y = static_cast<int>(floorf(position.y / chunk_size_));
+                return abs(x - centre_x_) <= radius_ && abs(y - centre_y_) <= radius_;
+            }
+
+            // Put one object of kind to sleep in the chunk position is in: write it to the record this returns
+            Snapshot &Sleep(Kind kind, const glm::vec3 &position);
+
+            // Take up to room objects of kind from the first awake chunk (in a fixed order) with any asleep, returns
+            // how many objects records holds (0 when there's nothing to wake or no room)
+            // records is read from the start in the order the objects went to sleep, the chunk forgets them and keeps
+            // any that didnt fit for a later call
+            int Wake(Kind kind, int room, Snapshot &records);
+
+            // Forget everything asleep
+            void Clear(void);
+
+            // Objects of kind asleep, the chunks holding them and the bytes their records take
+            inline int GetSleeping(Kind kind) const { return sleeping_[kind]; }
+            inline int GetChunkCount(void) const { return chunks_.size(); }
+            size_t GetBytes(void) const;
+
+            // Print the sleeping counts on one line
+            void Print(std::ostream &out) const;
+
+            // Save and restore everything asleep (in chunk order, so the same world always saves the same bytes)
+            void Save(Snapshot &snapshot) const;
+            void Load(Snapshot &snapshot);
+
+        private:
+            // the records of one chunk, and where each object's bytes start in them (so as many as fit can wake)
+            struct Chunk {
+                Snapshot records[NUM_KINDS];
+                std::vector<long long> starts[NUM_KINDS];
+            };
+
+            // both grid coordinates in one key
+            static inline long long Key(int x, int y) { return static_cast<long long>((static_cast<unsigned long long>(static_cast<unsigned int>(x)) << 32) | static_cast<unsigned int>(y)); }
+
+            std::unordered_map<long long, Chunk> chunks_;
+            int sleeping_[NUM_KINDS];
+
+            float chunk_size_;
+            int radius_;
+            bool enabled_;
+
+            // the chunk the awake window is centred on
+            int centre_x_;
+            int centre_y_;
+
+    }; // class ChunkStreamer
+
+} // namespace game
+
+#endif // CHUNK_STREAMER_H_
@@ -1,4 +1,6 @@
 #include "collectible_game_object.h"
+#include "fast_math.h"
+#include "snapshot.h"
 
 namespace game {
 
@@ -13,7 +15,7 @@ CollectibleGameObject::CollectibleGameObject(const glm::vec3 &position, Geometry
 	: GameObject(position, geom, shader, texture) 
 	{
 		type_ = type;
-		start_pos_ = position_;
+		start_pos_ = position;
 	}
 
 // Update function for moving the Collectible object around
@@ -21,10 +23,27 @@ void CollectibleGameObject::Update(double delta_time) {
 
 	// Special Collectible updates go here
 
-	position_.y = start_pos_.y + 0.1 * sin(3  * time_);
+	// bob up and down, the phase is wrapped in double since time_ keeps growing
+	float s, c;
+	FastSinCos(static_cast<float>(WrapPeriod(3 * time_, 2.0 * glm::pi<double>())), s, c);
+	PositionY() = start_pos_.y + 0.1f * s;
 
 	// Call the parent's update method to move the object in standard way, if desired
 	GameObject::Update(delta_time);
 }
 
+void CollectibleGameObject::Save(Snapshot &snapshot) const
+{
+	GameObject::Save(snapshot);
+	snapshot.Put(type_);
+	snapshot.PutArray(&start_pos_.x, 3);
+}
+
+void CollectibleGameObject::Load(Snapshot &snapshot)
+{
+	GameObject::Load(snapshot);
+	type_ = snapshot.Get<int>();
+	snapshot.GetArray(&start_pos_.x, 3);
+}
+
 } // namespace game
@@ -16,6 +16,10 @@ namespace game {
 
             inline int GetType(void) const { return type_; }
 
+            // Save and load the type and where it bobs around along with the rest of the object
+            void Save(Snapshot &snapshot) const override;
+            void Load(Snapshot &snapshot) override;
+
         private:
             int type_;
             glm::vec3 start_pos_;
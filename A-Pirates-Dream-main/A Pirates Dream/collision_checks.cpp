@@ -0,0 +1,52 @@
+#include <algorithm>
+
+#include "collision_checks.h"
+
+namespace game {
+
+// Squared radius of the circle a bullet has to be inside of to hit an enemy
+const float enemy_hit_radius_sq_g = 0.1f;
+
+// How close an enemy's centre has to be to a bullet's path to be worth a swept test, a bit more than the sqrt(0.1) radius the test uses
+const float bullet_hit_radius_g = 0.32f;
+
+// How close an enemy has to get to a spike to run into it
+const float spike_hit_radius_g = 0.8f;
+
+
+int FindBulletHit(const glm::vec3 &position, const glm::vec3 &step, const SpatialGrid &enemy_grid,
+                  const EntityMap<EnemyGameObject> &enemies, CollisionScratch &scratch)
+{
+    // the swept test below needs both ends of this step inside an enemy's circle, so only enemies near the step are worth solving for
+    scratch.nearby.clear();
+    enemy_grid.QuerySegment(position, position + step, bullet_hit_radius_g, scratch.nearby);
+    std::sort(scratch.nearby.begin(), scratch.nearby.end());
+
+    // pack the candidates so the kernel can test them several at a time
+    // nearby gets squeezed down as we go so nearby[k] is the enemy in slot k of the batch
+    scratch.targets.Clear();
+    for (int n = 0; n < scratch.nearby.size(); n++)
+    {
+        scratch.nearby[scratch.targets.Add(enemies[scratch.nearby[n]]->GetPosition(), enemy_hit_radius_sq_g)] = scratch.nearby[n];
+    }
+
+    int target = SweepCircles(position, step, scratch.targets, scratch.hits, scratch.impacts);
+    return (target >= 0) ? scratch.nearby[target] : -1;
+}
+
+
+int FindSpikeHit(const glm::vec3 &position, const SpatialGrid &enemy_grid, CollisionScratch &scratch)
+{
+    scratch.nearby.clear();
+    enemy_grid.QueryRadius(position, spike_hit_radius_g, scratch.nearby);
+
+    // the lowest index wins so the result doesnt depend on how the grid happened to bucket them
+    int j = -1;
+    for (int n = 0; n < scratch.nearby.size(); n++)
+    {
+        if (j < 0 || scratch.nearby[n] < j) j = scratch.nearby[n];
+    }
+    return j;
+}
+
+} // namespace game
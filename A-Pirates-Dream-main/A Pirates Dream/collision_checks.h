@@ -0,0 +1,35 @@
+#ifndef COLLISION_CHECKS_H_
+#define COLLISION_CHECKS_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "enemy_game_object.h"
+#include "entity_map.h"
+#include "spatial_grid.h"
+#include "swept_circle.h"
+
+namespace game {
+
+    // Scratch space for a collision check, kept around so it doesnt reallocate every tick
+    struct CollisionScratch {
+        // grid query results
+        std::vector<int> nearby;
+
+        // enemies near the bullet being tested, packed for SweepCircles, and what it found
+        CircleBatch targets;
+        std::vector<unsigned char> hits;
+        std::vector<float> impacts;
+    };
+
+    // The enemy a bullet moving from position by step hits first, as its index in enemies (which enemy_grid was built
+    // from), or -1 if it doesnt hit any. Only reads, so any number of threads can run it with their own scratch
+    int FindBulletHit(const glm::vec3 &position, const glm::vec3 &step, const SpatialGrid &enemy_grid,
+                      const EntityMap<EnemyGameObject> &enemies, CollisionScratch &scratch);
+
+    // The enemy a spike at position runs into, the lowest index if it reaches more than one, or -1 for none
+    int FindSpikeHit(const glm::vec3 &position, const SpatialGrid &enemy_grid, CollisionScratch &scratch);
+
+} // namespace game
+
+#endif // COLLISION_CHECKS_H_
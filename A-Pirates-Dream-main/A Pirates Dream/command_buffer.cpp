@@ -0,0 +1,126 @@
+#include <algorithm>
+
+#include "command_buffer.h"
+
+namespace game {
+
+namespace {
+
+    Command MakeCommand(Command::Type type, Command::Target target, int index, int amount, int flags, const glm::vec3 &position)
+    {
+        Command command;
+        command.type = type;
+        command.target = target;
+        command.index = index;
+        command.amount = amount;
+        command.flags = flags;
+        command.position = position;
+        return command;
+    }
+
+} // namespace
+
+
+Command Command::Kill(Target target, int index)
+{
+    return MakeCommand(KILL, target, index, 0, 0, glm::vec3(0.0f));
+}
+
+
+Command Command::Damage(Target target, int index, int amount, int flags)
+{
+    return MakeCommand(DAMAGE, target, index, amount, flags, glm::vec3(0.0f));
+}
+
+
+Command Command::Collect(int index)
+{
+    return MakeCommand(COLLECT, COLLECTIBLE, index, 0, 0, glm::vec3(0.0f));
+}
+
+
+Command Command::SpawnDrop(const glm::vec3 &position)
+{
+    return MakeCommand(SPAWN_DROP, NONE, -1, 0, 0, position);
+}
+
+
+Command Command::SpawnEffect(const glm::vec3 &position)
+{
+    return MakeCommand(SPAWN_EFFECT, NONE, -1, 0, 0, position);
+}
+
+
+Command Command::PlaySound(int sound)
+{
+    return MakeCommand(PLAY_SOUND, NONE, -1, sound, 0, glm::vec3(0.0f));
+}
+
+
+Command Command::AddScore(int points)
+{
+    return MakeCommand(ADD_SCORE, NONE, -1, points, 0, glm::vec3(0.0f));
+}
+
+
+CommandBuffer::CommandBuffer(int threads)
+{
+    SetThreadCount(threads);
+}
+
+
+void CommandBuffer::SetThreadCount(int threads)
+{
+    if (threads < 1) threads = 1;
+    buffers_.resize(threads);
+    Clear();
+}
+
+
+void CommandBuffer::Emit(int thread, unsigned int order, const Command &command)
+{
+    ThreadBuffer &buffer = buffers_[thread];
+
+    buffer.sequence = (order == buffer.last_order) ? buffer.sequence + 1 : 0;
+    buffer.last_order = order;
+
+    Entry entry = { order, buffer.sequence, command };
+    buffer.entries.push_back(entry);
+}
+
+
+const std::vector<Command> &CommandBuffer::Merge(void)
+{
+    sorted_.clear();
+    for (int t = 0; t < buffers_.size(); t++) {
+        sorted_.insert(sorted_.end(), buffers_[t].entries.begin(), buffers_[t].entries.end());
+    }
+
+    // (order, sequence) pairs are unique, so a plain sort is already stable and doesnt need a temporary buffer
+    std::sort(sorted_.begin(), sorted_.end(), Before);
+
+    merged_.clear();
+    for (int i = 0; i < sorted_.size(); i++) {
+        merged_.push_back(sorted_[i].command);
+    }
+    return merged_;
+}
+
+
+void CommandBuffer::Clear(void)
+{
+    for (int t = 0; t < buffers_.size(); t++) {
+        buffers_[t].entries.clear();
+        buffers_[t].last_order = ~0u;
+        buffers_[t].sequence = 0;
+    }
+}
+
+
+bool CommandBuffer::Before(const Entry &a, const Entry &b)
+{
+    if (a.order != b.order) return a.order < b.order;
+    return a.sequence < b.sequence;
+}
+
+} // namespace game
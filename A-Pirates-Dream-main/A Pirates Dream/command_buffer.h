@@ -0,0 +1,112 @@
+#ifndef COMMAND_BUFFER_H_
+#define COMMAND_BUFFER_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace game {
+
+    // Something a collision pass wants done to the game, the game carries it out once the passes are over
+    struct Command {
+
+        enum Type { KILL, DAMAGE, COLLECT, SPAWN_DROP, SPAWN_EFFECT, PLAY_SOUND, ADD_SCORE };
+
+        // what kind of object index refers to
+        enum Target { NONE, PLAYER, ENEMY, COLLECTIBLE, BULLET, SPIKE };
+
+        // extra bits for DAMAGE, CONTACT is the player running into an enemy: the enemy gets a cooldown before it
+        // can hurt the player again if it survives, and a crunch sound if it doesnt
+        enum Flags { CONTACT = 1 };
+
+        Type type;
+        Target target;
+
+        // position of the target in its entity map, maps dont shift until the end of the tick so this stays good
+        int index;
+
+        // damage dealt, points scored or sound played, depending on the type
+        int amount;
+        int flags;
+
+        // where drops and effects appear
+        glm::vec3 position;
+
+        // Destroy an object outright
+        static Command Kill(Target target, int index);
+
+        // Take amount health off an enemy (killing it if that was its last) or the player
+        static Command Damage(Target target, int index, int amount, int flags = 0);
+
+        // The player picked up a collectible
+        static Command Collect(int index);
+
+        // Roll for a collectible dropping at position
+        static Command SpawnDrop(const glm::vec3 &position);
+
+        // Leave an explosion at position
+        static Command SpawnEffect(const glm::vec3 &position);
+
+        static Command PlaySound(int sound);
+        static Command AddScore(int points);
+
+    }; // struct Command
+
+
+    /*
+        CommandBuffer collects the Commands emitted while a tick's collision passes run, so the passes only read
+        the game and can be split across threads. Each thread writes to its own list, and Merge() puts every
+        command in one order before they are applied: by the order key given to Emit() (which pass, which
+        object), then by emission order for the same key. As long as each key is only emitted from one thread
+        at a time, which holds when the key is the object a ParallelFor chunk is working on, the merged list
+        comes out the same however the work was split up.
+    */
+    class CommandBuffer {
+
+        public:
+            CommandBuffer(int threads = 1);
+
+            // One list per thread that can Emit(), threads are numbered from 0
+            void SetThreadCount(int threads);
+            inline int GetThreadCount(void) const { return buffers_.size(); }
+
+            // Order key for the commands about the source'th object of a pass, earlier passes apply first
+            static inline unsigned int Order(int pass, int source) { return (static_cast<unsigned int>(pass) << 24) | static_cast<unsigned int>(source); }
+
+            // Queue a command from the given thread
+            void Emit(int thread, unsigned int order, const Command &command);
+
+            // Every thread's commands in apply order, valid until the next Emit() or Clear()
+            const std::vector<Command> &Merge(void);
+
+            // Forget every command (keeps the memory for next tick)
+            void Clear(void);
+
+        private:
+            struct Entry {
+                unsigned int order;
+                int sequence;
+                Command command;
+            };
+
+            struct ThreadBuffer {
+                std::vector<Entry> entries;
+                // key of the last command and how many have used it, so repeats keep their emission order
+                unsigned int last_order;
+                int sequence;
+                // keep each thread's bookkeeping on its own cache line
+                char padding[64];
+            };
+
+            static bool Before(const Entry &a, const Entry &b);
+
+            std::vector<ThreadBuffer> buffers_;
+
+            // scratch for Merge()
+            std::vector<Entry> sorted_;
+            std::vector<Command> merged_;
+
+    }; // class CommandBuffer
+
+} // namespace game
+
+#endif // COMMAND_BUFFER_H_
@@ -1,7 +1,17 @@
+#include <cmath>
+
 #include "enemy_game_object.h"
+#include "fast_math.h"
+#include "snapshot.h"
 
 namespace game {
 
+// spawn points are random, so the patrol centre's position to a sixteenth of a unit is as good as a random slot
+static int LodSlot(const glm::vec3 &centre)
+{
+	return static_cast<int>(floorf(centre.x * 16.0f)) * 3 + static_cast<int>(floorf(centre.y * 16.0f));
+}
+
 /*
 	EnemyGameObject inherits from GameObject
 	It overrides GameObject's update method, so that you can check for input to change the velocity of the Enemy
@@ -16,41 +26,49 @@ EnemyGameObject::EnemyGameObject(const glm::vec3 &position, Geometry *geom, Shad
 		state_ = state;
 		
 		health_ = health;
-		hit_timer_ = new Timer();
+
+		// nowhere to head for until SetTarget, set anyway so snapshots of new enemies always match
+		target_ = position;
+
+		skipped_ticks_ = 0;
 	
-		if (state) timer_->Start(1);
+		if (state) timer_.Start(1);
 
-		//centre_point_ = glm::vec3(position_.x, 0.0f, 0.0f);
+		//centre_point_ = glm::vec3(position.x, 0.0f, 0.0f);
 
 		// were gonna set the center point towards the center from wherever the enemy spawns
 
-		if (position_.x > 0 && position_.y > 0)
+		if (position.x > 0 && position.y > 0)
 		{
-			centre_point_ = glm::vec3(position_.x - .5f, position_.y - .5f, 0.0f);
+			centre_point_ = glm::vec3(position.x - .5f, position.y - .5f, 0.0f);
 		}
-		else if (position_.x <= 0 && position_.y > 0)
+		else if (position.x <= 0 && position.y > 0)
 		{
-			centre_point_ = glm::vec3(position_.x + .5f, position_.y - .5f, 0.0f);
+			centre_point_ = glm::vec3(position.x + .5f, position.y - .5f, 0.0f);
 		}
-		else if (position_.x > 0 && position_.y <= 0)
+		else if (position.x > 0 && position.y <= 0)
 		{
-			centre_point_ = glm::vec3(position_.x - .5f, position_.y + .5f, 0.0f);
+			centre_point_ = glm::vec3(position.x - .5f, position.y + .5f, 0.0f);
 		}
 		else
 		{
-			centre_point_ = glm::vec3(position_.x + .5f, position_.y + .5f, 0.0f);
+			centre_point_ = glm::vec3(position.x + .5f, position.y + .5f, 0.0f);
 		}
-		
+
+		lod_slot_ = LodSlot(centre_point_);
 	}
 
 EnemyGameObject::~EnemyGameObject()
 {
-	delete hit_timer_;
 }
 
 // Update function for moving the Enemy object around
 void EnemyGameObject::Update(double delta_time) {
 
+	// delta_time is one tick, and we catch up on any ticks we got left out of (see SkipTick) as well
+	int ticks = skipped_ticks_ + 1;
+	skipped_ticks_ = 0;
+
 	// first well decide what we wanna do by checking the state
 
 	if (state_ == PATROLLING)
@@ -60,42 +78,49 @@ void EnemyGameObject::Update(double delta_time) {
 			dist not working properly
 		*/
 
-		// every approx 2 miliseconds were gonna update
-		if (static_cast<int>( time_ * 30 ) < static_cast<int>( (time_ + delta_time) * 30 ) ) 
+		// we move every tick now that the tick length is fixed, at the same 30 degrees a second the old 1/30th second steps gave us
+		//std::cout << "time = " << static_cast<int>(time_ + delta_time) << std::endl;
+
+		// where we are on the circle only depends on the time, so the ticks we missed just move the clock on (a tick
+		// at a time, so it adds up to the same time updating every tick would have), and we put ourselves where the
+		// tick before this one would have left us so the heading comes out the same too
+		if (ticks > 1)
 		{
-			//std::cout << "time = " << static_cast<int>(time_ + delta_time) << std::endl;
-
-			// were gonna get the radians as a partial roation over a certain amount of time
-			float radians = static_cast<float>( static_cast<int>( (time_ + delta_time) * 30 ) % 360 ) * glm::pi<float>() / 180.0f;
-			
-			//float dist = sqrt( pow( position_.x + centre_point_.x, 2 ) + pow( position_.y + centre_point_.y, 2 ) );
-
-			// were gonna use those radians to get the new x and y values
-			float new_x = ( 1.0f * static_cast<float> ( cos( radians ) ) ) + centre_point_.x;
-			float new_y = ( 1.0f * static_cast<float> ( sin( radians ) ) ) + centre_point_.y;
-			
-			// were gonna make the angle the direction were moving
-			angle_ = static_cast<float>(atan2(new_y - position_.y, new_x - position_.x));
-			
-			// finally were gonna set the positions to the entity
-			position_.x = new_x;
-			position_.y = new_y;
+			for (int t = 1; t < ticks; t++) GameObject::Update(delta_time);
+			PatrolPosition(time_, PositionX(), PositionY());
 		}
+
+		//float dist = sqrt( pow( position_.x + centre_point_.x, 2 ) + pow( position_.y + centre_point_.y, 2 ) );
+
+		// were gonna get the new x and y values a partial rotation round the centre over a certain amount of time
+		float new_x, new_y;
+		PatrolPosition(time_ + delta_time, new_x, new_y);
+		
+		// were gonna make the angle the direction were moving
+		Angle() = FastAtan2(new_y - PositionY(), new_x - PositionX());
+		
+		// finally were gonna set the positions to the entity
+		PositionX() = new_x;
+		PositionY() = new_y;
 	}
 	else if (state_ == INTERCEPTING)
 	{
 		// moving from a to b over t seconds
 		// xn, yn = yn-1 + h * f ( xn-1, yn-1)
 
-		// check if a 30th of a second has passed
-		if (static_cast<int>( time_ * 30 ) < static_cast<int>( (time_ + delta_time) * 30 ) ) 
+		// step every tick, covering the same velocity / 60 per 30th of a second we used to
+		// (the game keeps intercepting enemies at full rate, but a missed tick would be the same step again)
+		for (int t = 1; t < ticks; t++)
 		{
-			position_.x += (velocity_.x / 60);
-			position_.y += (velocity_.y / 60);
+			PositionX() += VelocityX() * 0.5f * static_cast<float>(delta_time);
+			PositionY() += VelocityY() * 0.5f * static_cast<float>(delta_time);
+			GameObject::Update(delta_time);
+		}
+		PositionX() += VelocityX() * 0.5f * static_cast<float>(delta_time);
+		PositionY() += VelocityY() * 0.5f * static_cast<float>(delta_time);
 
-			angle_ = static_cast<float>(atan2(velocity_.y, velocity_.x));
+		Angle() = FastAtan2(VelocityY(), VelocityX());
 
-		}
 	}
 
 	
@@ -104,16 +129,62 @@ void EnemyGameObject::Update(double delta_time) {
 	GameObject::Update(delta_time);
 }
 
-void EnemyGameObject::SetTarget(glm::vec3 &position)
+void EnemyGameObject::PatrolPosition(double time, float &x, float &y) const
+{
+	// were gonna get the radians as a partial roation over a certain amount of time
+	float radians = static_cast<float>( WrapPeriod( time * 30.0, 360.0 ) ) * glm::pi<float>() / 180.0f;
+
+	// were gonna use those radians to get the x and y values
+	float s, c;
+	FastSinCos(radians, s, c);
+	x = c + centre_point_.x;
+	y = s + centre_point_.y;
+}
+
+void EnemyGameObject::SetTarget(const glm::vec3 &position)
 {
 	// every 2 seconds were gonna set the target to the position being passed in, with the starting position being where the enemy is now
 	if (!state_) state_ = INTERCEPTING;
 	target_ = position;
-	velocity_ = glm::vec3(target_.x - position_.x, target_.y - position_.y, 0.0f);
-	timer_->Start(2.0f);
+	VelocityX() = target_.x - PositionX();
+	VelocityY() = target_.y - PositionY();
+	timer_.Start(2.0f);
 	//std::cout << "here" << std::endl;
 }
 
+void EnemyGameObject::Save(Snapshot &snapshot) const
+{
+	GameObject::Save(snapshot);
+	snapshot.Put(health_);
+	snapshot.Put(state_);
+	hit_timer_.Save(snapshot);
+	snapshot.PutArray(&centre_point_.x, 3);
+	snapshot.PutArray(&target_.x, 3);
+	snapshot.Put(skipped_ticks_);
+}
+
+void EnemyGameObject::Load(Snapshot &snapshot)
+{
+	GameObject::Load(snapshot);
+	health_ = snapshot.Get<int>();
+	state_ = snapshot.Get<int>();
+	hit_timer_.Load(snapshot);
+	snapshot.GetArray(&centre_point_.x, 3);
+	lod_slot_ = LodSlot(centre_point_);
+	snapshot.GetArray(&target_.x, 3);
+	skipped_ticks_ = snapshot.Get<int>();
+}
+
+void EnemyGameObject::Steer(const glm::vec3 &direction)
+{
+	// SetTarget still decides how fast we go, the flow field only picks the way round things to the player
+	// a zero direction means theres no way through, so we just keep going the way we were
+	if (direction.x == 0.0f && direction.y == 0.0f) return;
+	float speed = sqrt(VelocityX() * VelocityX() + VelocityY() * VelocityY());
+	VelocityX() = direction.x * speed;
+	VelocityY() = direction.y * speed;
+}
+
 
 
 } // namespace game
@@ -20,15 +20,32 @@ namespace game {
 
             inline int GetState(void) const { return state_; }
             inline int GetHealth(void) const { return health_; }
-            inline int GetHitTimer(void) const { return hit_timer_->Finished(); }
+            inline int GetHitTimer(void) const { return hit_timer_.Finished(); }
 
             inline void SetIntercepting(void) { state_ = INTERCEPTING; }
-            void SetTarget(glm::vec3 &position);
+            void SetTarget(const glm::vec3 &position);
+
+            // Turn the enemy to head along direction (a unit vector) at the speed SetTarget gave it
+            void Steer(const glm::vec3 &direction);
             inline void Hit(void) { health_-= 1;}
-            inline void SetHitTimer(float t = 3.0f) { hit_timer_->Start(t); }
+            inline void SetHitTimer(float t = 3.0f) { hit_timer_.Start(t); }
+
+            // Leave the enemy out of this tick, its next Update (still given one tick's time) catches up on it
+            inline void SkipTick(void) { skipped_ticks_++; }
+            inline int GetSkippedTicks(void) const { return skipped_ticks_; }
+
+            // Which of its LOD tier's ticks the enemy updates on, taken from its patrol centre so it never changes
+            // (not even through a snapshot) and enemies spawned together still spread out
+            inline int GetLodSlot(void) const { return lod_slot_; }
+
+            // Save and load the health, state, hit timer, patrol centre, target and skipped ticks along with the rest of the object
+            void Save(Snapshot &snapshot) const override;
+            void Load(Snapshot &snapshot) override;
 
 
         private:
+            // Where patrolling puts the enemy at time
+            void PatrolPosition(double time, float &x, float &y) const;
 
             // how much health the enemy has
             int health_;
@@ -36,7 +53,8 @@ namespace game {
             // the enemies state, 0 is patrolling, 1 is  intercepting
             int state_;
 
-            Timer* hit_timer_;
+            // how long until the enemy can hurt the player again, mutable for the same reason as timer_
+            mutable Timer hit_timer_;
 
             // the point around which were gonna rotate the enemy
             glm::vec3 centre_point_;
@@ -50,6 +68,12 @@ namespace game {
             // the target where which we wanna move
             glm::vec3 target_;
 
+            // ticks left out since the last update, for far away enemies that dont update every tick
+            int skipped_ticks_;
+
+            // worked out from centre_point_, see GetLodSlot
+            int lod_slot_;
+
 
 
     }; // class EnemyGameObject
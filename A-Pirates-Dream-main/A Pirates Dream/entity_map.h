@@ -0,0 +1,197 @@
+#ifndef ENTITY_MAP_H_
+#define ENTITY_MAP_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "object_pool.h"
+
+namespace game {
+
+    class GameObject;
+
+    // Lightweight reference to an object in an EntityMap, the generation catches use after the object is gone
+    struct EntityHandle {
+        int index;
+        unsigned int generation;
+
+        EntityHandle(void) : index(-1), generation(0) {}
+        EntityHandle(int i, unsigned int g) : index(i), generation(g) {}
+
+        inline bool operator==(const EntityHandle &other) const { return index == other.index && generation == other.generation; }
+        inline bool operator!=(const EntityHandle &other) const { return !(*this == other); }
+    };
+
+    // Anything that can turn a handle back into an object, so objects can point at a parent without knowing which map it lives in
+    class EntityTable {
+
+        public:
+            virtual ~EntityTable() {}
+
+            // The object the handle refers to, NULL once it has been destroyed
+            virtual GameObject *Lookup(EntityHandle handle) const = 0;
+
+    }; // class EntityTable
+
+    /*
+        EntityMap owns a set of game objects and hands out generational handles to them.
+        Objects are kept densely packed so iterating is a plain loop over 0 .. GetSize() - 1, and removal swaps the
+        last object into the hole so it costs the same no matter where the object is.
+
+        Destroy() only marks an object, it stays alive (and keeps its index) until Flush() at the end of the tick,
+        so loops can destroy things without their indices shifting underneath them. Check IsDestroyed(i) to skip
+        objects that were destroyed earlier in the same tick.
+
+        Objects are deleted when flushed, unless the map was given an ObjectPool with SetPool(), then they are
+        released back to it (and everything added to the map has to come from that pool).
+    */
+    template <class T>
+    class EntityMap : public EntityTable {
+
+        public:
+            EntityMap(void) { free_head_ = -1; pool_ = NULL; }
+            ~EntityMap() { Clear(); }
+
+            // Hand flushed objects back to pool instead of deleting them
+            inline void SetPool(ObjectPool<T> *pool) { pool_ = pool; }
+
+            // Take ownership of an object, returns the handle to find it again
+            EntityHandle Add(T *object)
+            {
+                if (free_head_ == -1) {
+                    Slot slot;
+                    slot.generation = 0;
+                    slot.next = -1;
+                    slots_.push_back(slot);
+                    free_head_ = slots_.size() - 1;
+                }
+
+                int index = free_head_;
+                Slot &slot = slots_[index];
+                free_head_ = slot.next;
+
+                slot.dense = objects_.size();
+                slot.next = -1;
+
+                objects_.push_back(object);
+                owners_.push_back(index);
+                destroyed_.push_back(false);
+
+                return EntityHandle(index, slot.generation);
+            }
+
+            // The object a handle refers to, NULL for handles whose object has been flushed
+            T *Get(EntityHandle handle) const
+            {
+                const Slot *slot = Find(handle);
+                return slot ? objects_[slot->dense] : NULL;
+            }
+
+            GameObject *Lookup(EntityHandle handle) const override { return Get(handle); }
+
+            // Mark an object to be deleted at the next Flush(), does nothing for stale handles or objects already marked
+            void Destroy(EntityHandle handle)
+            {
+                const Slot *slot = Find(handle);
+                if (slot) DestroyAt(slot->dense);
+            }
+
+            // Same as above, by position in the dense array
+            void DestroyAt(int i)
+            {
+                if (destroyed_[i]) return;
+                destroyed_[i] = true;
+                doomed_.push_back(owners_[i]);
+            }
+
+            // Delete every object marked by Destroy(), moving the last object into each hole
+            void Flush(void)
+            {
+                for (int n = 0; n < doomed_.size(); n++) {
+                    int index = doomed_[n];
+                    int i = slots_[index].dense;
+
+                    if (pool_) pool_->Release(objects_[i]);
+                    else delete objects_[i];
+
+                    int last = objects_.size() - 1;
+                    objects_[i] = objects_[last];
+                    owners_[i] = owners_[last];
+                    destroyed_[i] = destroyed_[last];
+                    slots_[owners_[i]].dense = i;
+
+                    objects_.pop_back();
+                    owners_.pop_back();
+                    destroyed_.pop_back();
+
+                    // bump the generation so old handles to this slot stop working
+                    slots_[index].generation++;
+                    slots_[index].dense = -1;
+                    slots_[index].next = free_head_;
+                    free_head_ = index;
+                }
+                doomed_.clear();
+            }
+
+            // Delete every object right away
+            void Clear(void)
+            {
+                for (int i = 0; i < objects_.size(); i++) {
+                    DestroyAt(i);
+                }
+                Flush();
+            }
+
+            // Dense access for iterating
+            inline int GetSize(void) const { return objects_.size(); }
+            inline T *operator[](int i) const { return objects_[i]; }
+            inline EntityHandle GetHandle(int i) const { return EntityHandle(owners_[i], slots_[owners_[i]].generation); }
+            inline bool IsDestroyed(int i) const { return destroyed_[i]; }
+
+            // Where the object a handle refers to sits in the dense array, -1 for stale handles
+            inline int IndexOf(EntityHandle handle) const
+            {
+                const Slot *slot = Find(handle);
+                return slot ? slot->dense : -1;
+            }
+
+        private:
+            struct Slot {
+                // where the object sits in objects_, -1 when the slot is free
+                int dense;
+                unsigned int generation;
+                // next free slot, -1 terminated
+                int next;
+            };
+
+            const Slot *Find(EntityHandle handle) const
+            {
+                if (handle.index < 0 || handle.index >= slots_.size()) return NULL;
+                const Slot &slot = slots_[handle.index];
+                return (slot.generation == handle.generation && slot.dense != -1) ? &slot : NULL;
+            }
+
+            // the objects, packed, and which slot each one belongs to
+            std::vector<T*> objects_;
+            std::vector<int> owners_;
+            std::vector<bool> destroyed_;
+
+            // handle slots and the head of the free slot list
+            std::vector<Slot> slots_;
+            int free_head_;
+
+            // slots waiting for Flush()
+            std::vector<int> doomed_;
+
+            // where objects go when flushed, NULL to delete them
+            ObjectPool<T> *pool_;
+
+            // the map owns its objects, so it cant be copied
+            EntityMap(const EntityMap &);
+            EntityMap &operator=(const EntityMap &);
+
+    }; // class EntityMap
+
+} // namespace game
+
+#endif // ENTITY_MAP_H_
@@ -0,0 +1,191 @@
+#include "fast_math.h"
+
+#if defined(__AVX2__)
+#define APD_FAST_MATH_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define APD_FAST_MATH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace game {
+
+void SinCosBatch(const float *angle, float *s, float *c, int count)
+{
+    int i = 0;
+
+#if defined(APD_FAST_MATH_AVX2)
+    {
+        const __m256 two_over_pi = _mm256_set1_ps(0.63661977236758134308f);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 pio2_1 = _mm256_set1_ps(1.5703125f);
+        const __m256 pio2_2 = _mm256_set1_ps(4.837512969970703125e-4f);
+        const __m256 pio2_3 = _mm256_set1_ps(7.54978995489188216e-8f);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256i one_i = _mm256_set1_epi32(1);
+        const __m256i two_i = _mm256_set1_epi32(2);
+
+        for (; i + 8 <= count; i += 8) {
+            __m256 x = _mm256_loadu_ps(angle + i);
+
+            __m256 q = _mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(x, two_over_pi), half));
+            __m256i quadrant = _mm256_cvtps_epi32(q);
+            __m256 r = _mm256_sub_ps(_mm256_sub_ps(_mm256_sub_ps(x, _mm256_mul_ps(q, pio2_1)), _mm256_mul_ps(q, pio2_2)), _mm256_mul_ps(q, pio2_3));
+
+            __m256 z = _mm256_mul_ps(r, r);
+            __m256 sp = _mm256_add_ps(_mm256_set1_ps(8.3321608736e-3f), _mm256_mul_ps(z, _mm256_set1_ps(-1.9515295891e-4f)));
+            sp = _mm256_add_ps(_mm256_set1_ps(-1.6666654611e-1f), _mm256_mul_ps(z, sp));
+            __m256 sr = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, z), sp));
+            __m256 cp = _mm256_add_ps(_mm256_set1_ps(-1.388731625493765e-3f), _mm256_mul_ps(z, _mm256_set1_ps(2.443315711809948e-5f)));
+            cp = _mm256_add_ps(_mm256_set1_ps(4.166664568298827e-2f), _mm256_mul_ps(z, cp));
+            __m256 cr = _mm256_add_ps(_mm256_sub_ps(one, _mm256_mul_ps(half, z)), _mm256_mul_ps(_mm256_mul_ps(z, z), cp));
+
+            // odd quadrants swap sin and cos, then the signs come from bit 1 of the quadrant (and of quadrant + 1 for cos)
+            __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, one_i), one_i));
+            __m256 sin_value = _mm256_blendv_ps(sr, cr, swap);
+            __m256 cos_value = _mm256_blendv_ps(cr, sr, swap);
+            __m256 sin_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, two_i), 30));
+            __m256 cos_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, one_i), two_i), 30));
+
+            _mm256_storeu_ps(s + i, _mm256_xor_ps(sin_value, sin_sign));
+            _mm256_storeu_ps(c + i, _mm256_xor_ps(cos_value, cos_sign));
+        }
+    }
+#elif defined(APD_FAST_MATH_SSE2)
+    {
+        const __m128 two_over_pi = _mm_set1_ps(0.63661977236758134308f);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 pio2_1 = _mm_set1_ps(1.5703125f);
+        const __m128 pio2_2 = _mm_set1_ps(4.837512969970703125e-4f);
+        const __m128 pio2_3 = _mm_set1_ps(7.54978995489188216e-8f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128i one_i = _mm_set1_epi32(1);
+        const __m128i two_i = _mm_set1_epi32(2);
+
+        for (; i + 4 <= count; i += 4) {
+            __m128 x = _mm_loadu_ps(angle + i);
+
+            // no floor before SSE4.1, so truncate and step down where that went up
+            __m128 turns = _mm_add_ps(_mm_mul_ps(x, two_over_pi), half);
+            __m128i quadrant = _mm_cvttps_epi32(turns);
+            __m128 above = _mm_cmpgt_ps(_mm_cvtepi32_ps(quadrant), turns);
+            quadrant = _mm_add_epi32(quadrant, _mm_castps_si128(above));
+            __m128 q = _mm_cvtepi32_ps(quadrant);
+            __m128 r = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(q, pio2_1)), _mm_mul_ps(q, pio2_2)), _mm_mul_ps(q, pio2_3));
+
+            __m128 z = _mm_mul_ps(r, r);
+            __m128 sp = _mm_add_ps(_mm_set1_ps(8.3321608736e-3f), _mm_mul_ps(z, _mm_set1_ps(-1.9515295891e-4f)));
+            sp = _mm_add_ps(_mm_set1_ps(-1.6666654611e-1f), _mm_mul_ps(z, sp));
+            __m128 sr = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, z), sp));
+            __m128 cp = _mm_add_ps(_mm_set1_ps(-1.388731625493765e-3f), _mm_mul_ps(z, _mm_set1_ps(2.443315711809948e-5f)));
+            cp = _mm_add_ps(_mm_set1_ps(4.166664568298827e-2f), _mm_mul_ps(z, cp));
+            __m128 cr = _mm_add_ps(_mm_sub_ps(one, _mm_mul_ps(half, z)), _mm_mul_ps(_mm_mul_ps(z, z), cp));
+
+            __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one_i), one_i));
+            __m128 sin_value = _mm_or_ps(_mm_and_ps(swap, cr), _mm_andnot_ps(swap, sr));
+            __m128 cos_value = _mm_or_ps(_mm_and_ps(swap, sr), _mm_andnot_ps(swap, cr));
+            __m128 sin_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two_i), 30));
+            __m128 cos_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one_i), two_i), 30));
+
+            _mm_storeu_ps(s + i, _mm_xor_ps(sin_value, sin_sign));
+            _mm_storeu_ps(c + i, _mm_xor_ps(cos_value, cos_sign));
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        FastSinCos(angle[i], s[i], c[i]);
+    }
+}
+
+
+void Atan2Batch(const float *y, const float *x, float *angle, int count)
+{
+    int i = 0;
+
+    // the A&S 4.4.49 coefficients FastAtan2 uses, highest power first
+    const float coefficients[] = { 0.0028662257f, -0.0161657367f, 0.0429096138f, -0.0752896400f, 0.1065626393f, -0.1420889944f, 0.1999355085f, -0.3333314528f, 1.0f };
+
+#if defined(APD_FAST_MATH_AVX2)
+    {
+        const __m256 sign_bit = _mm256_set1_ps(-0.0f);
+        const __m256 tiny = _mm256_set1_ps(1e-30f);
+        const __m256 half_pi = _mm256_set1_ps(1.57079632679489661923f);
+        const __m256 pi = _mm256_set1_ps(3.14159265358979323846f);
+        const __m256 zero = _mm256_setzero_ps();
+
+        for (; i + 8 <= count; i += 8) {
+            __m256 vy = _mm256_loadu_ps(y + i);
+            __m256 vx = _mm256_loadu_ps(x + i);
+            __m256 ax = _mm256_andnot_ps(sign_bit, vx);
+            __m256 ay = _mm256_andnot_ps(sign_bit, vy);
+
+            __m256 y_larger = _mm256_cmp_ps(ay, ax, _CMP_GT_OQ);
+            __m256 larger = _mm256_max_ps(ax, ay);
+            __m256 smaller = _mm256_min_ps(ax, ay);
+            __m256 a = _mm256_div_ps(smaller, _mm256_max_ps(larger, tiny));
+
+            __m256 z = _mm256_mul_ps(a, a);
+            __m256 p = _mm256_set1_ps(coefficients[0]);
+            for (int k = 1; k < 9; k++) {
+                p = _mm256_add_ps(_mm256_set1_ps(coefficients[k]), _mm256_mul_ps(z, p));
+            }
+            __m256 r = _mm256_mul_ps(a, p);
+
+            r = _mm256_blendv_ps(r, _mm256_sub_ps(half_pi, r), y_larger);
+            r = _mm256_blendv_ps(r, _mm256_sub_ps(pi, r), _mm256_cmp_ps(vx, zero, _CMP_LT_OQ));
+            _mm256_storeu_ps(angle + i, _mm256_or_ps(r, _mm256_and_ps(sign_bit, vy)));
+        }
+    }
+#elif defined(APD_FAST_MATH_SSE2)
+    {
+        const __m128 sign_bit = _mm_set1_ps(-0.0f);
+        const __m128 tiny = _mm_set1_ps(1e-30f);
+        const __m128 half_pi = _mm_set1_ps(1.57079632679489661923f);
+        const __m128 pi = _mm_set1_ps(3.14159265358979323846f);
+        const __m128 zero = _mm_setzero_ps();
+
+        for (; i + 4 <= count; i += 4) {
+            __m128 vy = _mm_loadu_ps(y + i);
+            __m128 vx = _mm_loadu_ps(x + i);
+            __m128 ax = _mm_andnot_ps(sign_bit, vx);
+            __m128 ay = _mm_andnot_ps(sign_bit, vy);
+
+            __m128 y_larger = _mm_cmpgt_ps(ay, ax);
+            __m128 larger = _mm_max_ps(ax, ay);
+            __m128 smaller = _mm_min_ps(ax, ay);
+            __m128 a = _mm_div_ps(smaller, _mm_max_ps(larger, tiny));
+
+            __m128 z = _mm_mul_ps(a, a);
+            __m128 p = _mm_set1_ps(coefficients[0]);
+            for (int k = 1; k < 9; k++) {
+                p = _mm_add_ps(_mm_set1_ps(coefficients[k]), _mm_mul_ps(z, p));
+            }
+            __m128 r = _mm_mul_ps(a, p);
+
+            r = _mm_or_ps(_mm_and_ps(y_larger, _mm_sub_ps(half_pi, r)), _mm_andnot_ps(y_larger, r));
+            __m128 x_negative = _mm_cmplt_ps(vx, zero);
+            r = _mm_or_ps(_mm_and_ps(x_negative, _mm_sub_ps(pi, r)), _mm_andnot_ps(x_negative, r));
+            _mm_storeu_ps(angle + i, _mm_or_ps(r, _mm_and_ps(sign_bit, vy)));
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        angle[i] = FastAtan2(y[i], x[i]);
+    }
+}
+
+
+const char *FastMathPath(void)
+{
+#if defined(APD_FAST_MATH_AVX2)
+    return "avx2";
+#elif defined(APD_FAST_MATH_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace game
@@ -0,0 +1,96 @@
+#ifndef FAST_MATH_H_
+#define FAST_MATH_H_
+
+#include <cmath>
+
+namespace game {
+
+    /*
+        Trig for the per object math (bearings, patrols, orbits) without calling into libm.
+        FastSinCos and FastAtan2 are polynomial approximations, inline so the per object updates can use them
+        directly, and SinCosBatch / Atan2Batch do the same math over whole arrays with SSE2 or AVX2 (like
+        SweepCircles, AVX2 when APD_AVX2 is on). The batched and single versions do the same operations in the
+        same order, so they give the same answers.
+
+        Accuracy against libm (checked by apd_fast_math_bench): sin and cos within 2e-7 for angles up to 1e4
+        radians, atan2 within 4e-7 radians, and WrapAngle is only off by the rounding of its float input.
+    */
+
+    // The angle in [0, 2*pi), for angles within a few million radians of 0
+    inline float WrapAngle(float angle)
+    {
+        const float two_pi = 6.28318530717958647692f;
+        float turns = angle * (1.0f / two_pi);
+        int whole = static_cast<int>(turns);
+        if (whole > turns) whole--;
+
+        // 2*pi split in two like pi/2 in FastSinCos, so taking off the whole turns doesnt add error
+        float w = static_cast<float>(whole);
+        float wrapped = (angle - w * 6.28125f) - w * 1.9353071795864769e-3f;
+
+        // turns can round to the next whole turn when the angle is just short of it
+        if (wrapped < 0.0f) wrapped += two_pi;
+        if (wrapped >= two_pi) wrapped -= two_pi;
+        return (wrapped >= 0.0f && wrapped < two_pi) ? wrapped : 0.0f;
+    }
+
+    // value in [0, period), for phases that keep growing all game so they stay in double until they're wrapped
+    inline double WrapPeriod(double value, double period)
+    {
+        return value - period * std::floor(value / period);
+    }
+
+    // sin and cos of the same angle
+    inline void FastSinCos(float angle, float &s, float &c)
+    {
+        // which quarter turn the angle is nearest, then how far it is from it in [-pi/4, pi/4]
+        // pi/2 is split in three so the first products are exact and the remainder keeps its bits
+        float turns = angle * 0.63661977236758134308f + 0.5f;
+        int quadrant = static_cast<int>(turns);
+        if (quadrant > turns) quadrant--;
+        float q = static_cast<float>(quadrant);
+        float r = ((angle - q * 1.5703125f) - q * 4.837512969970703125e-4f) - q * 7.54978995489188216e-8f;
+
+        float z = r * r;
+        float sr = r + r * z * (-1.6666654611e-1f + z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+        float cr = (1.0f - 0.5f * z) + z * z * (4.166664568298827e-2f + z * (-1.388731625493765e-3f + z * 2.443315711809948e-5f));
+
+        // rotate the answer round by the quarter turns
+        float sin_value = (quadrant & 1) ? cr : sr;
+        float cos_value = (quadrant & 1) ? sr : cr;
+        s = (quadrant & 2) ? -sin_value : sin_value;
+        c = ((quadrant + 1) & 2) ? -cos_value : cos_value;
+    }
+
+    // atan2(y, x) in [-pi, pi], 0 for (0, 0)
+    inline float FastAtan2(float y, float x)
+    {
+        // atan of the smaller over the larger is in [0, pi/4], then fold that out to the right octant
+        float ax = std::fabs(x);
+        float ay = std::fabs(y);
+        float larger = (ax > ay) ? ax : ay;
+        float smaller = (ax > ay) ? ay : ax;
+        float a = smaller / ((larger > 1e-30f) ? larger : 1e-30f);
+
+        // Abramowitz and Stegun 4.4.49
+        float z = a * a;
+        float r = a * (1.0f + z * (-0.3333314528f + z * (0.1999355085f + z * (-0.1420889944f + z * (0.1065626393f
+                + z * (-0.0752896400f + z * (0.0429096138f + z * (-0.0161657367f + z * 0.0028662257f))))))));
+
+        if (ay > ax) r = 1.57079632679489661923f - r;
+        if (x < 0.0f) r = 3.14159265358979323846f - r;
+        return std::copysign(r, y);
+    }
+
+    // s[i] and c[i] are the sin and cos of angle[i], for count angles
+    void SinCosBatch(const float *angle, float *s, float *c, int count);
+
+    // angle[i] is atan2(y[i], x[i]), for count pairs
+    void Atan2Batch(const float *y, const float *x, float *angle, int count);
+
+    // Which instruction set the batched functions were built for ("avx2", "sse2" or "scalar")
+    const char *FastMathPath(void);
+
+} // namespace game
+
+#endif // FAST_MATH_H_
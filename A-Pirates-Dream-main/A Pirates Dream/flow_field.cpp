@@ -0,0 +1,476 @@
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+#include "flow_field.h"
+#include "snapshot.h"
+
+namespace game {
+
+namespace {
+
+    // the eight neighbours, straight ones first, and what a step to each costs
+    // a cell's next step is the first of these on a cheapest way, so the order decides ties
+    const int step_x_g[] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+    const int step_y_g[] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+    const int step_cost_g[] = { 10, 10, 10, 10, 14, 14, 14, 14 };
+
+    // the step back the other way
+    const int step_back_g[] = { 1, 0, 3, 2, 7, 6, 5, 4 };
+
+    // one more bucket than the dearest step, so a bucket is empty again before anything is added to it
+    const int bucket_count_g = 15;
+
+    // how close (in cells) the goal may get to the edge before the grid moves to centre it again
+    const int edge_margin_g = 8;
+
+} // namespace
+
+
+FlowField::FlowField(float cell_size, int half_cells)
+{
+    cell_size_ = cell_size;
+    width_ = 2 * half_cells;
+    origin_x_ = -half_cells * cell_size_;
+    origin_y_ = -half_cells * cell_size_;
+    goal_ = glm::vec3(0.0f);
+    goal_cell_ = -1;
+
+    blocked_.assign(width_ * width_, 0);
+    covered_.assign(width_ * width_, 0);
+    cost_.assign(width_ * width_, INT_MAX);
+    next_.assign(width_ * width_, -1);
+    stamp_.assign(width_ * width_, 0);
+    pass_ = 0;
+    buckets_.resize(bucket_count_g);
+
+    obstacles_moved_ = false;
+    dirty_ = true;
+    repaired_ = 0;
+}
+
+
+void FlowField::AddObstacle(const glm::vec3 &centre, float radius)
+{
+    obstacles_.push_back(glm::vec3(centre.x, centre.y, radius));
+    obstacles_moved_ = true;
+}
+
+
+void FlowField::ClearObstacles(void)
+{
+    if (obstacles_.empty()) return;
+    obstacles_.clear();
+    obstacles_moved_ = true;
+}
+
+
+int FlowField::CellAt(const glm::vec3 &position) const
+{
+    int x = static_cast<int>(floorf((position.x - origin_x_) / cell_size_));
+    int y = static_cast<int>(floorf((position.y - origin_y_) / cell_size_));
+    if (x < 0 || y < 0 || x >= width_ || y >= width_) return -1;
+    return y * width_ + x;
+}
+
+
+glm::vec3 FlowField::CellCentre(int cell) const
+{
+    return glm::vec3(origin_x_ + (cell % width_ + 0.5f) * cell_size_, origin_y_ + (cell / width_ + 0.5f) * cell_size_, 0.0f);
+}
+
+
+int FlowField::StepFrom(int x, int y, int step) const
+{
+    int nx = x + step_x_g[step];
+    int ny = y + step_y_g[step];
+    if (nx < 0 || ny < 0 || nx >= width_ || ny >= width_) return -1;
+
+    int neighbour = ny * width_ + nx;
+    if (blocked_[neighbour]) return -1;
+
+    // no squeezing diagonally between two blocked cells
+    if (step >= 4 && (blocked_[y * width_ + nx] || blocked_[ny * width_ + x])) return -1;
+    return neighbour;
+}
+
+
+void FlowField::Update(const glm::vec3 &goal)
+{
+    goal_ = goal;
+    repaired_ = 0;
+    seeds_.clear();
+    changed_.clear();
+
+    // move the grid (by whole cells, so cells line up the same way wherever it is) once the goal nears an edge
+    int goal_cell = CellAt(goal);
+    int gx = goal_cell % width_;
+    int gy = goal_cell / width_;
+    if (goal_cell < 0 || gx < edge_margin_g || gy < edge_margin_g || gx >= width_ - edge_margin_g || gy >= width_ - edge_margin_g) {
+        float origin_x = (floorf(goal.x / cell_size_) - width_ / 2) * cell_size_;
+        float origin_y = (floorf(goal.y / cell_size_) - width_ / 2) * cell_size_;
+        int dx = static_cast<int>(floorf((origin_x - origin_x_) / cell_size_ + 0.5f));
+        int dy = static_cast<int>(floorf((origin_y - origin_y_) / cell_size_ + 0.5f));
+        if (abs(dx) >= width_ || abs(dy) >= width_) dirty_ = true;
+        if (!dirty_) Shift(dx, dy);
+
+        origin_x_ = origin_x;
+        origin_y_ = origin_y;
+        goal_cell = CellAt(goal);
+        obstacles_moved_ = true;
+    }
+
+    // nothing to repair while the goal stays in its cell and the obstacles stay where they were
+    if (!dirty_ && !obstacles_moved_ && goal_cell == goal_cell_) return;
+    obstacles_moved_ = false;
+    RasterizeObstacles(goal_cell);
+
+    // newly covered cells lose their cost (to the old goal), and so does every cell whose way went through one of them or cut past its corner
+    // (that's the only way a cost goes up, every other cell keeps a way that's still there)
+    for (int c = 0; c < blocked_.size() && !dirty_; c++) {
+        if (covered_[c] == blocked_[c]) continue;
+
+        if (covered_[c]) {
+            Invalidate(c);
+
+            // a diagonal step squeezes past the two cells beside it, so only the cells straight next to this one can cut past it
+            int x = c % width_;
+            int y = c / width_;
+            for (int s = 0; s < 4; s++) {
+                int mx = x + step_x_g[s];
+                int my = y + step_y_g[s];
+                if (mx < 0 || my < 0 || mx >= width_ || my >= width_) continue;
+
+                int m = my * width_ + mx;
+                int t = next_[m];
+                if (t < 4) continue;
+                if (mx + step_x_g[t] == x || my + step_y_g[t] == y) Invalidate(m);
+            }
+        }
+
+        blocked_[c] = covered_[c];
+        changed_.push_back(c);
+    }
+
+    // then the goal moving keeps the part of the field that already led through its new cell
+    if (!dirty_ && goal_cell != goal_cell_ && !MoveGoal(goal_cell)) dirty_ = true;
+
+    if (dirty_) {
+        blocked_.swap(covered_);
+        goal_cell_ = goal_cell;
+        Rebuild();
+        dirty_ = false;
+        return;
+    }
+
+    // everything round a cell that lost its cost, came onto the grid or changed blocking searches again from the
+    // cost it has, which also lets costs come down through cells that just opened up
+    pass_++;
+    for (int i = 0; i < changed_.size(); i++) {
+        int x = changed_[i] % width_;
+        int y = changed_[i] / width_;
+        for (int my = std::max(0, y - 1); my <= std::min(width_ - 1, y + 1); my++) {
+            for (int mx = std::max(0, x - 1); mx <= std::min(width_ - 1, x + 1); mx++) {
+                int m = my * width_ + mx;
+                if (stamp_[m] == pass_ || cost_[m] == INT_MAX) continue;
+                stamp_[m] = pass_;
+                seeds_.push_back(std::make_pair(cost_[m], m));
+            }
+        }
+    }
+
+    Search(false);
+}
+
+
+void FlowField::RasterizeObstacles(int goal_cell)
+{
+    std::fill(covered_.begin(), covered_.end(), 0);
+
+    // a cell is blocked if its centre is inside any of the circles
+    for (int o = 0; o < obstacles_.size(); o++) {
+        const glm::vec3 &circle = obstacles_[o];
+        int x0 = std::max(0, static_cast<int>(floorf((circle.x - circle.z - origin_x_) / cell_size_)));
+        int x1 = std::min(width_ - 1, static_cast<int>(floorf((circle.x + circle.z - origin_x_) / cell_size_)));
+        int y0 = std::max(0, static_cast<int>(floorf((circle.y - circle.z - origin_y_) / cell_size_)));
+        int y1 = std::min(width_ - 1, static_cast<int>(floorf((circle.y + circle.z - origin_y_) / cell_size_)));
+
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                glm::vec3 d = CellCentre(y * width_ + x) - glm::vec3(circle.x, circle.y, 0.0f);
+                if (d.x * d.x + d.y * d.y < circle.z * circle.z) covered_[y * width_ + x] = 1;
+            }
+        }
+    }
+
+    // the goal counts as free even if it's standing in an obstacle, so there's always somewhere to head for
+    if (goal_cell >= 0) covered_[goal_cell] = 0;
+}
+
+
+void FlowField::Shift(int dx, int dy)
+{
+    // cell (x, y) of the moved grid is cell (x + dx, y + dy) of the old one
+    shifted_cost_.resize(cost_.size());
+    shifted_next_.resize(next_.size());
+    shifted_blocked_.resize(blocked_.size());
+    for (int y = 0; y < width_; y++) {
+        int oy = y + dy;
+        for (int x = 0; x < width_; x++) {
+            int ox = x + dx;
+            int c = y * width_ + x;
+            if (ox < 0 || oy < 0 || ox >= width_ || oy >= width_) {
+                shifted_cost_[c] = INT_MAX;
+                shifted_next_[c] = -1;
+                shifted_blocked_[c] = 0;
+                changed_.push_back(c);
+                continue;
+            }
+            int o = oy * width_ + ox;
+            shifted_cost_[c] = cost_[o];
+            shifted_next_[c] = next_[o];
+            shifted_blocked_[c] = blocked_[o];
+        }
+    }
+    cost_.swap(shifted_cost_);
+    next_.swap(shifted_next_);
+    blocked_.swap(shifted_blocked_);
+
+    int gx = goal_cell_ % width_ - dx;
+    int gy = goal_cell_ / width_ - dy;
+    if (goal_cell_ < 0 || gx < 0 || gy < 0 || gx >= width_ || gy >= width_) {
+        dirty_ = true;
+        return;
+    }
+    goal_cell_ = gy * width_ + gx;
+
+    // the cells along the edge whose way went off the side that was cut away
+    for (int c = 0; c < cost_.size(); c++) {
+        int x = c % width_;
+        int y = c / width_;
+        if (x > 0 && y > 0 && x < width_ - 1 && y < width_ - 1) continue;
+        if (next_[c] < 0) continue;
+        int nx = x + step_x_g[next_[c]];
+        int ny = y + step_y_g[next_[c]];
+        if (nx < 0 || ny < 0 || nx >= width_ || ny >= width_) Invalidate(c);
+    }
+}
+
+
+bool FlowField::MoveGoal(int goal_cell)
+{
+    if (goal_cell < 0 || goal_cell_ < 0 || cost_[goal_cell] == INT_MAX) return false;
+
+    // every cell with a cheapest way to the old goal through the new goal's cell still has a cheapest way to it,
+    // the first part of the same way, so those are found going out from the new goal's cell by steps that cost
+    // exactly the difference
+    pass_++;
+    stamp_[goal_cell] = pass_;
+    stack_.clear();
+    stack_.push_back(goal_cell);
+    int kept = 0;
+    int reached = 0;
+    while (!stack_.empty()) {
+        int c = stack_.back();
+        stack_.pop_back();
+        kept++;
+        int x = c % width_;
+        int y = c / width_;
+        for (int s = 0; s < 8; s++) {
+            int n = StepFrom(x, y, s);
+            if (n >= 0 && stamp_[n] != pass_ && cost_[n] != INT_MAX && cost_[n] == cost_[c] + step_cost_g[s]) {
+                stamp_[n] = pass_;
+                stack_.push_back(n);
+            }
+        }
+    }
+
+    // in the open that's only the quarter of the field beyond the new goal, and repairing the rest costs more
+    // than searching it all from scratch, so only bother when most of the field is kept
+    for (int c = 0; c < cost_.size(); c++) {
+        if (cost_[c] != INT_MAX) reached++;
+    }
+    if (kept * 2 < reached) return false;
+
+    // the rest are searched again
+    int d = cost_[goal_cell];
+    for (int c = 0; c < cost_.size(); c++) {
+        if (stamp_[c] == pass_) {
+            cost_[c] -= d;
+        }
+        else if (cost_[c] != INT_MAX) {
+            cost_[c] = INT_MAX;
+            next_[c] = -1;
+            changed_.push_back(c);
+        }
+    }
+
+    goal_cell_ = goal_cell;
+    next_[goal_cell] = -1;
+    return true;
+}
+
+
+void FlowField::Invalidate(int cell)
+{
+    if (cost_[cell] == INT_MAX) return;
+
+    // the cells whose next step leads into a forgotten cell, and so on outwards
+    cost_[cell] = INT_MAX;
+    stack_.clear();
+    stack_.push_back(cell);
+    while (!stack_.empty()) {
+        int c = stack_.back();
+        stack_.pop_back();
+        next_[c] = -1;
+        changed_.push_back(c);
+
+        int x = c % width_;
+        int y = c / width_;
+        for (int s = 0; s < 8; s++) {
+            int nx = x - step_x_g[s];
+            int ny = y - step_y_g[s];
+            if (nx < 0 || ny < 0 || nx >= width_ || ny >= width_) continue;
+            int n = ny * width_ + nx;
+            if (next_[n] == s && cost_[n] != INT_MAX) {
+                cost_[n] = INT_MAX;
+                stack_.push_back(n);
+            }
+        }
+    }
+}
+
+
+void FlowField::Rebuild(void)
+{
+    std::fill(cost_.begin(), cost_.end(), INT_MAX);
+    std::fill(next_.begin(), next_.end(), -1);
+
+    seeds_.clear();
+    changed_.clear();
+    cost_[goal_cell_] = 0;
+    seeds_.push_back(std::make_pair(0, goal_cell_));
+    Search(true);
+}
+
+
+void FlowField::Search(bool all)
+{
+    // Dijkstra out from the seeds, with a bucket per cost instead of a heap since a step never costs more than 14
+    // the buckets go round in a ring, a cell is never more than one step's cost ahead of the one being looked at,
+    // and each seed joins the ring when the search gets to its cost (or the search skips ahead to it if the ring is empty)
+    std::sort(seeds_.begin(), seeds_.end());
+    for (int b = 0; b < bucket_count_g; b++) buckets_[b].clear();
+    int waiting = 0;
+    int k = 0;
+    for (int cost = 0; waiting > 0 || k < seeds_.size(); cost++) {
+        if (waiting == 0) cost = std::max(cost, seeds_[k].first);
+        std::vector<int> &bucket = buckets_[cost % bucket_count_g];
+        for (; k < seeds_.size() && seeds_[k].first == cost; k++) {
+            bucket.push_back(seeds_[k].second);
+            waiting++;
+        }
+
+        for (int i = 0; i < bucket.size(); i++) {
+            int cell = bucket[i];
+            waiting--;
+            if (cost > cost_[cell]) continue;
+
+            // StepFrom() written out, this loop is most of the time an Update() takes
+            int x = cell % width_;
+            int y = cell / width_;
+            for (int s = 0; s < 8; s++) {
+                int nx = x + step_x_g[s];
+                int ny = y + step_y_g[s];
+                if (nx < 0 || ny < 0 || nx >= width_ || ny >= width_) continue;
+
+                int neighbour = ny * width_ + nx;
+                if (blocked_[neighbour]) continue;
+                if (s >= 4 && (blocked_[y * width_ + nx] || blocked_[ny * width_ + x])) continue;
+
+                // the neighbour's next step is the first step back to a cell it's cheapest to go through
+                int new_cost = cost + step_cost_g[s];
+                if (new_cost < cost_[neighbour]) {
+                    cost_[neighbour] = new_cost;
+                    next_[neighbour] = step_back_g[s];
+                    buckets_[new_cost % bucket_count_g].push_back(neighbour);
+                    waiting++;
+                    if (!all) changed_.push_back(neighbour);
+                    repaired_++;
+                }
+                else if (new_cost == cost_[neighbour] && step_back_g[s] < next_[neighbour]) {
+                    next_[neighbour] = step_back_g[s];
+                }
+            }
+        }
+        bucket.clear();
+    }
+
+    // searching from scratch looks at every way into every cell, but a repair only looks at the ways out of the
+    // cells it searched, so the cells round those pick their next step again from scratch
+    // (a cell's next step only depends on its own cost and blocking and those of the cells round it)
+    if (all) return;
+    pass_++;
+    for (int i = 0; i < changed_.size(); i++) {
+        int cx = changed_[i] % width_;
+        int cy = changed_[i] / width_;
+        for (int y = std::max(0, cy - 1); y <= std::min(width_ - 1, cy + 1); y++) {
+            for (int x = std::max(0, cx - 1); x <= std::min(width_ - 1, cx + 1); x++) {
+                int c = y * width_ + x;
+                if (stamp_[c] == pass_) continue;
+                stamp_[c] = pass_;
+
+                next_[c] = -1;
+                if (c == goal_cell_ || cost_[c] == INT_MAX) continue;
+                for (int s = 0; s < 8; s++) {
+                    int n = StepFrom(x, y, s);
+                    if (n >= 0 && cost_[n] != INT_MAX && cost_[n] + step_cost_g[s] == cost_[c]) {
+                        next_[c] = s;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+void FlowField::Save(Snapshot &snapshot) const
+{
+    snapshot.Put(origin_x_);
+    snapshot.Put(origin_y_);
+}
+
+
+void FlowField::Load(Snapshot &snapshot)
+{
+    origin_x_ = snapshot.Get<float>();
+    origin_y_ = snapshot.Get<float>();
+
+    // the field only depends on the grid, the obstacles and the goal's cell, so searching it again from scratch gives the same field as before
+    goal_cell_ = -1;
+    dirty_ = true;
+}
+
+
+glm::vec3 FlowField::Sample(const glm::vec3 &position) const
+{
+    int cell = CellAt(position);
+
+    glm::vec3 target = goal_;
+    if (cell >= 0 && cell != goal_cell_) {
+        // cells the search never reached (walled off, or inside an obstacle) have nowhere to go
+        if (next_[cell] < 0) return glm::vec3(0.0f);
+        target = CellCentre(cell + step_y_g[next_[cell]] * width_ + step_x_g[next_[cell]]);
+    }
+
+    // head for the next cell's centre from where we actually are, so pursuers dont all snap to the same eight directions
+    glm::vec3 d = target - position;
+    d.z = 0.0f;
+    float length = sqrtf(d.x * d.x + d.y * d.y);
+    if (length < 1e-6f) return glm::vec3(0.0f);
+    return d / length;
+}
+
+} // namespace game
@@ -0,0 +1,131 @@
+#ifndef FLOW_FIELD_H_
+#define FLOW_FIELD_H_
+
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace game {
+
+    class Snapshot;
+
+    /*
+        FlowField tells anything chasing one goal (the player) which way to head from wherever it is, round any
+        obstacles, so every pursuer shares one path search instead of each working out its own.
+
+        The field is a square grid of cells centred near the goal. Every cell keeps its cost to reach the goal
+        (8 neighbours, no cutting past blocked corners) and which neighbour is its next step there. The first
+        Update() searches the whole grid, after that it only repairs what changed since the last one:
+          - the goal moving cell keeps every cell that had a cheapest way to the goal through the new goal's cell
+            (less what that last stretch cost) and searches again from those for the rest, unless that's less than
+            half the field (as it is out in the open), when searching from scratch is quicker
+          - the grid moving (in whole cells, once the goal nears its edge) shifts the arrays along, and only the
+            cells that came onto the grid and the ones whose way went off it are searched again
+          - cells an obstacle now covers are taken out along with every cell whose way went through them, and
+            cells one uncovered let their neighbours search through them
+        Costs are exact, and each cell's next step is the first neighbour in a fixed order that is on a cheapest
+        way, so a repaired field is always the same as one searched from scratch. Sample() is a cell lookup,
+        safe from any thread.
+    */
+    class FlowField {
+
+        public:
+            // half_cells cells either side of the centre, each cell_size wide
+            FlowField(float cell_size = 0.5f, int half_cells = 32);
+
+            // Block the cells a circle covers from the next Update(), until ClearObstacles()
+            // (cheap to do again every tick, the next Update() only repairs the cells that changed)
+            void AddObstacle(const glm::vec3 &centre, float radius);
+            void ClearObstacles(void);
+
+            // Chase goal, repairing the field where the goal, the grid or the obstacles changed
+            void Update(const glm::vec3 &goal);
+
+            // Unit vector to head along from position
+            // Straight at the goal when position is in the goal's cell or off the grid, zero if there's no way through
+            glm::vec3 Sample(const glm::vec3 &position) const;
+
+            // Save and restore where the grid sits, the field is searched again from scratch on the next Update()
+            // (which gives the same field, the obstacles are added again before it)
+            void Save(Snapshot &snapshot) const;
+            void Load(Snapshot &snapshot);
+
+            // Cells searched again by the last Update(), all of them when it had to start from scratch
+            inline int GetRepairedCount(void) const { return repaired_; }
+
+        private:
+            // Which cell of the grid a point is in, -1 when off the grid
+            int CellAt(const glm::vec3 &position) const;
+
+            // Centre of a cell in the world
+            glm::vec3 CellCentre(int cell) const;
+
+            // The neighbour one step (0 to 7) from the cell at x, y, -1 if it's off the grid, blocked or past a blocked corner
+            int StepFrom(int x, int y, int step) const;
+
+            // Mark the cells the obstacles cover into covered_, leaving the goal's cell free
+            void RasterizeObstacles(int goal_cell);
+
+            // Move the grid by dx, dy cells, keeping every cell that stays on it
+            void Shift(int dx, int dy);
+
+            // Make the goal's cell goal_cell, false if the field has no way there or would keep too little of itself
+            // to be worth repairing, and has to start from scratch
+            bool MoveGoal(int goal_cell);
+
+            // Forget the cost of cell and of every cell whose way to the goal goes through it
+            void Invalidate(int cell);
+
+            // Search out from everything queued until no cost can come down any more, then pick the next step
+            // again for every cell round one whose cost (or blocking) changed, or every cell when all is set
+            void Search(bool all);
+
+            // Search the whole grid from the goal
+            void Rebuild(void);
+
+            float cell_size_;
+            int width_;
+
+            // world position of the corner of cell 0, always a whole number of cells
+            float origin_x_;
+            float origin_y_;
+
+            glm::vec3 goal_;
+            int goal_cell_;
+
+            // obstacles as circles (x, y, radius), rasterized again every Update()
+            std::vector<glm::vec3> obstacles_;
+            std::vector<unsigned char> blocked_;
+            std::vector<unsigned char> covered_;
+
+            // obstacles were added or cleared (or the grid moved under them) since they were last rasterized
+            bool obstacles_moved_;
+
+            // cost to reach the goal (10 a step, 14 diagonally) and the step (0 to 7) to take next, -1 when there's no way
+            std::vector<int> cost_;
+            std::vector<int> next_;
+
+            // where the search starts from as (cost, cell), its cells waiting to be looked at by cost, the cells it has
+            // to look round afterwards, and stamps so each cell is only looked at once a pass, all kept so repairing
+            // doesnt allocate
+            std::vector<std::pair<int, int> > seeds_;
+            std::vector<std::vector<int> > buckets_;
+            std::vector<int> changed_;
+            std::vector<int> stack_;
+            std::vector<unsigned int> stamp_;
+            unsigned int pass_;
+
+            // spare arrays for shifting the grid into
+            std::vector<int> shifted_cost_;
+            std::vector<int> shifted_next_;
+            std::vector<unsigned char> shifted_blocked_;
+
+            // the field needs searching from scratch before it can be sampled
+            bool dirty_;
+            int repaired_;
+
+    }; // class FlowField
+
+} // namespace game
+
+#endif // FLOW_FIELD_H_
@@ -0,0 +1,86 @@
+#include <iomanip>
+
+#include "frame_histogram.h"
+
+namespace game {
+
+FrameHistogram::FrameHistogram(void)
+{
+    Reset();
+}
+
+
+void FrameHistogram::Add(double ms)
+{
+    // find the power of two the time in microseconds falls under
+    double us = ms * 1000.0;
+    int bucket = 0;
+    double edge = 1.0;
+    while (us >= edge && bucket < num_buckets_ - 1) {
+        edge *= 2.0;
+        bucket++;
+    }
+
+    buckets_[bucket]++;
+    count_++;
+    total_ms_ += ms;
+    if (ms > max_ms_) max_ms_ = ms;
+}
+
+
+void FrameHistogram::Reset(void)
+{
+    for (int b = 0; b < num_buckets_; b++) {
+        buckets_[b] = 0;
+    }
+    count_ = 0;
+    total_ms_ = 0.0;
+    max_ms_ = 0.0;
+}
+
+
+double FrameHistogram::Percentile(double fraction) const
+{
+    if (count_ == 0) return 0.0;
+
+    long wanted = static_cast<long>(fraction * count_ + 0.5);
+    if (wanted < 1) wanted = 1;
+
+    long seen = 0;
+    double edge = 1.0;
+    for (int b = 0; b < num_buckets_; b++) {
+        seen += buckets_[b];
+        if (seen >= wanted) return (b == num_buckets_ - 1) ? max_ms_ : edge / 1000.0;
+        edge *= 2.0;
+    }
+    return max_ms_;
+}
+
+
+void FrameHistogram::Report(std::ostream &out) const
+{
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+
+    out << "Tick times (" << count_ << " ticks, mean " << (count_ > 0 ? total_ms_ * 1000.0 / count_ : 0.0) << " us, max "
+        << max_ms_ * 1000.0 << " us, p50 < " << Percentile(0.5) * 1000.0 << " us, p99 < " << Percentile(0.99) * 1000.0 << " us):" << std::endl;
+
+    double low = 0.0;
+    double high = 1.0;
+    for (int b = 0; b < num_buckets_; b++) {
+        if (buckets_[b] > 0) {
+            out << "  " << std::setw(9) << low << " - ";
+            if (b == num_buckets_ - 1) out << std::setw(9) << "" << " us";
+            else out << std::setw(9) << high << " us";
+            out << std::setw(10) << buckets_[b] << std::endl;
+        }
+        low = high;
+        high *= 2.0;
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+} // namespace game
@@ -0,0 +1,43 @@
+#ifndef FRAME_HISTOGRAM_H_
+#define FRAME_HISTOGRAM_H_
+
+#include <ostream>
+
+namespace game {
+
+    // Counts how long ticks or frames took in power of two buckets, so two runs (or two builds running the
+    // same replay) can be compared by their spikes and not just their average
+    class FrameHistogram {
+
+        public:
+            FrameHistogram(void);
+
+            // Count one tick or frame that took the given number of milliseconds
+            void Add(double ms);
+
+            // Forget everything counted so far
+            void Reset(void);
+
+            // Upper edge of the bucket the given fraction (0 to 1) of samples fall under, in milliseconds
+            double Percentile(double fraction) const;
+
+            inline long GetCount(void) const { return count_; }
+            inline double GetMax(void) const { return max_ms_; }
+
+            // Print the non-empty buckets and a few percentiles
+            void Report(std::ostream &out) const;
+
+        private:
+            // bucket 0 is under a microsecond, bucket b covers [2^(b-1), 2^b) microseconds, the last takes the rest
+            static const int num_buckets_ = 26;
+
+            long buckets_[num_buckets_];
+            long count_;
+            double total_ms_;
+            double max_ms_;
+
+    }; // class FrameHistogram
+
+} // namespace game
+
+#endif // FRAME_HISTOGRAM_H_
@@ -1,5 +1,7 @@
 #include <stdexcept>
 #include <string>
+#include <chrono>
+#include <algorithm>
 #define GLM_FORCE_RADIANS
 #include <glm/gtc/matrix_transform.hpp> 
 #include <SOIL/SOIL.h>
@@ -17,6 +19,7 @@
 #include "timer.h"
 #include "particles.h"
 #include "particle_system.h"
+#include "fast_math.h"
 
 namespace game {
 
@@ -32,15 +35,191 @@ const glm::vec3 viewport_background_color_g(0.0, 0.0, 1.0);
 // Directory with game resources such as textures
 const std::string resources_directory_g = RESOURCES_DIRECTORY;
 
+// Objects per job when the per object updates are split across threads, lists shorter than this just run on the main thread
+const int update_grain_g = 64;
+
+// Bullets and spikes per job for the collision passes, each one is a grid query and a swept test so they're worth splitting finer
+const int collision_grain_g = 8;
+
+// The collision passes, in the order their commands are applied
+enum CollisionPass { contact_pass_g, pickup_pass_g, bullet_pass_g, spike_pass_g };
+
+// Most of each kind of object that can be around at once, their memory is set aside up front so spawning never allocates
+const int enemy_pool_size_g = 64;
+const int collectible_pool_size_g = 64;
+const int bullet_pool_size_g = 32;
+const int spike_pool_size_g = 16;
+const int trail_pool_size_g = 32;
+const int explosion_pool_size_g = 64;
+
+// The kraken's tentacles: how many, and how many segments each, the first segment this long and each one after a bit shorter
+const int tentacle_count_g = 8;
+const int tentacle_segments_g = 8;
+const float tentacle_segment_length_g = 0.35f;
+const float tentacle_taper_g = 0.9f;
+
+// How far from the kraken's centre the tentacles are rooted
+const float tentacle_root_radius_g = 0.4f;
+
+// What the flow field routes pursuers round: the kraken's body, and each tentacle segment as a circle this much
+// wider than half the segment, so the cells along a tentacle join up into a wall
+const float kraken_body_radius_g = 0.6f;
+const float tentacle_obstacle_margin_g = 0.2f;
+
+// How far past its scale each kind of object's drawing reaches from its centre, for culling:
+// a sprite is a unit square so its corners are half a diagonal out, a particle flies up to 0.4 * 4 * 2 = 3.2
+// out (its direction, the shader's speed and cycle) and is a unit square itself
+const float sprite_cull_radius_g = 0.7072f;
+const float particle_cull_radius_g = 3.2f + 0.7072f;
+
 
 Game::Game(void)
+    : enemy_pool_(enemy_pool_size_g), collectible_pool_(collectible_pool_size_g), bullet_pool_(bullet_pool_size_g),
+      spike_pool_(spike_pool_size_g), trail_pool_(trail_pool_size_g), explosion_pool_(explosion_pool_size_g)
 {
     // Don't do work in the constructor, leave it for the Init() function
+    // Only null out what the destructor frees, in case Init() throws part way through
+    window_ = NULL;
+    sprite_ = NULL;
+    bullet_particles_ = NULL;
+    explosion_particles_ = NULL;
+    player_ = NULL;
+    background_tile_ = NULL;
+    end_screen_ = NULL;
+    tex_ = NULL;
+    num_textures_ = 0;
+    headless_ = false;
+    headless_ticks_ = 0;
+    tick_rate_ = 60;
+    max_ticks_per_frame_ = 5;
+    game_over_ = false;
+    replaying_ = false;
+    tick_count_ = 0;
+    stress_ = false;
+    fire_angle_ = 0.0f;
+    timers_ = &TimerService::Default();
+    random_ = &RandomStreams::Default();
+    transforms_ = &TransformStore::Default();
+    jobs_ = NULL;
+    explosion_index_ = -1;
+    background_index_ = -1;
+
+    // the maps hand their objects back to the pools instead of deleting them
+    enemy_game_objects_.SetPool(&enemy_pool_);
+    collectible_game_objects_.SetPool(&collectible_pool_);
+    bullets_.SetPool(&bullet_pool_);
+    spikes_.SetPool(&spike_pool_);
+    particle_game_objects_.SetPool(&trail_pool_);
+    explosions_.SetPool(&explosion_pool_);
 }
 
 
-void Game::Init(void)
+void Game::Init(const GameConfig &config)
 {
+    headless_ = config.headless;
+    headless_ticks_ = config.ticks;
+    tick_rate_ = config.tick_rate;
+    max_ticks_per_frame_ = config.max_ticks_per_frame;
+
+    // a replay brings its own seed and tick rate, so the game plays out exactly as it was recorded
+    unsigned long long seed = (config.seed >= 0) ? static_cast<unsigned long long>(config.seed) : static_cast<unsigned long long>(time(NULL));
+    record_path_ = config.record;
+    replaying_ = !config.replay.empty();
+    if (replaying_)
+    {
+        recording_.Load(config.replay);
+        seed = recording_.GetSeed();
+        tick_rate_ = recording_.GetTickRate();
+        headless_ticks_ = recording_.GetTickCount();
+    }
+    recording_.SetSeed(seed);
+    recording_.SetTickRate(tick_rate_);
+
+    save_snapshot_path_ = config.save_snapshot;
+    load_snapshot_path_ = config.load_snapshot;
+
+    // start tracing before anything loads, so the asset loading shows up in the trace too
+    trace_path_ = config.trace;
+    if (!trace_path_.empty()) Profiler::Default().Start();
+
+    perf_hud_.SetVisible(config.perf_hud);
+
+    // a wave table from the command line replaces the classic one
+    if (!config.waves.empty())
+    {
+        spawn_director_.Load(config.waves);
+        if (headless_) spawn_director_.Print(std::cout);
+    }
+
+    // Seed the random numbers first, the particle geometry below already uses them
+    random_->Seed(seed);
+
+    // a stress scenario keeps far more objects around than the normal game, so the pools grow to fit
+    // (explosions and drops come from every enemy that dies, and a spent bullet's trail lingers for a tick while its replacement gets one too)
+    stress_ = config.stress;
+    scenario_ = config.scenario;
+    if (stress_)
+    {
+        int enemies = scenario_.navy_ships + scenario_.sea_monsters;
+        int collectibles = scenario_.collectibles + enemies;
+
+        // streaming, only the awake chunks' share of the scenario is ever out of the pools at once, they get twice
+        // that (and the normal game's pools on top) since the objects never spread out quite evenly
+        if (scenario_.streaming && config.chunk_size > 0)
+        {
+            float window = (2 * config.active_chunks + 1) * static_cast<float>(config.chunk_size);
+            float share = std::min(1.0f, 2.0f * window * window / (4.0f * scenario_.extent * scenario_.extent));
+            enemies = std::min(enemies, static_cast<int>(share * enemies) + enemy_pool_size_g);
+            collectibles = std::min(collectibles, static_cast<int>(share * collectibles) + collectible_pool_size_g);
+        }
+
+        enemy_pool_.Reserve(enemies);
+        collectible_pool_.Reserve(collectibles);
+        bullet_pool_.Reserve(scenario_.projectiles + bullet_pool_size_g);
+        trail_pool_.Reserve(2 * scenario_.projectiles + trail_pool_size_g);
+        explosion_pool_.Reserve(enemies + explosion_pool_size_g);
+    }
+
+    // the sea far from the player sleeps, unless that's turned off (a stress scenario keeps everything awake unless it asks)
+    if (config.chunk_size > 0) chunks_.Configure(static_cast<float>(config.chunk_size), config.active_chunks);
+    chunks_.SetEnabled(config.chunk_size > 0 && (!stress_ || scenario_.streaming));
+
+    // far away enemies update less often, unless that's turned off too
+    if (config.lod_distance > 0) lod_.Configure(static_cast<float>(config.lod_distance));
+    lod_.SetEnabled(config.lod_distance > 0);
+
+    // Start the worker threads
+    jobs_ = new JobSystem(config.threads);
+
+    // every thread gets its own collision scratch space and command list
+    scratch_.resize(jobs_->GetThreadCount());
+    commands_.SetThreadCount(jobs_->GetThreadCount());
+
+    // Initialize time
+    current_time_ = 0.0;
+
+    // Initialize player health
+    player_health_ = 3;
+
+    //
+    score_ = 0;
+
+    //
+    boss_ = false;
+
+    // Initialize buff count
+    buff_count_ = 0;
+
+    if (headless_)
+    {
+        // No window, context or audio device, so the geometry never gets GPU buffers
+        sprite_ = new Sprite();
+        bullet_particles_ = new Particles(glm::vec3(0.8f, 0.4f, 0.01f), .05f, 1.0f);
+        explosion_particles_ = new Particles(glm::vec3(0.8f, 0.4f, 0.01f), 3.14f, 0.4f, 15.0f);
+        return;
+    }
+
+    PROFILE_ZONE("Init");
 
     // Initialize the window management library (GLFW)
     if (!glfwInit()) {
@@ -71,40 +250,35 @@ void Game::Init(void)
     // Set event callbacks
     glfwSetFramebufferSizeCallback(window_, ResizeCallback);
 
-    // Initialize sprite geometry
-    sprite_ = new Sprite();
-    sprite_->CreateGeometry();
-
-    // Initialize particle geometry
-    bullet_particles_ = new Particles(glm::vec3(0.8f, 0.4f, 0.01f), .05f, 1.0f);
-    bullet_particles_->CreateGeometry();
-
-    explosion_particles_ = new Particles(glm::vec3(0.8f, 0.4f, 0.01f), 3.14f, 0.4f, 15.0f);
-    explosion_particles_->CreateGeometry();
-
-    // Initialize particle shader
-    particle_shader_.Init((resources_directory_g+std::string("/particle_vertex_shader.glsl")).c_str(), (resources_directory_g+std::string("/particle_fragment_shader.glsl")).c_str());
+    {
+        PROFILE_ZONE("create geometry");
 
-    // Initialize sprite shader
-    sprite_shader_.Init((resources_directory_g+std::string("/sprite_vertex_shader.glsl")).c_str(), (resources_directory_g+std::string("/sprite_fragment_shader.glsl")).c_str());
+        // Initialize sprite geometry
+        sprite_ = new Sprite();
+        sprite_->CreateGeometry();
 
-    // Initialize time
-    current_time_ = 0.0;
+        // Initialize particle geometry
+        bullet_particles_ = new Particles(glm::vec3(0.8f, 0.4f, 0.01f), .05f, 1.0f);
+        bullet_particles_->CreateGeometry();
 
-    // Initialize player health
-    player_health_ = 3;
+        explosion_particles_ = new Particles(glm::vec3(0.8f, 0.4f, 0.01f), 3.14f, 0.4f, 15.0f);
+        explosion_particles_->CreateGeometry();
+    }
 
-    //
-    score_ = 0;
+    {
+        PROFILE_ZONE("load shaders");
 
-    //
-    boss_ = false;
+        // Initialize particle shader
+        particle_shader_.Init((resources_directory_g+std::string("/particle_vertex_shader.glsl")).c_str(), (resources_directory_g+std::string("/particle_fragment_shader.glsl")).c_str());
 
-    // Initialize buff count
-    buff_count_ = 0;
+        // Initialize sprite shader
+        sprite_shader_.Init((resources_directory_g+std::string("/sprite_vertex_shader.glsl")).c_str(), (resources_directory_g+std::string("/sprite_fragment_shader.glsl")).c_str());
+    }
 
     try
     {
+        PROFILE_ZONE("load audio");
+
         // Initialize audio manager
         am.Init(NULL);
 
@@ -146,43 +320,32 @@ Game::~Game()
     
     delete background_tile_;
 
-    for (int i = 0; i < enemy_game_objects_.size(); i++)
-    {
-        delete enemy_game_objects_[i];
-    }
+    delete end_screen_;
 
-    for (int i = 0; i < collectible_game_objects_.size(); i++)
-    {
-        delete collectible_game_objects_[i];
-    }
+    for (int i = 0; i < tentacle_objects_.size(); i++) delete tentacle_objects_[i];
 
-    for (int i = 0; i < particle_game_objects_.size(); i++)
-    {
-        delete particle_game_objects_[i];
-    }
+    delete jobs_;
 
-    delete enemy_timer_;
-    delete buff_timer_;
+    // the entity maps and their pools free the enemies, collectibles, bullets and particle systems themselves
 
     // Close window
-    glfwDestroyWindow(window_);
-    glfwTerminate();
-    
-    
+    if (window_)
+    {
+        glfwDestroyWindow(window_);
+        glfwTerminate();
+    }
 }
 
 
 void Game::Setup(void)
 {
+    PROFILE_ZONE("Setup");
 
     // Setup the game world
 
     // Load textures
     SetAllTextures();
 
-    // seed the random 
-    srand (time(NULL));
-
     // Setup the player object (position, texture, vertex count)
     // Note that, in this specific implementation, the player object should always be the first object in the game object vector 
     player_ = new PlayerGameObject(glm::vec3(0.0f, 0.0f, 0.0f), sprite_, &sprite_shader_, tex_[0]);
@@ -200,20 +363,8 @@ void Game::Setup(void)
     num_enemies_ = 0;
 
 
-    // spawn 5 enemies to start at random positions
-    while(num_enemies_ < 5)
-    {
-        // get a random x and y for the new enemy
-        float x = static_cast <float> (rand()) / (static_cast <float> (RAND_MAX/8.0f)) - 4.0f;
-        float y = static_cast <float> (rand()) / (static_cast <float> (RAND_MAX/8.0f)) - 4.0f;
-
-        // make sure the new frog isnt too close to the player, and if it isnt add it to the list
-        if (! ( player_->GetPosition().x + 1.4f > x && player_->GetPosition().x - 1.4f < x ) && ! ( player_->GetPosition().y + 1.4f > y && player_->GetPosition().y - 1.4f < y ) )
-        {
-            enemy_game_objects_.push_back(new EnemyGameObject(glm::vec3(x, y, 0.0f), sprite_, &sprite_shader_, tex_[1]));
-            num_enemies_ ++;
-        }
-    }
+    // the opening wave and everything after it comes from the spawn director (a stress scenario fills the world its own way below)
+    if (!stress_) spawn_director_.Start(random_->Get(RandomStreams::SPAWN));
     
     //set the base buffs to 0 since were not spawning any here
     num_buffs_ = 0;
@@ -234,10 +385,42 @@ void Game::Setup(void)
     timer_objects_.push_back( new GameObject (glm::vec3(0.0f), sprite_, &sprite_shader_, tex_[10]) );
     timer_objects_.back()->SetScale(0.5);
 
-    // initialize the timers for spawning
-    enemy_timer_ = new Timer();
-    buff_timer_ = new Timer();
-    bullet_timer_ = new Timer();
+    // the overlay draws its numbers with the score's digits, and counts get the texture of what they count
+    if (!headless_)
+    {
+        perf_hud_.Init(sprite_, &sprite_shader_, tex_ + 10);
+        perf_hud_.SetIcon(PerfHud::ENEMIES, tex_[1]);
+        perf_hud_.SetIcon(PerfHud::COLLECTIBLES, tex_[8]);
+        perf_hud_.SetIcon(PerfHud::BULLETS, tex_[6]);
+        perf_hud_.SetIcon(PerfHud::SPIKES, tex_[20]);
+        perf_hud_.SetIcon(PerfHud::EXPLOSIONS, tex_[4]);
+        perf_hud_.SetIcon(PerfHud::CHILDREN, tex_[24]);
+    }
+
+    if (stress_)
+    {
+        // the clumps stay put for the whole run so the crowding is the same every tick
+        Random &spawn = random_->Get(RandomStreams::SPAWN);
+        for (int i = 0; i < scenario_.clusters; i++)
+        {
+            cluster_centres_.push_back(glm::vec3(spawn.Range(-scenario_.extent, scenario_.extent), spawn.Range(-scenario_.extent, scenario_.extent), 0.0f));
+        }
+
+        scenario_.Print(std::cout);
+        FillScenario();
+    }
+
+    // a saved game replaces everything set up above
+    if (!load_snapshot_path_.empty())
+    {
+        Snapshot snapshot;
+        snapshot.Load(load_snapshot_path_);
+        LoadSnapshot(snapshot);
+        std::cout << "Loaded snapshot of tick " << tick_count_ << " from " << load_snapshot_path_ << std::endl;
+
+        // the replay picks up from where the snapshot was taken
+        if (replaying_) headless_ticks_ = recording_.GetTickCount() - tick_count_;
+    }
 }
 
 
@@ -280,16 +463,24 @@ void Game::SetTexture(GLuint w, const char *fname)
 
 void Game::SetAllTextures(void)
 {
+    PROFILE_ZONE("load textures");
+
     // Load all textures that we will need
     // Declare all the textures here
-    const char *texture[] = {"/textures/PirateShip.png", "/textures/NavyShip.png", "/textures/Apple.png", "/textures/Ocean.png", "/textures/boom.png", "/textures/SeaMonster.png", "/textures/Cannon Ball.png", "/textures/Health.png", "/textures/Barrel.png", "/textures/DamageBoost.png", "/textures/0.png", "/textures/1.png", "/textures/2.png", "/textures/3.png", "/textures/4.png", "/textures/5.png", "/textures/6.png", "/textures/7.png", "/textures/8.png", "/textures/9.png", "/textures/Spike.png", "/textures/Gold.png", "/textures/KrakenHead.png", "/textures/KrakenArm.png", "/textures/KrakenTentacle.png",  "/textures/Clear.png"};
+    const char *texture[] = {"/textures/PirateShip.png", "/textures/NavyShip.png", "/textures/Apple.png", "/textures/Ocean.png", "/textures/boom.png", "/textures/SeaMonster.png", "/textures/Cannon Ball.png", "/textures/Health.png", "/textures/Barrel.png", "/textures/DamageBoost.png", "/textures/0.png", "/textures/1.png", "/textures/2.png", "/textures/3.png", "/textures/4.png", "/textures/5.png", "/textures/6.png", "/textures/7.png", "/textures/8.png", "/textures/9.png", "/textures/Spike.png", "/textures/Gold.png", "/textures/krakenHead.png", "/textures/KrakenArm.png", "/textures/KrakenTentacle.png",  "/textures/Clear.png"};
     // Get number of declared textures
-    int num_textures = sizeof(texture) / sizeof(char *);
+    num_textures_ = sizeof(texture) / sizeof(char *);
     // Allocate a buffer for all texture references
-    tex_ = new GLuint[num_textures];
-    glGenTextures(num_textures, tex_);
+    tex_ = new GLuint[num_textures_]();
+    // Nothing to load without a GL context, but every texture still gets its own name so snapshots can tell them apart
+    if (headless_)
+    {
+        for (int i = 0; i < num_textures_; i++) tex_[i] = i + 1;
+        return;
+    }
+    glGenTextures(num_textures_, tex_);
     // Load each texture
-    for (int i = 0; i < num_textures; i++){
+    for (int i = 0; i < num_textures_; i++){
         SetTexture(tex_[i], (resources_directory_g+std::string(texture[i])).c_str());
     }
     // Set first texture in the array as default
@@ -299,41 +490,280 @@ void Game::SetAllTextures(void)
 
 void Game::MainLoop(void)
 {
+    if (headless_)
+    {
+        HeadlessLoop();
+        return;
+    }
+
+    typedef std::chrono::steady_clock Clock;
+
+    // The simulation always steps by the same amount, and we run as many steps as the elapsed time covers
+    double tick = 1.0 / tick_rate_;
+    double max_frame_time = tick * max_ticks_per_frame_;
+    double accumulator = 0.0;
+
+    // F9 writes the trace so far and F3 toggles the performance overlay, these remember whether they were already down last frame
+    bool trace_key_down = false;
+    bool hud_key_down = false;
+
+    // F5 quick saves and F8 rolls back to the quick save, the same way
+    bool save_key_down = false;
+    bool load_key_down = false;
+
     // Loop while the user did not close the window
     double last_time = glfwGetTime();
     while (!glfwWindowShouldClose(window_)){
 
-        // Calculate delta time
+        // Calculate how much time the frame has to cover
         double current_time = glfwGetTime();
-        double delta_time = current_time - last_time;
+        double frame_time = current_time - last_time;
         last_time = current_time;
 
+        // if a frame took too long (window dragged, breakpoint, etc) we drop the extra time rather than running a pile of ticks that make the next frame slower again
+        accumulator += frame_time;
+        if (accumulator > max_frame_time) accumulator = max_frame_time;
+
         // Update window events like input handling
         glfwPollEvents();
 
-        // Handle user input
-        HandleControls(delta_time);
+        bool trace_key = glfwGetKey(window_, GLFW_KEY_F9) == GLFW_PRESS;
+        if (trace_key && !trace_key_down) WriteTrace();
+        trace_key_down = trace_key;
+
+        bool hud_key = glfwGetKey(window_, GLFW_KEY_F3) == GLFW_PRESS;
+        if (hud_key && !hud_key_down) perf_hud_.Toggle();
+        hud_key_down = hud_key;
+
+        bool save_key = glfwGetKey(window_, GLFW_KEY_F5) == GLFW_PRESS;
+        if (save_key && !save_key_down) SaveSnapshot(quicksave_);
+        save_key_down = save_key;
+
+        bool load_key = glfwGetKey(window_, GLFW_KEY_F8) == GLFW_PRESS;
+        if (load_key && !load_key_down && quicksave_.GetSize() > 0)
+        {
+            // a quick save that cant be loaded leaves the game as it is
+            try
+            {
+                LoadSnapshot(quicksave_);
+
+                // the input after the quick save never happened now, so a recording carries on from there
+                if (!record_path_.empty()) recording_.Truncate(tick_count_);
+            }
+            catch (std::exception &e)
+            {
+                PrintException(e);
+            }
+        }
+        load_key_down = load_key;
+
+        double update_ms = 0.0;
+
+        while (accumulator >= tick)
+        {
+            PROFILE_ZONE("tick");
+            Clock::time_point tick_start = Clock::now();
+
+            // the same tick the headless loop runs, with the transforms from before it kept to draw in between
+            SaveTransforms();
+            RunTick(NextInput());
+
+            accumulator -= tick;
+            double tick_ms = std::chrono::duration<double, std::milli>(Clock::now() - tick_start).count();
+            tick_histogram_.Add(tick_ms);
+            update_ms += tick_ms;
+        }
 
-        // Update all the game objects
-        Update(delta_time);
+        // a replay is over once its input runs out
+        if (replaying_ && tick_count_ >= recording_.GetTickCount())
+        {
+            glfwSetWindowShouldClose(window_, true);
+        }
 
-        // Render all the game objects
-        Render();
+        // Render all the game objects part way between the last two ticks
+        Clock::time_point render_start = Clock::now();
+        GameObject::ResetDrawCalls();
+        Render(static_cast<float>(accumulator / tick));
+        UpdatePerfHud(frame_time * 1000.0, update_ms, std::chrono::duration<double, std::milli>(Clock::now() - render_start).count());
 
         // Push buffer drawn in the background onto the display
-        glfwSwapBuffers(window_);
+        {
+            PROFILE_ZONE("glfwSwapBuffers");
+            glfwSwapBuffers(window_);
+        }
     }
+
+    FinishRecording();
+    WriteSnapshot();
+    WriteTrace();
+
+    // replays and stress scenarios are for comparing builds, so show what it cost
+    if (replaying_ || stress_)
+    {
+        phase_timer_.Report(std::cout, tick_count_);
+        tick_histogram_.Report(std::cout);
+    }
+}
+
+
+void Game::HeadlessLoop(void)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    phase_timer_.Reset();
+    tick_histogram_.Reset();
+    lod_.ResetTotals();
+
+    long ticks = 0;
+    Clock::time_point start = Clock::now();
+
+    // theres no keyboard without a window, so the input is whatever the replay says (or nothing)
+    while (ticks < headless_ticks_ && !game_over_)
+    {
+        PROFILE_ZONE("tick");
+        Clock::time_point tick_start = Clock::now();
+
+        Step();
+        ticks++;
+
+        tick_histogram_.Add(std::chrono::duration<double, std::milli>(Clock::now() - tick_start).count());
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << "Headless run: " << ticks << " ticks in " << seconds << " s (" << (seconds > 0.0 ? ticks / seconds : 0.0) << " ticks/sec) on " << jobs_->GetThreadCount() << " threads, seed " << random_->GetSeed();
+    if (game_over_) std::cout << ", stopped early at game over";
+    std::cout << std::endl;
+    std::cout << "Final score " << score_ << ", health " << player_health_ << ", enemies " << enemy_game_objects_.GetSize() << ", bullets " << bullets_.GetSize() << ", collectibles " << collectible_game_objects_.GetSize() << std::endl;
+    phase_timer_.Report(std::cout, ticks);
+    tick_histogram_.Report(std::cout);
+    ReportPools(std::cout);
+    if (chunks_.IsEnabled()) chunks_.Print(std::cout);
+    if (lod_.IsEnabled()) lod_.Print(std::cout);
+
+    FinishRecording();
+    WriteSnapshot();
+    WriteTrace();
+}
+
+
+void Game::Step(void)
+{
+    RunTick(NextInput());
+}
+
+
+void Game::Step(InputState input)
+{
+    tick_count_++;
+    RunTick(input);
+}
+
+
+void Game::RunTick(InputState input)
+{
+    double tick = 1.0 / tick_rate_;
+
+    // one clock snapshot per tick, every timer that ran out gets flagged here
+    timers_->Advance(tick);
+
+    // Handle user input
+    phase_timer_.Begin("controls");
+    HandleControls(input, tick);
+
+    // Update all the game objects
+    Update(tick);
+}
+
+
+void Game::SaveTransforms(void)
+{
+    // every object's transform sits in the store, so this is one pass over its arrays rather than a loop per object list
+    transforms_->SaveAll();
+}
+
+
+void Game::PlaySound(int index)
+{
+    // the index stays negative if the audio device or the file never loaded
+    if (index < 0) return;
+
+    if (! am.SoundIsPlaying(index) ) am.PlaySound(index);
+}
+
+
+InputState Game::NextInput(void)
+{
+    InputState input;
+    if (replaying_)
+    {
+        input = recording_.Get(tick_count_);
+    }
+    else
+    {
+        input = window_ ? PollInput(window_) : 0;
+        if (!record_path_.empty()) recording_.Record(input);
+    }
+
+    tick_count_++;
+    return input;
+}
+
+
+void Game::FinishRecording(void)
+{
+    if (record_path_.empty()) return;
+
+    recording_.Save(record_path_);
+    std::cout << "Recorded " << recording_.GetTickCount() << " ticks to " << record_path_ << std::endl;
+}
+
+
+void Game::WriteSnapshot(void)
+{
+    if (save_snapshot_path_.empty()) return;
+
+    Snapshot snapshot;
+    SaveSnapshot(snapshot);
+    snapshot.Save(save_snapshot_path_);
+    std::cout << "Saved snapshot of tick " << tick_count_ << " (" << snapshot.GetSize() << " bytes) to " << save_snapshot_path_ << std::endl;
+}
+
+
+void Game::WriteTrace(void)
+{
+    if (trace_path_.empty()) return;
+
+    Profiler::Default().WriteTrace(trace_path_);
+    std::cout << "Wrote trace to " << trace_path_ << std::endl;
 }
 
 
-void Game::HandleControls(double delta_time)
+void Game::UpdatePerfHud(double frame_ms, double update_ms, double render_ms)
 {
+    perf_hud_.SetCount(PerfHud::DRAWN, culler_.GetDrawn());
+    perf_hud_.SetCount(PerfHud::CULLED, culler_.GetCulled());
+    perf_hud_.SetCount(PerfHud::LOD_SKIPPED, lod_.GetSkipped());
+    perf_hud_.SetCount(PerfHud::ENEMIES, enemy_game_objects_.GetSize());
+    perf_hud_.SetCount(PerfHud::COLLECTIBLES, collectible_game_objects_.GetSize());
+    perf_hud_.SetCount(PerfHud::BULLETS, bullets_.GetSize());
+    perf_hud_.SetCount(PerfHud::SPIKES, spikes_.GetSize());
+    perf_hud_.SetCount(PerfHud::EXPLOSIONS, explosions_.GetSize());
+    perf_hud_.SetCount(PerfHud::TRAILS, particle_game_objects_.GetSize());
+    perf_hud_.SetCount(PerfHud::CHILDREN, child_game_objects_.GetSize() + tentacle_objects_.size());
+    perf_hud_.AddFrame(frame_ms, update_ms, render_ms, GameObject::GetDrawCalls());
+}
+
+
+void Game::HandleControls(InputState input, double delta_time)
+{
+    PROFILE_ZONE("HandleControls");
 
-    if (glfwGetKey(window_, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
+    if ((input & INPUT_QUIT) && window_) {
         glfwSetWindowShouldClose(window_, true);
     }
 
-    if (boss_ && enemy_game_objects_.size() == 0) 
+    if (IsWon()) 
     {
         return;
     }
@@ -355,56 +785,52 @@ void Game::HandleControls(double delta_time)
 
     // add to a velocity based on the keys being pressed
 
-    if (glfwGetKey(window_, GLFW_KEY_W) == GLFW_PRESS) {
+    if (input & INPUT_FORWARD) {
         //curpos += ;
         player_->SetVelocity((motion_increment/5)*dir);
     }
-    if (glfwGetKey(window_, GLFW_KEY_S) == GLFW_PRESS) {
+    if (input & INPUT_BACK) {
         //curpos -= motion_increment*dir;
         player_->SetVelocity(-(motion_increment/5)*dir);
     }
-    if (glfwGetKey(window_, GLFW_KEY_D) == GLFW_PRESS) {
+    if (input & INPUT_TURN_RIGHT) {
         angle -= angle_increment;
     }
-    if (glfwGetKey(window_, GLFW_KEY_A) == GLFW_PRESS) {
+    if (input & INPUT_TURN_LEFT) {
         angle += angle_increment;
     }
-    if (glfwGetKey(window_, GLFW_KEY_Q) == GLFW_PRESS) {
+    if (input & INPUT_STRAFE_LEFT) {
         //curpos += motion_increment*;
         player_->SetVelocity(-(motion_increment/5)*player_->GetRight());
     }
-    if (glfwGetKey(window_, GLFW_KEY_E) == GLFW_PRESS) {
+    if (input & INPUT_STRAFE_RIGHT) {
         //curpos -= motion_increment*player_->GetRight();
         player_->SetVelocity((motion_increment/5)*player_->GetRight());
     }
-    if (glfwGetKey(window_, GLFW_KEY_SPACE) == GLFW_PRESS)
+    if (input & INPUT_FIRE)
     {
-        if (bullet_timer_->Finished() != 0)
+        // the pool being empty just means the player has to wait for a shot to land
+        if (bullet_timer_.Finished() != 0 && bullets_.GetSize() < bullet_pool_.GetCapacity())
         {
-            bullets_.push_back(new ProjectileGameObject(glm::vec3(player_->GetPosition().x, player_->GetPosition().y, 0.0f), sprite_, &sprite_shader_, tex_[6]));
-            bullets_.back()->SetScale(.25);
-            bullets_.back()->SetVelocity(0.03f * player_->GetBearing());
-            bullets_.back()->SetRotation( player_->GetRotation() - (glm::pi<float>() / 2.0f) );
-            bullets_.back()->SetTimer(2);
-            bullet_timer_->Start(1);
-
-            //std::cout << atan2( bullets_.back()->GetVelocity().y, bullets_.back()->GetVelocity().x ) << std::endl;
-            //bullets_.back()->GetPosition()
-            GameObject *particles = new ParticleSystem(glm::vec3(0,0,0), bullet_particles_, &particle_shader_, tex_[6], bullets_.back());
-            particles->SetScale(0.2);
-            particle_game_objects_.push_back(particles); 
+            FireBullet(player_->GetRotation());
+            bullet_timer_.Start(1);
         }
     }
-    if (glfwGetKey(window_, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
+    if (input & INPUT_MINE)
     {
-        if (bullet_timer_->Finished() != 0)
+        ProjectileGameObject *spike = NULL;
+        if (bullet_timer_.Finished() != 0)
         {
-            spikes_.push_back(new ProjectileGameObject(glm::vec3(player_->GetPosition().x, player_->GetPosition().y, 0.0f), sprite_, &sprite_shader_, tex_[20]));
-            spikes_.back()->SetScale(.5);
-            spikes_.back()->SetVelocity(-0.001f * player_->GetBearing());
-            //spikes_.back()->SetRotation( player_->GetRotation() - (glm::pi<float>() / 2.0f) );
-            spikes_.back()->SetTimer(2);
-            bullet_timer_->Start(3);
+            spike = spike_pool_.Acquire(glm::vec3(player_->GetPosition().x, player_->GetPosition().y, 0.0f), sprite_, &sprite_shader_, tex_[20]);
+        }
+        if (spike)
+        {
+            spike->SetScale(.5);
+            spike->SetVelocity(-0.001f * player_->GetBearing());
+            //spike->SetRotation( player_->GetRotation() - (glm::pi<float>() / 2.0f) );
+            spike->SetTimer(2);
+            spikes_.Add(spike);
+            bullet_timer_.Start(3);
         }
     }
 
@@ -415,76 +841,54 @@ void Game::HandleControls(double delta_time)
 
 void Game::Update(double delta_time)
 {
+    PROFILE_ZONE("Update");
 
     // Update time
     current_time_ += delta_time;
 
+    phase_timer_.Begin("explosions");
+
     // Update all other game objects (for now just explosions)
-    for (int i = 0; i < explosions_.size(); i++) {
-        // Get the current game object
-        GameObject* current_game_object = explosions_[i];
+    // each object only touches itself, so the updates are shared out across threads
+    jobs_->ParallelFor(explosions_.GetSize(), update_grain_g, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) explosions_[i]->Update(delta_time);
+    });
 
-        // Update the current game object
-        //std::cout << i << std::endl;
-        current_game_object->Update(delta_time);
+    for (int i = 0; i < explosions_.GetSize(); i++) {
+        // Get the current game object
+        ParticleSystem* current_game_object = explosions_[i];
 
         //std::cout << i << " is inactive" << std::endl;
         //if the explosion is active and the timer is finished then we can proceed in removing the object, otherwise we continue on as normal.
         if (current_game_object->GetTimer() == 1)
         {
-            // we added a temporary game object as the parent for the explosions so were gonna get rid of the memory we used before deleting the expolsion
-            GameObject* temp;
-            explosions_[i]->GetParent(&temp);
-            delete temp;
-
             //std::cout << "another explosion fades away..." << std::endl;
-            // free the space from the object list and remove it
-            delete explosions_[i];
-            explosions_.erase(explosions_.begin()+i);
+            // remove it from the list, its freed at the end of the tick
+            explosions_.DestroyAt(i);
 
             num_enemies_ --;
         }
            
     }
 
-    if (boss_ && enemy_game_objects_.size() == 0) return;
+    if (IsWon())
+    {
+        FlushDestroyed();
+        phase_timer_.End();
+        return;
+    }
 
     // if the player is dead then we want to start moving towards the shut down state
     if (player_health_ == 0)
     {
         // if the explosion vector is empty it means that they have all resolved and we can shut the game down now
-        if (explosions_.size() == 0)
+        // the destructor frees everything once the main loop stops
+        if (explosions_.GetSize() == 0 && !game_over_)
         {
-            // Free memory for all objects
-            // Only need to delete objects that are not automatically freed
             std::cout << "Game Over!" << std::endl;
-            
-            delete sprite_;
-            
-            delete background_tile_;
-            
-
-            for (int i = 0; i < enemy_game_objects_.size(); i++)
-            {
-                delete enemy_game_objects_[i];
-            }
+            game_over_ = true;
 
-            for (int i = 0; i < collectible_game_objects_.size(); i++)
-            {
-                delete collectible_game_objects_[i];
-            }
-
-            for (int i = 0; i < particle_game_objects_.size(); i++)
-            {
-                delete particle_game_objects_[i];
-            }
-
-            delete enemy_timer_;
-            delete buff_timer_;
-
-            // Close window
-            glfwDestroyWindow(window_);
-            glfwTerminate();            
+            if (window_) glfwSetWindowShouldClose(window_, true);
         }/**/ 
         else
         {
@@ -492,457 +896,1060 @@ void Game::Update(double delta_time)
         }   
     }
     
-    if (score_ >= 25 && !boss_)
-    {
-        enemy_game_objects_.push_back(new EnemyGameObject( player_->GetPosition() + glm::vec3(6.0f,0.0f,0.0f), sprite_, &sprite_shader_, tex_[22], 15, 1));
-        
-        /*
-        child_game_objects_.push_back(new ChildGameObject (enemy_game_objects_.back()->GetPosition(), sprite_, &sprite_shader_, tex_[23], enemy_game_objects_.back()) );
-        child_game_objects_.back()->SetRotation((glm::pi<float>() / 2.0f) );
-        child_game_objects_.back()->SetScale(0.5);
-        child_game_objects_.push_back(new ChildGameObject (child_game_objects_.back()->GetPosition(), sprite_, &sprite_shader_, tex_[23], child_game_objects_.back()) );
-        child_game_objects_.back()->SetRotation((glm::pi<float>() / 1.0f) );
-        child_game_objects_.back()->SetScale(0.5);
-        child_game_objects_.push_back(new ChildGameObject (child_game_objects_.back()->GetPosition(), sprite_, &sprite_shader_, tex_[23], child_game_objects_.back()) );
-        child_game_objects_.back()->SetRotation((glm::pi<float>() / 3.0f) );
-        child_game_objects_.back()->SetScale(0.5);*/
+    phase_timer_.Begin("spawning");
 
-        boss_ = true;
+    // a stress scenario replaces the normal spawning (and never brings out the boss)
+    if (stress_)
+    {
+        FillScenario();
     }
 
-    // handling enemy spawning (same as the buff spawner below)
-    if (num_enemies_ < 5 && player_health_ > 0 && score_ < 25)
+    if (score_ >= 25 && !boss_ && !stress_)
     {
-        if (enemy_timer_->Finished() == 1 && score_ + enemy_game_objects_.size() < 25)
-        {
-            while(true)
-            {
-                float x = static_cast <float> (rand()) / (static_cast <float> (RAND_MAX/10.0f)) - 5.0f;
-                float y = static_cast <float> (rand()) / (static_cast <float> (RAND_MAX/10.0f)) - 5.0f;
+        EnemyGameObject *boss = SpawnEnemy(player_->GetPosition() + glm::vec3(6.0f,0.0f,0.0f), tex_[22], 15, 1);
 
-                if (! ( player_->GetPosition().x + 2.0f > x && player_->GetPosition().x - 2.0f < x ) && ! ( player_->GetPosition().y + 2.0f > y && player_->GetPosition().y - 2.0f < y ) )
-                {
-                    
-                    if (score_ > 10)
-                    {
-                        if ( rand() / (RAND_MAX / 5) < 3 )
-                        {
-                            enemy_game_objects_.push_back( new EnemyGameObject(glm::vec3(x, y, 0.0f), sprite_, &sprite_shader_, tex_[5], 3, 1) );
-                            num_enemies_ ++;
-                        }
-                        else
-                        {
-                            enemy_game_objects_.push_back( new EnemyGameObject(glm::vec3(x, y, 0.0f), sprite_, &sprite_shader_, tex_[1] ) );
-                            num_enemies_ ++;
-                        }
-                    }
-                    else
-                    {
-                        enemy_game_objects_.push_back( new EnemyGameObject(glm::vec3(x, y, 0.0f), sprite_, &sprite_shader_, tex_[1] ) );
-                        num_enemies_ ++;
-                    }
-                    
-                    break;
-                }
-            }
-        }
-        else if (enemy_timer_->Finished() == 2)
+        // the kraken comes with its tentacles, which reach for the player
+        if (boss)
         {
-            enemy_timer_->Start(5);
+            boss_handle_ = enemy_game_objects_.GetHandle(enemy_game_objects_.GetSize() - 1);
+            SpawnTentacles(boss->GetPosition());
         }
+
+        boss_ = true;
     }
 
-    //handling buff spawning, for now well make sure that we hover around 3 buffs at once
-    if (num_buffs_ < 5 && player_health_ > 0)
+    // the spawn director queues up the waves that are due and hands out a few spawns a tick, each on one of its spawn points round the player
+    if (player_health_ > 0 && !stress_)
     {
-        // if the timers done then we can continue
-        if (buff_timer_->Finished() == 1)
+        spawn_director_.Update(delta_time, score_, num_enemies_, num_buffs_);
+
+        Random &spawn = random_->Get(RandomStreams::SPAWN);
+        Spawn next;
+        while (spawn_director_.Next(player_->GetPosition(), spawn, next))
         {
-            // were gonna loop around until we get a value that satifies our conditions
-            while(true)
+            if (next.kind == SpawnWave::BUFF)
             {
-                // randomly generate an x and y value for the entity
-                float x = static_cast <float> (rand()) / (static_cast <float> (RAND_MAX/8.0f)) - 4.0f;
-                float y = static_cast <float> (rand()) / (static_cast <float> (RAND_MAX/8.0f)) - 4.0f;
-
-                // if its not too close to the player we can accept the spawn ( this is pretty inneficien however its not very likely this will cause any large scale lag on this scale)
-                if (! ( player_->GetPosition().x + 1.0f > x && player_->GetPosition().x - 1.0f < x ) && ! ( player_->GetPosition().y + 1.0f > y && player_->GetPosition().y - 1.0f < y ) )
+                CollectibleGameObject *buff = SpawnCollectible(next.position, tex_[8], 0);
+                if (buff)
                 {
-                    // add a new entity to the list and increment the counter
-                    collectible_game_objects_.push_back( new CollectibleGameObject(glm::vec3(x, y, 0.0f), sprite_, &sprite_shader_, tex_[8]));
-                    collectible_game_objects_.back()->SetScale(0.5);
-                    //collectible_game_objects_.back()->SetRotation(glm::pi<float>() / 2.0f);
+                    buff->SetScale(0.5);
+                    //buff->SetRotation(glm::pi<float>() / 2.0f);
                     num_buffs_ ++;
-                    break;
                 }
             }
-        }
-        else if (buff_timer_->Finished() == 2)
-        {
-            buff_timer_->Start(5);
+            else if (next.tough)
+            {
+                if (SpawnEnemy(next.position, tex_[5], 3, 1)) num_enemies_ ++;
+            }
+            else
+            {
+                if (SpawnEnemy(next.position, tex_[1])) num_enemies_ ++;
+            }
         }
     }
     
+    phase_timer_.Begin("objects");
+
     // update the player since we not check for player player collision
     if (player_health_ > 0) 
     {
         player_->Update(delta_time);
     }
 
-    //
-    for (int i = 0; i < particle_game_objects_.size(); i++)
+    // bullet trails, a trail whose bullet is gone goes with it
+    for (int i = 0; i < particle_game_objects_.GetSize(); i++)
     {
-        particle_game_objects_[i]->Update(delta_time);
+        if (particle_game_objects_[i]->IsOrphaned()) particle_game_objects_.DestroyAt(i);
     }
 
+    jobs_->ParallelFor(particle_game_objects_.GetSize(), update_grain_g, [&](int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            if (!particle_game_objects_.IsDestroyed(i)) particle_game_objects_[i]->Update(delta_time);
+        }
+    });
+
     // update the player since we not check for player player collision
     background_tile_->Update(delta_time);
     
-    for (int i = 0; i < child_game_objects_.size(); i++)
+    for (int i = 0; i < child_game_objects_.GetSize(); i++)
     {
-        child_game_objects_[i]->Update(delta_time);
+        if (child_game_objects_[i]->IsOrphaned()) child_game_objects_.DestroyAt(i);
     }
 
-    // update all enemy game objects
-    for (int i = 0; i < enemy_game_objects_.size(); i++) 
-    {
-        // Get the current game object
-        EnemyGameObject* current_game_object = enemy_game_objects_[i];
-
-        // Update the current game object
-        //std::cout << i << std::endl;
-        current_game_object->Update(delta_time);
-        
+    // a child only moves relative to its parent and the transform store puts them together when drawing, so they can all move at once
+    jobs_->ParallelFor(child_game_objects_.GetSize(), update_grain_g, [&](int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            if (!child_game_objects_.IsDestroyed(i)) child_game_objects_[i]->Update(delta_time);
+        }
+    });
 
-        float distance = glm::length(current_game_object->GetPosition() - player_->GetPosition());
+    phase_timer_.Begin("pursuit");
 
-        // check if we get close to an enemy, if so we wanna set it to patrolling, give it its first tagert
-        if (distance < 1.8f && player_health_ > 0)
+    // point the flow field at the player, round the kraken and its tentacles where they were left last tick
+    // the field only repairs the cells the player, the grid or the tentacles moved off or onto since the last update
+    {
+        PROFILE_ZONE("flow field");
+        flow_field_.ClearObstacles();
+        EnemyGameObject *boss = enemy_game_objects_.Get(boss_handle_);
+        if (boss)
         {
-            // if we get close enough we wanna set it to patrolling and if the object is patrolling we wanna
-            if (enemy_game_objects_[i]->GetState() == 0)
+            flow_field_.AddObstacle(boss->GetPosition(), kraken_body_radius_g);
+            for (int c = 0; c < tentacles_.GetChainCount(); c++)
             {
-                enemy_game_objects_[i]->SetTarget(player_->GetPosition());
+                for (int s = 0; s < tentacles_.GetSegmentCount(c); s++)
+                {
+                    glm::vec3 middle = 0.5f * (tentacles_.GetJoint(c, s) + tentacles_.GetJoint(c, s + 1));
+                    flow_field_.AddObstacle(middle, 0.5f * tentacles_.GetLength(c, s) + tentacle_obstacle_margin_g);
+                }
             }
-        }/**/
-
-        // if the entity is intercepting we wanna update the target if its timer is done
-        if ( enemy_game_objects_[i]->GetState() == 1 && enemy_game_objects_[i]->GetTimer() == 1)
+        }
+        flow_field_.Update(player_->GetPosition());
+    }
+
+    phase_timer_.Begin("enemies");
+
+    // update all enemy game objects, the intercepting ones steering along the flow field first (sampling it only reads)
+    // except the kraken, which is one of the obstacles and just heads straight for the player
+    // the further a patrolling enemy is from the player the fewer ticks it updates on: its patrol only depends on the
+    // time, so when it does update it lands exactly where updating every tick would have put it, but in between the
+    // collision checks (and the renderer, though it's well off screen by then) see it where it last updated
+    lod_.BeginTick(player_->GetPosition(), tick_count_);
+    jobs_->ParallelFor(enemy_game_objects_.GetSize(), update_grain_g, [&](int begin, int end) {
+        int updated[LodScheduler::NUM_TIERS] = {};
+        int skipped[LodScheduler::NUM_TIERS] = {};
+        for (int i = begin; i < end; i++)
         {
-            enemy_game_objects_[i]->SetTarget(player_->GetPosition());
+            EnemyGameObject *enemy = enemy_game_objects_[i];
+
+            // the boss drags its tentacles round every tick, and intercepting enemies steer and retarget every tick,
+            // so none of them ever drop a tier
+            bool boss = enemy_game_objects_.GetHandle(i) == boss_handle_;
+            bool full_rate = enemy->GetState() == INTERCEPTING || boss;
+            int tier = full_rate ? 0 : lod_.Tier(enemy->GetPosition());
+            if (!lod_.IsDue(tier, enemy->GetLodSlot()))
+            {
+                enemy->SkipTick();
+                skipped[tier]++;
+                continue;
+            }
+
+            if (enemy->GetState() == INTERCEPTING && !boss) enemy->Steer(flow_field_.Sample(enemy->GetPosition()));
+            enemy->Update(delta_time);
+            updated[tier]++;
         }
+        lod_.Count(updated, skipped);
+    });
+
+    // retargeting restarts timers, which the timer service has to do one at a time
+    for (int i = 0; i < enemy_game_objects_.GetSize(); i++) 
+    {
+        // Get the current game object
+        EnemyGameObject* current_game_object = enemy_game_objects_[i];
 
-        // If distance is below a threshold, we have a collision
-        if (distance < 0.8f && player_health_ > 0 && enemy_game_objects_[i]->GetHitTimer() != 0)
+        // if the entity is intercepting we wanna update the target if its timer is done
+        // (only if it updated this tick, so it never aims from somewhere it hasnt caught up from yet)
+        if ( current_game_object->GetState() == 1 && current_game_object->GetTimer() == 1 && current_game_object->GetSkippedTicks() == 0)
         {
-            
-            //std::cout << "Contact!" << std::endl;
-            
-            //here were just getting the position of the object we wanna blow up
-            glm::vec3 pos = current_game_object->GetPosition();
+            current_game_object->SetTarget(player_->GetPosition());
+        }
+    }
 
-            if (enemy_game_objects_[i]->GetHealth() == 1)
-            {
-                int r = rand() / (RAND_MAX / 5);
-                if ( r == 2 )
-                {
-                    collectible_game_objects_.push_back(new CollectibleGameObject(pos, sprite_, &sprite_shader_, tex_[2], 1) );
-                }
-                else if (r == 1)
-                {
-                    collectible_game_objects_.push_back(new CollectibleGameObject(pos, sprite_, &sprite_shader_, tex_[21], 2));
-                }
-                
+    // now that the enemies have moved, sort them into the broadphase grid that all the collision checks below use
+    // the collision checks only read the game and emit commands, which ApplyCommands() carries out after the last one
+    enemy_grid_.Clear();
+    for (int i = 0; i < enemy_game_objects_.GetSize(); i++)
+    {
+        enemy_grid_.Insert(i, enemy_game_objects_[i]->GetPosition());
+    }
+    enemy_grid_.Build();
+
+    // the player's power up makes every hit count twice
+    int damage = (player_->GetTimer(0) == 0) ? 2 : 1;
 
-                // we them blow it up metaphorically by deleting it (dont wanna waste space)
-                delete current_game_object;
-                enemy_game_objects_.erase(enemy_game_objects_.begin() + i);
+    if (player_health_ > 0)
+    {
+        PROFILE_ZONE("contact collisions");
 
-                // we then replace the object with an explosion, set the explosion to false so that we dont accidentally blow up the explosion (that would be weird), and set a timer for how long itll stay on screen
-                //pos
-                GameObject *particles = new ParticleSystem(glm::vec3(0,0,0), explosion_particles_, &particle_shader_, tex_[4], new GameObject(pos, sprite_, &sprite_shader_, tex_[4]));
-                particles->SetScale(0.2);
-                particles->SetTimer(1.0f);
-                explosions_.push_back(particles); 
+        // only enemies close enough to notice the player can possibly touch it
+        CollisionScratch &scratch = scratch_[0];
+        scratch.nearby.clear();
+        enemy_grid_.QueryRadius(player_->GetPosition(), 1.8f, scratch.nearby);
+        std::sort(scratch.nearby.begin(), scratch.nearby.end());
 
-                // and next were gonna play a nom sound cause he ate that thang
-                if (! am.SoundIsPlaying(explosion_index_) ) am.PlaySound(explosion_index_);
+        // the player can only lose the health it has, so stop once these contacts would finish it off
+        int health = player_health_;
 
-                score_++;
-            }
-            else
+        for (int n = 0; n < scratch.nearby.size() && health > 0; n++)
+        {
+            int i = scratch.nearby[n];
+            EnemyGameObject* current_game_object = enemy_game_objects_[i];
+
+            float distance = glm::length(current_game_object->GetPosition() - player_->GetPosition());
+
+            // we got close to an enemy, if its patrolling we wanna start it intercepting with the player as its first target
+            // (this is steering rather than a collision, so it happens straight away)
+            if (current_game_object->GetState() == 0)
             {
-                enemy_game_objects_[i]->Hit();
-                if (player_->GetTimer() == 0) enemy_game_objects_[i]->Hit();
-                enemy_game_objects_[i]->SetHitTimer();
+                current_game_object->SetTarget(player_->GetPosition());
             }
 
-            // player hit another object so were gonna take 1 health away
-            player_->SetTexture(tex_[0]);
-            player_health_ -= 1;
-            
-            // same as above but for the player if we hit 3 enemies
-            if (player_health_ == 0)
+            // If distance is below a threshold, we have a collision
+            if (distance < 0.8f && current_game_object->GetHitTimer() != 0)
             {
-                glm::vec3 pos = player_->GetPosition();
+                //std::cout << "Contact!" << std::endl;
+                unsigned int order = CommandBuffer::Order(contact_pass_g, i);
 
-                delete player_;
+                // the enemy takes the hit, and if it blows up were gonna play a nom sound cause he ate that thang
+                commands_.Emit(0, order, Command::Damage(Command::ENEMY, i, damage, Command::CONTACT));
 
-                //pos
-                GameObject *particles = new ParticleSystem(glm::vec3(0,0,0), explosion_particles_, &particle_shader_, tex_[4], new GameObject(pos, sprite_, &sprite_shader_, tex_[4]));
-                particles->SetScale(0.2);
-                particles->SetTimer(1.0f);
-                explosions_.push_back(particles); 
+                // player hit another object so were gonna take 1 health away
+                commands_.Emit(0, order, Command::Damage(Command::PLAYER, 0, 1));
+                health--;
             }
-            
-            // restart from the beginning since we shrunk the enemy vector by 1 after the collision
-            i--;
+        }
+    }
 
-            if (i < 0) goto endloop;
+    phase_timer_.Begin("tentacles");
 
-            continue;
-        }
+    {
+        PROFILE_ZONE("tentacles");
+        UpdateTentacles();
     }
 
+    phase_timer_.Begin("collectibles");
+
     // update all collectible game objects
-    for (int i = 0; i < collectible_game_objects_.size(); i++) 
-    {
-        // Get the current game object
-        CollectibleGameObject* current_game_object = collectible_game_objects_[i];
+    jobs_->ParallelFor(collectible_game_objects_.GetSize(), update_grain_g, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) collectible_game_objects_[i]->Update(delta_time);
+    });
 
-        // Update the current game object
-        //std::cout << i << std::endl;
-        current_game_object->Update(delta_time);
+    if (player_health_ > 0)
+    {
+        PROFILE_ZONE("pickup collisions");
 
+        collectible_grid_.Clear();
+        for (int i = 0; i < collectible_game_objects_.GetSize(); i++)
+        {
+            collectible_grid_.Insert(i, collectible_game_objects_[i]->GetPosition());
+        }
+        collectible_grid_.Build();
 
-        float distance = glm::length(current_game_object->GetPosition() - player_->GetPosition());
         // check if we contacted a collectible
-        if (distance < 0.6f && player_health_ > 0)
+        CollisionScratch &scratch = scratch_[0];
+        scratch.nearby.clear();
+        collectible_grid_.QueryRadius(player_->GetPosition(), 0.6f, scratch.nearby);
+
+        for (int n = 0; n < scratch.nearby.size(); n++)
         {
-            // were gonna get rid of the object first since we dont need it anymore
+            int i = scratch.nearby[n];
+            commands_.Emit(0, CommandBuffer::Order(pickup_pass_g, i), Command::Collect(i));
+        }
+    }
+
+    phase_timer_.Begin("bullets");
 
-            if (collectible_game_objects_[i]->GetType() == 0)
+    // each bullet only moves itself and reads the enemies, so the bullets are shared out across threads
+    {
+        PROFILE_ZONE("bullet collisions");
+
+        jobs_->ParallelFor(bullets_.GetSize(), collision_grain_g, [&](int begin, int end) {
+            int thread = jobs_->GetThreadIndex();
+            CollisionScratch &scratch = scratch_[thread];
+            PROFILE_ZONE("bullet batch");
+
+            for (int i = begin; i < end; i++)
             {
-                // were gonna change the values for 
-                num_buffs_ --;
-                buff_count_++;
+                bullets_[i]->Update(delta_time);
 
-                // if the number of buffs weve collected is greater than or equal to 5 were gonna go into gold mode
-                if (buff_count_ >= 5)
+                // the bullet hits whichever enemy it reaches first, and is used up if it hit something or once its timer has run out
+                // its trail notices the bullet is gone next tick
+                unsigned int order = CommandBuffer::Order(bullet_pass_g, i);
+                int target = FindBulletHit(bullets_[i]->GetPosition(), bullets_[i]->GetVelocity(), enemy_grid_, enemy_game_objects_, scratch);
+                if (target >= 0)
                 {
-                    // set the timer on the power up
-                    player_->SetTimer(10.0f);
-                    // reset the buff count so we dont chain power ups
-                    buff_count_ = 0;
+                    commands_.Emit(thread, order, Command::Damage(Command::ENEMY, target, damage));
+                    commands_.Emit(thread, order, Command::PlaySound(explosion_index_));
+                    commands_.Emit(thread, order, Command::Kill(Command::BULLET, i));
+                }
+                else if (bullets_[i]->GetTimer() == 2)
+                {
+                    commands_.Emit(thread, order, Command::Kill(Command::BULLET, i));
                 }
             }
-            else if (collectible_game_objects_[i]->GetType() == 1 && player_health_ < 3)
-            {
-                player_health_++;
-            }
-            else if (collectible_game_objects_[i]->GetType() == 2)
+        });
+    }
+
+    phase_timer_.Begin("spikes");
+
+    {
+        PROFILE_ZONE("spike collisions");
+
+        jobs_->ParallelFor(spikes_.GetSize(), collision_grain_g, [&](int begin, int end) {
+            int thread = jobs_->GetThreadIndex();
+            CollisionScratch &scratch = scratch_[thread];
+            PROFILE_ZONE("spike batch");
+
+            for (int i = begin; i < end; i++)
             {
-                score_++;
+                spikes_[i]->Update(delta_time);
+
+                int j = FindSpikeHit(spikes_[i]->GetPosition(), enemy_grid_, scratch);
+
+                unsigned int order = CommandBuffer::Order(spike_pass_g, i);
+                if (j >= 0)
+                {
+                    commands_.Emit(thread, order, Command::Damage(Command::ENEMY, j, damage));
+                    commands_.Emit(thread, order, Command::Kill(Command::SPIKE, i));
+                    commands_.Emit(thread, order, Command::PlaySound(explosion_index_));
+                }
+                else if ( spikes_[i]->GetTimer() == 2 )
+                {
+                    commands_.Emit(thread, order, Command::Kill(Command::SPIKE, i));
+                }
             }
+        });
+    }
 
-            delete current_game_object;
-            collectible_game_objects_.erase(collectible_game_objects_.begin()+i);
-            // were gonna move back to the same i since everything after the object we just deleted shifted down one (i+1 is now just i) and we wouldnt wanna miss any collision
-            i--;
-        }
+    phase_timer_.Begin("commands");
+
+    ApplyCommands();
+
+    phase_timer_.Begin("hud");
+
+    glm::vec3 pos = player_->GetPosition();
+    for (int i = 0; i < health_objects_.size(); i++)
+    {
+        health_objects_[i]->SetPosition( glm::vec3(pos.x - 5.0f + (0.5f * i), pos.y + 3.5f, 0.0f ) );
     }
 
-    for (int i = 0; i < bullets_.size(); i++)
+    for (int i = ui_objects_.size()-1; i >= 0; i--)
     {
-        bullets_[i]->Update(delta_time);
+        ui_objects_[i]->SetPosition( glm::vec3(pos.x + 0.5f - (0.5f * i), pos.y + 3.5f, 0.0f ) );
+        ui_objects_[i]->SetTexture(tex_[(score_ / static_cast<int> ( pow(10, i) ) ) % 10 + 10]);
+    }
 
-        for (int j = 0; j < enemy_game_objects_.size(); j++)
-        {
-            glm::vec3 d = bullets_[i]->GetVelocity();
+    if (player_->GetTimer(0) == 0)
+    {
+        timer_objects_[0]->SetPosition( glm::vec3(pos.x + 4.5f, pos.y + 3.5f, 0.0f ) );
+        timer_objects_[1]->SetPosition( glm::vec3(pos.x + 5.0f, pos.y + 3.5f, 0.0f ) );
+        timer_objects_[1]->SetTexture(tex_[static_cast<int> ( player_->GetTimerTime() )  % 10 + 10]);
+    }
+
+    FlushDestroyed();
+
+    phase_timer_.Begin("streaming");
+
+    StreamChunks();
+
+    phase_timer_.End();
+
+    // only made the once, Update stops early from here on
+    if (IsWon() && !end_screen_) 
+    {
+        end_screen_ = new GameObject(player_->GetPosition(), sprite_, &sprite_shader_, tex_[25]);
+        end_screen_->SetScale(10);
+        player_->SetVelocity(glm::vec3(0,0,0));
+    }
+}
 
-            // vector for the line between the start of the bullets path and the centre of the circle
-            glm::vec3 sc = bullets_[i]->GetPosition() - enemy_game_objects_[j]->GetPosition();
 
-            double time = bullets_[i]->GetTime();
+void Game::ApplyCommands(void)
+{
+    const std::vector<Command> &commands = commands_.Merge();
+    for (int i = 0; i < commands.size(); i++)
+    {
+        ApplyCommand(commands[i]);
+    }
+    commands_.Clear();
+}
+
+
+void Game::ApplyCommand(const Command &command)
+{
+    switch (command.type)
+    {
+        case Command::KILL:
+            if (command.target == Command::ENEMY && !enemy_game_objects_.IsDestroyed(command.index))
+            {
+                glm::vec3 pos = enemy_game_objects_[command.index]->GetPosition();
 
-            //std::cout << j << ": sc = ()" << sc.x << ", " << sc.y << "), d = (" << d.x * time << ", " << d.y * time << ")" << std::endl;
+                // roll for a drop, and replace the object with an explosion
+                ApplyCommand(Command::SpawnDrop(pos));
+                ApplyCommand(Command::SpawnEffect(pos));
 
-            double a = glm::dot(d, d);
-            double b = 2 * glm::dot(d, sc);
-            double c = glm::dot(sc, sc) - 0.1f;
+                // the tentacles go with the kraken
+                if (enemy_game_objects_.GetHandle(command.index) == boss_handle_) ClearTentacles();
 
-            float disc = pow(b, 2) - 4 * a * c;
+                // the enemy itself stays in the map until the end of the tick, other commands still refer to it by index
+                enemy_game_objects_.DestroyAt(command.index);
 
-            if (disc >= 0)
+                ApplyCommand(Command::AddScore(1));
+            }
+            else if (command.target == Command::COLLECTIBLE)
+            {
+                collectible_game_objects_.DestroyAt(command.index);
+            }
+            else if (command.target == Command::BULLET)
+            {
+                bullets_.DestroyAt(command.index);
+            }
+            else if (command.target == Command::SPIKE)
             {
-                disc = sqrt(disc);
+                spikes_.DestroyAt(command.index);
+            }
+            break;
 
-                float t1 = ((-b) - disc) / (2 * a);
-                float t2 = ((-b) + disc) / (2 * a);
+        case Command::DAMAGE:
+            if (command.target == Command::PLAYER && player_health_ > 0 && !(stress_ && scenario_.invincible))
+            {
+                player_->SetTexture(tex_[0]);
+                player_health_ -= command.amount;
+                if (player_health_ < 0) player_health_ = 0;
 
-                //std::cout << j << ": t1 = " << t1 << ", t2 =  " << t2 << std::endl;
+                // same as an enemy but for the player if we hit 3 enemies
+                // the player object sticks around (the destructor frees it) since the camera and hud still read its position
+                if (player_health_ == 0)
+                {
+                    ApplyCommand(Command::SpawnEffect(player_->GetPosition()));
+                }
+            }
+            else if (command.target == Command::ENEMY && !enemy_game_objects_.IsDestroyed(command.index))
+            {
+                // something earlier this tick may have already killed it, then theres nothing left to hit
+                EnemyGameObject *enemy = enemy_game_objects_[command.index];
 
-                if(t1 <= 0 && t2 >= 1)
+                if (enemy->GetHealth() <= 1)
                 {
-                    if (enemy_game_objects_[j]->GetHealth() <= 1)
-                    {
-                        int r = rand() / (RAND_MAX / 5);
-                        if ( r == 2 )
-                        {
-                            collectible_game_objects_.push_back(new CollectibleGameObject(enemy_game_objects_[j]->GetPosition(), sprite_, &sprite_shader_, tex_[2], 1));
-                        }
-                        else if (r == 1)
-                        {
-                            collectible_game_objects_.push_back(new CollectibleGameObject(enemy_game_objects_[j]->GetPosition(), sprite_, &sprite_shader_, tex_[21], 2));
-                        }
-
-                        //enemy_game_objects_[j]->GetPosition()
-                        GameObject *particles = new ParticleSystem(glm::vec3(0,0,0), explosion_particles_, &particle_shader_, tex_[4], new GameObject(enemy_game_objects_[j]->GetPosition(), sprite_, &sprite_shader_, tex_[4]));
-                        particles->SetScale(0.2);
-                        particles->SetTimer(1.0f);
-                        explosions_.push_back(particles); 
-
-                        delete enemy_game_objects_[j];
-                        enemy_game_objects_.erase(enemy_game_objects_.begin()+j);
-
-                        score_++;
-                    }
-                    else
-                    {
-                        enemy_game_objects_[j]->Hit();
-                        if (player_->GetTimer() == 0) enemy_game_objects_[j]->Hit();
-                    }
-                    
+                    ApplyCommand(Command::Kill(Command::ENEMY, command.index));
+                    if (command.flags & Command::CONTACT) PlaySound(explosion_index_);
+                }
+                else
+                {
+                    for (int n = 0; n < command.amount; n++) enemy->Hit();
+                    if (command.flags & Command::CONTACT) enemy->SetHitTimer();
+                }
+            }
+            break;
 
-                    delete bullets_[i];
-                    bullets_.erase(bullets_.begin()+i);
+        case Command::COLLECT:
+            // nothing gets picked up once the player is dead, even if it died earlier this tick
+            if (player_health_ > 0 && !collectible_game_objects_.IsDestroyed(command.index))
+            {
+                CollectibleGameObject* current_game_object = collectible_game_objects_[command.index];
 
-                    delete particle_game_objects_[0];
-                    particle_game_objects_.erase(particle_game_objects_.begin());
+                if (current_game_object->GetType() == 0)
+                {
+                    // were gonna change the values for 
+                    num_buffs_ --;
+                    buff_count_++;
 
-                    if (! am.SoundIsPlaying(explosion_index_) ) am.PlaySound(explosion_index_);
+                    // if the number of buffs weve collected is greater than or equal to 5 were gonna go into gold mode
+                    if (buff_count_ >= 5)
+                    {
+                        // set the timer on the power up
+                        player_->SetTimer(10.0f);
+                        // reset the buff count so we dont chain power ups
+                        buff_count_ = 0;
+                    }
+                }
+                else if (current_game_object->GetType() == 1 && player_health_ < 3)
+                {
+                    player_health_++;
+                }
+                else if (current_game_object->GetType() == 2)
+                {
+                    score_++;
+                }
 
-                    i--;
+                // were gonna get rid of the object since we dont need it anymore
+                collectible_game_objects_.DestroyAt(command.index);
+            }
+            break;
 
-                    if (i < 0) goto endloop;
-                    break;
-                }
+        case Command::SPAWN_DROP:
+        {
+            // one in five chance of a health apple and one in five of gold
+            int r = random_->Get(RandomStreams::LOOT).Below(5);
+            if ( r == 2 )
+            {
+                SpawnCollectible(command.position, tex_[2], 1);
             }
+            else if (r == 1)
+            {
+                SpawnCollectible(command.position, tex_[21], 2);
+            }
+            break;
         }
 
-        if ( bullets_[i]->GetTimer() == 2 )
-        {
-            delete bullets_[i];
-            bullets_.erase(bullets_.begin()+i);
+        case Command::SPAWN_EFFECT:
+            SpawnExplosion(command.position);
+            break;
 
-            delete particle_game_objects_[0];
-            particle_game_objects_.erase(particle_game_objects_.begin());
+        case Command::PLAY_SOUND:
+            PlaySound(command.amount);
+            break;
 
-            i--;
-            if (i < 0) goto endloop;
+        case Command::ADD_SCORE:
+            score_ += command.amount;
             break;
-        }
     }
+}
+
+
+EnemyGameObject *Game::SpawnEnemy(const glm::vec3 &position, GLuint texture, int health, int state)
+{
+    EnemyGameObject *enemy = enemy_pool_.Acquire(position, sprite_, &sprite_shader_, texture, health, state);
+    if (enemy) enemy_game_objects_.Add(enemy);
+    return enemy;
+}
+
+
+CollectibleGameObject *Game::SpawnCollectible(const glm::vec3 &position, GLuint texture, int type)
+{
+    CollectibleGameObject *collectible = collectible_pool_.Acquire(position, sprite_, &sprite_shader_, texture, type);
+    if (collectible) collectible_game_objects_.Add(collectible);
+    return collectible;
+}
+
+
+void Game::SpawnExplosion(const glm::vec3 &position)
+{
+    // set a timer for how long itll stay on screen, if we're out of explosions this one just doesnt show
+    ParticleSystem *particles = explosion_pool_.Acquire(position, explosion_particles_, &particle_shader_, tex_[4]);
+    if (!particles) return;
+
+    particles->SetScale(0.2);
+    particles->SetTimer(1.0f);
+    explosions_.Add(particles);
+}
+
+
+void Game::FireBullet(float rotation)
+{
+    ProjectileGameObject *bullet = bullet_pool_.Acquire(glm::vec3(player_->GetPosition().x, player_->GetPosition().y, 0.0f), sprite_, &sprite_shader_, tex_[6]);
+    if (!bullet) return;
+
+    bullet->SetScale(.25);
+    bullet->SetVelocity(0.03f * glm::vec3(cos(rotation), sin(rotation), 0.0f));
+    bullet->SetRotation( rotation - (glm::pi<float>() / 2.0f) );
+    bullet->SetTimer(2);
+    EntityHandle bullet_handle = bullets_.Add(bullet);
+
+    //std::cout << atan2( bullet->GetVelocity().y, bullet->GetVelocity().x ) << std::endl;
+    // the trail follows the bullet by handle, and goes away once the bullet does
+    ParticleSystem *particles = trail_pool_.Acquire(glm::vec3(0,0,0), bullet_particles_, &particle_shader_, tex_[6], &bullets_, bullet_handle);
+    if (particles)
+    {
+        particles->SetScale(0.2);
+        particle_game_objects_.Add(particles); 
+    }
+}
+
 
-    for (int i = 0; i < spikes_.size(); i++)
+void Game::SpawnTentacles(const glm::vec3 &position)
+{
+    // spread evenly round the kraken, each lying straight out to start with
+    for (int c = 0; c < tentacle_count_g; c++)
     {
-        spikes_[i]->Update(delta_time);
+        float angle = 2.0f * glm::pi<float>() * c / tentacle_count_g;
+        glm::vec3 root = position + tentacle_root_radius_g * glm::vec3(cosf(angle), sinf(angle), 0.0f);
+        tentacles_.AddChain(root, tentacle_segments_g, tentacle_segment_length_g, tentacle_taper_g, angle);
+    }
+
+    MakeTentacleObjects();
+}
 
-        /**/
 
-        for (int j = 0; j < enemy_game_objects_.size(); j++)
+void Game::MakeTentacleObjects(void)
+{
+    // arm segments down to the tip, each a bit longer than its segment so they overlap at the joints
+    for (int c = 0; c < tentacles_.GetChainCount(); c++)
+    {
+        int segments = tentacles_.GetSegmentCount(c);
+        for (int s = 0; s < segments; s++)
         {
-            float distance = glm::length(spikes_[i]->GetPosition() - enemy_game_objects_[j]->GetPosition());
-            // If distance is below a threshold, we have a collision
-            if (distance < 0.8f)
-            {
-                if (enemy_game_objects_[j]->GetHealth() <= 1)
-                {
-                    int r = rand() / (RAND_MAX / 5);
-                    if ( r == 2 )
-                    {
-                        collectible_game_objects_.push_back( new CollectibleGameObject(enemy_game_objects_[j]->GetPosition(), sprite_, &sprite_shader_, tex_[2], 1) );
-                    }
-                    else if (r == 1)
-                    {
-                        collectible_game_objects_.push_back(new CollectibleGameObject(enemy_game_objects_[j]->GetPosition(), sprite_, &sprite_shader_, tex_[21], 2));
-                    }
+            GameObject *segment = new GameObject(tentacles_.GetJoint(c, s), sprite_, &sprite_shader_, (s == segments - 1) ? tex_[24] : tex_[23]);
+            segment->SetScale(1.3f * tentacles_.GetLength(c, s));
+            tentacle_objects_.push_back(segment);
+        }
+    }
 
-                    //enemy_game_objects_[j]->GetPosition()
-                    GameObject *particles = new ParticleSystem(glm::vec3(0,0,0), explosion_particles_, &particle_shader_, tex_[4], new GameObject(enemy_game_objects_[j]->GetPosition(), sprite_, &sprite_shader_, tex_[4]));
-                    particles->SetScale(0.2);
-                    particles->SetTimer(1.0f);
-                    explosions_.push_back(particles); 
+    // they start where the chains are rather than blending in from where they were made
+    PlaceTentacles();
+    for (int i = 0; i < tentacle_objects_.size(); i++) tentacle_objects_[i]->SavePreviousTransform();
+}
 
-                    delete enemy_game_objects_[j];
-                    enemy_game_objects_.erase(enemy_game_objects_.begin()+j);
 
-                    score_++;
-                }
-                else
-                {
-                    enemy_game_objects_[j]->Hit();
-                    if (player_->GetTimer() == 0) enemy_game_objects_[j]->Hit();
-                }
-                
-                delete spikes_[i];
-                spikes_.erase(spikes_.begin()+i);
+void Game::ClearTentacles(void)
+{
+    for (int i = 0; i < tentacle_objects_.size(); i++) delete tentacle_objects_[i];
+    tentacle_objects_.clear();
+    tentacles_.Clear();
+    boss_handle_ = EntityHandle();
+}
 
-                if (! am.SoundIsPlaying(explosion_index_) ) am.PlaySound(explosion_index_);
 
-                i--;
+void Game::UpdateTentacles(void)
+{
+    EnemyGameObject *boss = enemy_game_objects_.Get(boss_handle_);
+    if (!boss || tentacles_.GetChainCount() == 0) return;
 
-                if (i < 0) goto endloop;
-                break;
-            }
-            
+    glm::vec3 centre = boss->GetPosition();
+    for (int c = 0; c < tentacles_.GetChainCount(); c++)
+    {
+        float angle = 2.0f * glm::pi<float>() * c / tentacles_.GetChainCount();
+        glm::vec3 root = centre + tentacle_root_radius_g * glm::vec3(cosf(angle), sinf(angle), 0.0f);
+        tentacles_.SetRoot(c, root);
+
+        // a tentacle that can reach the player grabs for it, the rest sway about, each a little out of step with the one before
+        float reach = tentacles_.GetReach(c);
+        glm::vec3 to_player = player_->GetPosition() - root;
+        if (player_health_ > 0 && glm::length(to_player) < reach)
+        {
+            tentacles_.SetTarget(c, player_->GetPosition());
         }
-
-        if ( spikes_[i]->GetTimer() == 2 )
+        else
         {
-            delete spikes_[i];
-            spikes_.erase(spikes_.begin()+i);
-
-            i--;
+            float sway = angle + 0.6f * sinf(1.5f * static_cast<float>(current_time_) + c);
+            tentacles_.SetTarget(c, root + 0.75f * reach * glm::vec3(cosf(sway), sinf(sway), 0.0f));
         }
     }
 
-    glm::vec3 pos = player_->GetPosition();
-    for (int i = 0; i < health_objects_.size(); i++)
+    // each chain only touches its own joints, so they solve across the threads
+    tentacles_.Solve(jobs_);
+    PlaceTentacles();
+}
+
+
+void Game::PlaceTentacles(void)
+{
+    // a segment's sprite sits halfway along it, turned to lie along it (sprites face up, so a quarter turn back)
+    int i = 0;
+    for (int c = 0; c < tentacles_.GetChainCount(); c++)
     {
-        health_objects_[i]->SetPosition( glm::vec3(pos.x - 5.0f + (0.5f * i), pos.y + 3.5f, 0.0f ) );
+        for (int s = 0; s < tentacles_.GetSegmentCount(c); s++)
+        {
+            glm::vec3 a = tentacles_.GetJoint(c, s);
+            glm::vec3 b = tentacles_.GetJoint(c, s + 1);
+            tentacle_objects_[i]->SetPosition(0.5f * (a + b));
+            tentacle_objects_[i]->SetRotation(FastAtan2(b.y - a.y, b.x - a.x) - glm::pi<float>() / 2.0f);
+            i++;
+        }
     }
+}
 
-    for (int i = ui_objects_.size()-1; i >= 0; i--)
+
+void Game::StreamChunks(void)
+{
+    if (!chunks_.IsEnabled()) return;
+
+    PROFILE_ZONE("streaming");
+
+    // the awake chunks are the ones round the player
+    chunks_.Recentre(player_->GetPosition());
+
+    // anything that's left them sleeps in the chunk it's in, except the boss (its tentacles would have to go with it)
+    // sleepers are still alive, so they keep counting towards the spawn director's caps and only waking ones get
+    // replaced when they die, the same as in a world where everything is awake
+    for (int i = 0; i < enemy_game_objects_.GetSize(); i++)
     {
-        ui_objects_[i]->SetPosition( glm::vec3(pos.x + 0.5f - (0.5f * i), pos.y + 3.5f, 0.0f ) );
-        ui_objects_[i]->SetTexture(tex_[(score_ / static_cast<int> ( pow(10, i) ) ) % 10 + 10]);
+        EnemyGameObject *enemy = enemy_game_objects_[i];
+        if (chunks_.IsActive(enemy->GetPosition()) || enemy_game_objects_.GetHandle(i) == boss_handle_) continue;
+
+        SaveObject(enemy, chunks_.Sleep(ChunkStreamer::ENEMY, enemy->GetPosition()));
+        enemy_game_objects_.DestroyAt(i);
     }
 
-    if (player_->GetTimer(0) == 0)
+    for (int i = 0; i < collectible_game_objects_.GetSize(); i++)
     {
-        timer_objects_[0]->SetPosition( glm::vec3(pos.x + 4.5f, pos.y + 3.5f, 0.0f ) );
-        timer_objects_[1]->SetPosition( glm::vec3(pos.x + 5.0f, pos.y + 3.5f, 0.0f ) );
-        timer_objects_[1]->SetTexture(tex_[static_cast<int> ( player_->GetTimerTime() )  % 10 + 10]);
+        CollectibleGameObject *collectible = collectible_game_objects_[i];
+        if (chunks_.IsActive(collectible->GetPosition())) continue;
+
+        SaveObject(collectible, chunks_.Sleep(ChunkStreamer::COLLECTIBLE, collectible->GetPosition()));
+        collectible_game_objects_.DestroyAt(i);
     }
 
-    
+    // back to the pools now, so there's room for what wakes up
+    enemy_game_objects_.Flush();
+    collectible_game_objects_.Flush();
 
-    endloop:
+    // as much of each chunk as fits in the pools wakes, whatever doesnt waits for a later tick
+    int count;
+    while ((count = chunks_.Wake(ChunkStreamer::ENEMY, enemy_pool_.GetCapacity() - enemy_pool_.GetInUse(), waking_)) > 0)
     {
-        if (boss_ && enemy_game_objects_.size() == 0) 
+        for (int n = 0; n < count; n++)
         {
-            end_screen_ = new GameObject(player_->GetPosition(), sprite_, &sprite_shader_, tex_[25]);
-            end_screen_->SetScale(10);
-            player_->SetVelocity(glm::vec3(0,0,0));
+            LoadObject(SpawnEnemy(glm::vec3(0.0f), tex_[0]), waking_);
         }
-        return;
     }
-        
+
+    while ((count = chunks_.Wake(ChunkStreamer::COLLECTIBLE, collectible_pool_.GetCapacity() - collectible_pool_.GetInUse(), waking_)) > 0)
+    {
+        for (int n = 0; n < count; n++)
+        {
+            LoadObject(SpawnCollectible(glm::vec3(0.0f), tex_[0], 0), waking_);
+        }
+    }
+}
+
+
+bool Game::IsWon(void) const
+{
+    // sleepers are as alive as the awake enemies, and since the director counts them too there are never more of
+    // them left to sink than a game with nothing asleep would have
+    return boss_ && enemy_game_objects_.GetSize() == 0 && chunks_.GetSleeping(ChunkStreamer::ENEMY) == 0;
+}
+
+
+void Game::FillScenario(void)
+{
+    Random &spawn = random_->Get(RandomStreams::SPAWN);
+
+    // enemies, split between navy ships and sea monsters in the scenario's ratio
+    // anything asleep in a far chunk still counts
+    int enemies = scenario_.navy_ships + scenario_.sea_monsters;
+    while (enemy_game_objects_.GetSize() + chunks_.GetSleeping(ChunkStreamer::ENEMY) < enemies)
+    {
+        EnemyGameObject *enemy;
+        if (spawn.Below(enemies) < scenario_.navy_ships) enemy = SpawnEnemy(ScenarioPosition(spawn), tex_[1]);
+        else enemy = SpawnEnemy(ScenarioPosition(spawn), tex_[5], 3, 1);
+        if (!enemy) break;
+    }
+
+    // collectibles, an even mix of buffs, health and gold
+    while (collectible_game_objects_.GetSize() + chunks_.GetSleeping(ChunkStreamer::COLLECTIBLE) < scenario_.collectibles)
+    {
+        int type = spawn.Below(3);
+        GLuint texture = (type == 0) ? tex_[8] : (type == 1) ? tex_[2] : tex_[21];
+        CollectibleGameObject *collectible = SpawnCollectible(ScenarioPosition(spawn), texture, type);
+        if (!collectible) break;
+        if (type == 0) collectible->SetScale(0.5);
+    }
+
+    // auto fire, stepping round by the golden angle so the shots cover every direction evenly
+    while (bullets_.GetSize() < scenario_.projectiles && bullets_.GetSize() < bullet_pool_.GetCapacity())
+    {
+        FireBullet(fire_angle_);
+        fire_angle_ = fmod(fire_angle_ + 2.39996323f, 2.0f * glm::pi<float>());
+    }
+}
+
+
+glm::vec3 Game::ScenarioPosition(Random &random) const
+{
+    glm::vec3 centre = player_->GetPosition();
+    float extent = scenario_.extent;
+
+    if (scenario_.layout == Scenario::CLUSTERED)
+    {
+        // somewhere in a circle round one of the clumps (square root so the circle fills evenly)
+        centre += cluster_centres_[random.Below(cluster_centres_.size())];
+        float angle = random.Range(0.0f, 2.0f * glm::pi<float>());
+        float radius = scenario_.cluster_radius * sqrt(random.Float());
+        return centre + glm::vec3(radius * cos(angle), radius * sin(angle), 0.0f);
+    }
+    else if (scenario_.layout == Scenario::RING)
+    {
+        // between half the extent and the extent out from the player
+        float angle = random.Range(0.0f, 2.0f * glm::pi<float>());
+        float radius = random.Range(0.5f * extent, extent);
+        return centre + glm::vec3(radius * cos(angle), radius * sin(angle), 0.0f);
+    }
+
+    return centre + glm::vec3(random.Range(-extent, extent), random.Range(-extent, extent), 0.0f);
 }
 
 
-void Game::Render(void){
+void Game::ReportPools(std::ostream &out) const
+{
+    out << "Pools (in use / peak / capacity, failed acquires):" << std::endl;
+    out << "  enemies       " << enemy_pool_.GetInUse() << " / " << enemy_pool_.GetHighWater() << " / " << enemy_pool_.GetCapacity() << ", " << enemy_pool_.GetFailed() << std::endl;
+    out << "  collectibles  " << collectible_pool_.GetInUse() << " / " << collectible_pool_.GetHighWater() << " / " << collectible_pool_.GetCapacity() << ", " << collectible_pool_.GetFailed() << std::endl;
+    out << "  bullets       " << bullet_pool_.GetInUse() << " / " << bullet_pool_.GetHighWater() << " / " << bullet_pool_.GetCapacity() << ", " << bullet_pool_.GetFailed() << std::endl;
+    out << "  spikes        " << spike_pool_.GetInUse() << " / " << spike_pool_.GetHighWater() << " / " << spike_pool_.GetCapacity() << ", " << spike_pool_.GetFailed() << std::endl;
+    out << "  trails        " << trail_pool_.GetInUse() << " / " << trail_pool_.GetHighWater() << " / " << trail_pool_.GetCapacity() << ", " << trail_pool_.GetFailed() << std::endl;
+    out << "  explosions    " << explosion_pool_.GetInUse() << " / " << explosion_pool_.GetHighWater() << " / " << explosion_pool_.GetCapacity() << ", " << explosion_pool_.GetFailed() << std::endl;
+}
+
+
+void Game::FlushDestroyed(void)
+{
+    enemy_game_objects_.Flush();
+    collectible_game_objects_.Flush();
+    explosions_.Flush();
+    bullets_.Flush();
+    spikes_.Flush();
+    particle_game_objects_.Flush();
+    child_game_objects_.Flush();
+}
+
+
+void Game::SaveSnapshot(Snapshot &snapshot) const
+{
+    PROFILE_ZONE("SaveSnapshot");
+
+    snapshot.Begin();
+
+    // how many of everything, first so loading can check it all fits before it touches anything
+    int counts[] = { enemy_game_objects_.GetSize(), collectible_game_objects_.GetSize(), bullets_.GetSize(), spikes_.GetSize(),
+                     particle_game_objects_.GetSize(), explosions_.GetSize(), child_game_objects_.GetSize() };
+    snapshot.PutArray(counts, 7);
+
+    snapshot.Put(static_cast<long long>(tick_count_));
+    snapshot.Put(current_time_);
+    snapshot.Put(player_health_);
+    snapshot.Put(score_);
+    snapshot.Put(boss_);
+    snapshot.Put(buff_count_);
+    snapshot.Put(num_enemies_);
+    snapshot.Put(num_buffs_);
+    snapshot.Put(game_over_);
+    snapshot.Put(fire_angle_);
+
+    snapshot.Put(static_cast<int>(cluster_centres_.size()));
+    for (int i = 0; i < cluster_centres_.size(); i++) snapshot.PutArray(&cluster_centres_[i].x, 3);
+
+    // the clock goes before any timer, loading a timer needs the clock it was saved against
+    timers_->Save(snapshot);
+    random_->Save(snapshot);
+    spawn_director_.Save(snapshot);
+    flow_field_.Save(snapshot);
+    bullet_timer_.Save(snapshot);
+    SaveObject(player_, snapshot);
+
+    snapshot.Put(end_screen_ != NULL);
+    if (end_screen_) SaveObject(end_screen_, snapshot);
+
+    // then every object in the order it sits in its list, so the game updates them in the same order after a load
+    for (int i = 0; i < enemy_game_objects_.GetSize(); i++) SaveObject(enemy_game_objects_[i], snapshot);
+    for (int i = 0; i < collectible_game_objects_.GetSize(); i++) SaveObject(collectible_game_objects_[i], snapshot);
+    for (int i = 0; i < bullets_.GetSize(); i++) SaveObject(bullets_[i], snapshot);
+    for (int i = 0; i < spikes_.GetSize(); i++) SaveObject(spikes_[i], snapshot);
+
+    // handles dont survive a load, so trails and children save where their parent sits in its list (-1 for a parent thats gone)
+    for (int i = 0; i < particle_game_objects_.GetSize(); i++)
+    {
+        snapshot.Put(bullets_.IndexOf(particle_game_objects_[i]->GetParent()));
+        SaveObject(particle_game_objects_[i], snapshot);
+    }
+
+    for (int i = 0; i < explosions_.GetSize(); i++) SaveObject(explosions_[i], snapshot);
+
+    for (int i = 0; i < child_game_objects_.GetSize(); i++)
+    {
+        ChildGameObject *child = child_game_objects_[i];
+        bool of_child = child->GetParents() == &child_game_objects_;
+        snapshot.Put(of_child);
+        snapshot.Put(of_child ? child_game_objects_.IndexOf(child->GetParent()) : enemy_game_objects_.IndexOf(child->GetParent()));
+        SaveObject(child, snapshot);
+    }
+
+    // the tentacle sprites are put back from the chains
+    snapshot.Put(enemy_game_objects_.IndexOf(boss_handle_));
+    tentacles_.Save(snapshot);
+
+    // and everything asleep in the far chunks
+    chunks_.Save(snapshot);
+}
+
+
+void Game::LoadSnapshot(Snapshot &snapshot)
+{
+    PROFILE_ZONE("LoadSnapshot");
+
+    // objects load themselves straight into the game, so a bad snapshot is only found part way through, by which
+    // time the old world is gone, so it's kept here first and put back if that happens
+    SaveSnapshot(undo_);
+    try
+    {
+        ReadSnapshot(snapshot);
+    }
+    catch (std::exception &)
+    {
+        ReadSnapshot(undo_);
+        throw;
+    }
+}
+
+
+void Game::ReadSnapshot(Snapshot &snapshot)
+{
+    snapshot.Open();
+
+    int counts[7];
+    snapshot.GetArray(counts, 7);
+    if (counts[0] > enemy_pool_.GetCapacity() || counts[1] > collectible_pool_.GetCapacity() || counts[2] > bullet_pool_.GetCapacity()
+            || counts[3] > spike_pool_.GetCapacity() || counts[4] > trail_pool_.GetCapacity() || counts[5] > explosion_pool_.GetCapacity())
+    {
+        throw(std::ios_base::failure(std::string("Snapshot has more objects than this game has room for")));
+    }
+
+    // throw the current world away, the objects go back to their pools
+    enemy_game_objects_.Clear();
+    collectible_game_objects_.Clear();
+    particle_game_objects_.Clear();
+    bullets_.Clear();
+    spikes_.Clear();
+    explosions_.Clear();
+    child_game_objects_.Clear();
+    delete end_screen_;
+    end_screen_ = NULL;
+    ClearTentacles();
+
+    tick_count_ = static_cast<long>(snapshot.Get<long long>());
+    current_time_ = snapshot.Get<double>();
+    player_health_ = snapshot.Get<int>();
+    score_ = snapshot.Get<int>();
+    boss_ = snapshot.Get<bool>();
+    buff_count_ = snapshot.Get<int>();
+    num_enemies_ = snapshot.Get<int>();
+    num_buffs_ = snapshot.Get<int>();
+    game_over_ = snapshot.Get<bool>();
+    fire_angle_ = snapshot.Get<float>();
+
+    cluster_centres_.resize(snapshot.Get<int>());
+    for (int i = 0; i < cluster_centres_.size(); i++) snapshot.GetArray(&cluster_centres_[i].x, 3);
+
+    timers_->Load(snapshot);
+    random_->Load(snapshot);
+    spawn_director_.Load(snapshot);
+    flow_field_.Load(snapshot);
+    bullet_timer_.Load(snapshot);
+    LoadObject(player_, snapshot);
+
+    if (snapshot.Get<bool>())
+    {
+        end_screen_ = new GameObject(glm::vec3(0.0f), sprite_, &sprite_shader_, tex_[25]);
+        LoadObject(end_screen_, snapshot);
+    }
+
+    // every object is made with any old values and then loads its own over them, the pools were checked to have room above
+    for (int i = 0; i < counts[0]; i++) LoadObject(SpawnEnemy(glm::vec3(0.0f), tex_[0]), snapshot);
+    for (int i = 0; i < counts[1]; i++) LoadObject(SpawnCollectible(glm::vec3(0.0f), tex_[0], 0), snapshot);
+
+    for (int i = 0; i < counts[2]; i++)
+    {
+        ProjectileGameObject *bullet = bullet_pool_.Acquire(glm::vec3(0.0f), sprite_, &sprite_shader_, tex_[0]);
+        bullets_.Add(bullet);
+        LoadObject(bullet, snapshot);
+    }
+
+    for (int i = 0; i < counts[3]; i++)
+    {
+        ProjectileGameObject *spike = spike_pool_.Acquire(glm::vec3(0.0f), sprite_, &sprite_shader_, tex_[0]);
+        spikes_.Add(spike);
+        LoadObject(spike, snapshot);
+    }
+
+    // the bullets are all back, so a trail can find its bullet's new handle
+    for (int i = 0; i < counts[4]; i++)
+    {
+        int parent = snapshot.Get<int>();
+        EntityHandle handle = (parent >= 0 && parent < bullets_.GetSize()) ? bullets_.GetHandle(parent) : EntityHandle();
+        ParticleSystem *particles = trail_pool_.Acquire(glm::vec3(0.0f), bullet_particles_, &particle_shader_, tex_[0], &bullets_, handle);
+        particle_game_objects_.Add(particles);
+        LoadObject(particles, snapshot);
+    }
+
+    for (int i = 0; i < counts[5]; i++)
+    {
+        ParticleSystem *particles = explosion_pool_.Acquire(glm::vec3(0.0f), explosion_particles_, &particle_shader_, tex_[0]);
+        explosions_.Add(particles);
+        LoadObject(particles, snapshot);
+    }
+
+    // a child can hang off a child further down the list, so they're all made before any of them is hung off its parent
+    std::vector<bool> of_child(counts[6]);
+    std::vector<int> parents(counts[6]);
+    for (int i = 0; i < counts[6]; i++)
+    {
+        of_child[i] = snapshot.Get<bool>();
+        parents[i] = snapshot.Get<int>();
+        ChildGameObject *child = new ChildGameObject(glm::vec3(0.0f), sprite_, &sprite_shader_, tex_[0], &enemy_game_objects_, EntityHandle());
+        child_game_objects_.Add(child);
+        LoadObject(child, snapshot);
+    }
+
+    for (int i = 0; i < counts[6]; i++)
+    {
+        const EntityMap<ChildGameObject> &children = child_game_objects_;
+        const EntityMap<EnemyGameObject> &enemies = enemy_game_objects_;
+        if (of_child[i]) child_game_objects_[i]->SetParent(&children, (parents[i] >= 0 && parents[i] < children.GetSize()) ? children.GetHandle(parents[i]) : EntityHandle());
+        else child_game_objects_[i]->SetParent(&enemies, (parents[i] >= 0 && parents[i] < enemies.GetSize()) ? enemies.GetHandle(parents[i]) : EntityHandle());
+    }
+
+    int boss = snapshot.Get<int>();
+    if (boss >= 0 && boss < enemy_game_objects_.GetSize()) boss_handle_ = enemy_game_objects_.GetHandle(boss);
+    tentacles_.Load(snapshot);
+    MakeTentacleObjects();
+
+    chunks_.Load(snapshot);
+
+    // a snapshot from a game that saves more than this one reads wouldnt have thrown yet
+    if (snapshot.GetPosition() != snapshot.GetSize())
+    {
+        throw(std::ios_base::failure(std::string("Snapshot has more in it than this game saves")));
+    }
+}
+
+
+int Game::TextureIndex(GLuint texture) const
+{
+    for (int i = 0; i < num_textures_; i++)
+    {
+        if (tex_[i] == texture) return i;
+    }
+    return -1;
+}
+
+
+void Game::SaveObject(const GameObject *object, Snapshot &snapshot) const
+{
+    snapshot.Put(TextureIndex(object->GetTexture()));
+    object->Save(snapshot);
+}
+
+
+void Game::LoadObject(GameObject *object, Snapshot &snapshot)
+{
+    int texture = snapshot.Get<int>();
+    if (texture < -1 || texture >= num_textures_)
+    {
+        throw(std::ios_base::failure(std::string("Snapshot has an object with a texture the game doesnt have")));
+    }
+    object->SetTexture(texture >= 0 ? tex_[texture] : 0);
+    object->Load(snapshot);
+}
+
+
+template <class Objects>
+void Game::RenderVisible(Objects &objects, int count, float radius, const glm::mat4 &view_matrix, float alpha)
+{
+    // pack every object's bounding circle, cull the lot in one go, then draw only what's left
+    cull_x_.resize(count);
+    cull_y_.resize(count);
+    cull_radius_.resize(count);
+    visible_.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        glm::vec3 position = objects[i]->GetWorldPosition(alpha);
+        cull_x_[i] = position.x;
+        cull_y_[i] = position.y;
+        cull_radius_[i] = radius * objects[i]->GetWorldScale(alpha);
+    }
+
+    int visible = culler_.Cull(cull_x_.data(), cull_y_.data(), cull_radius_.data(), count, visible_.data());
+    for (int v = 0; v < visible; v++)
+    {
+        objects[visible_[v]]->Render(view_matrix, current_time_, alpha);
+    }
+}
+
+
+void Game::Render(float alpha){
+    PROFILE_ZONE("Render");
 
     // Clear background
     glClearColor(viewport_background_color_g.r,
@@ -966,86 +1973,104 @@ void Game::Render(void){
     float camera_zoom = 0.25f;
     glm::mat4 camera_zoom_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(camera_zoom, camera_zoom, camera_zoom));
     glm::mat4 view_matrix = window_scale_matrix * camera_zoom_matrix;
+
+    // the performance overlay stays put on screen, so it doesnt follow the camera
+    glm::mat4 hud_view_matrix = view_matrix;
     
 
     // getting the inverse of our position so we can translate the camera in the same direction as the player
-    glm::vec3 vector_translation;
-    if (player_health_ > 0) vector_translation = glm::vec3(-1.0f * player_->GetPosition().x, -1.0f * player_->GetPosition().y, 0.0f);
-    else vector_translation = glm::vec3(-1.0f * explosions_.back()->GetPosition().x, -1.0f * explosions_.back()->GetPosition().y, 0.0f);
+    // the player stays put once it dies, so this also keeps the camera on its explosion
+    glm::vec3 camera_position = player_->GetInterpolatedPosition(alpha);
+    glm::vec3 vector_translation = glm::vec3(-1.0f * camera_position.x, -1.0f * camera_position.y, 0.0f);
 
     // updating the matrix to include the translation
     view_matrix = glm::translate(view_matrix, vector_translation);
 
-    if (boss_ && enemy_game_objects_.size() == 0) 
+    // the screen's edges come from the same matrix everything is drawn with
+    culler_.SetView(view_matrix);
+    culler_.ResetCounts();
+
+    if (IsWon()) 
     {
-        end_screen_->Render(view_matrix, current_time_);
+        end_screen_->Render(view_matrix, current_time_, alpha);
     }
     
 
     // Render all game objects
     if (player_health_ > 0) 
     {
+        PROFILE_ZONE("render player and hud");
+
         for (int i = 0; i < player_health_; i++)
         {
-            health_objects_[i]->Render(view_matrix, current_time_);
+            health_objects_[i]->Render(view_matrix, current_time_, alpha);
         }
 
         for (int i = 0; i < ui_objects_.size(); i++)
         {
-            ui_objects_[i]->Render(view_matrix, current_time_);
+            ui_objects_[i]->Render(view_matrix, current_time_, alpha);
         }
 
         if (player_->GetTimer(0) == 0)
         {
             for (int i = 0; i < timer_objects_.size(); i++)
             {
-                timer_objects_[i]->Render(view_matrix, current_time_);
+                timer_objects_[i]->Render(view_matrix, current_time_, alpha);
             }
         }
         
 
-        player_->Render(view_matrix, current_time_);
+        player_->Render(view_matrix, current_time_, alpha);
     }
 
-    for (int i = 0; i < enemy_game_objects_.size(); i++)
     {
-        enemy_game_objects_[i]->Render(view_matrix, current_time_);
+        PROFILE_ZONE("render enemies");
+        RenderVisible(enemy_game_objects_, enemy_game_objects_.GetSize(), sprite_cull_radius_g, view_matrix, alpha);
     }
 
-    for (int i = 0; i < child_game_objects_.size(); i++)
     {
-        child_game_objects_[i]->Render(view_matrix, current_time_);
+        PROFILE_ZONE("render children");
+        RenderVisible(child_game_objects_, child_game_objects_.GetSize(), sprite_cull_radius_g, view_matrix, alpha);
+        RenderVisible(tentacle_objects_, tentacle_objects_.size(), sprite_cull_radius_g, view_matrix, alpha);
     }
 
-    for (int i = 0; i < collectible_game_objects_.size(); i++)
     {
-        collectible_game_objects_[i]->Render(view_matrix, current_time_);
+        PROFILE_ZONE("render collectibles");
+        RenderVisible(collectible_game_objects_, collectible_game_objects_.GetSize(), sprite_cull_radius_g, view_matrix, alpha);
     }
 
-    for ( int i = 0; i < bullets_.size(); i++)
     {
-        bullets_[i]->Render(view_matrix, current_time_);
+        PROFILE_ZONE("render bullets");
+        RenderVisible(bullets_, bullets_.GetSize(), sprite_cull_radius_g, view_matrix, alpha);
     }
 
-    for ( int i = 0; i < spikes_.size(); i++)
     {
-        spikes_[i]->Render(view_matrix, current_time_);
+        PROFILE_ZONE("render spikes");
+        RenderVisible(spikes_, spikes_.GetSize(), sprite_cull_radius_g, view_matrix, alpha);
     }
 
-    sprite_->SetScale(10.0f);
+    {
+        PROFILE_ZONE("render background");
+        sprite_->SetScale(10.0f);
+
+        background_tile_->Render(view_matrix, current_time_, alpha);
 
-    background_tile_->Render(view_matrix, current_time_);
+        sprite_->SetScale(1.0f);
+    }
 
-    sprite_->SetScale(1.0f);
+    {
+        PROFILE_ZONE("render explosions");
+        RenderVisible(explosions_, explosions_.GetSize(), particle_cull_radius_g, view_matrix, alpha);
+    }
 
-    for (int i = 0; i < explosions_.size(); i++)
     {
-        explosions_[i]->Render(view_matrix, current_time_);
+        PROFILE_ZONE("render trails");
+        RenderVisible(particle_game_objects_, particle_game_objects_.GetSize(), particle_cull_radius_g, view_matrix, alpha);
     }
 
-    for (int i = 0; i < particle_game_objects_.size(); i++)
     {
-        particle_game_objects_[i]->Render(view_matrix, current_time_);
+        PROFILE_ZONE("render perf hud");
+        perf_hud_.Render(hud_view_matrix, current_time_);
     }
 }
       
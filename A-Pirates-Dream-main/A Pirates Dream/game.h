@@ -15,8 +15,32 @@
 #include "collectible_game_object.h"
 #include "projectile_game_object.h"
 #include "child_game_object.h"
+#include "particle_system.h"
+#include "entity_map.h"
+#include "object_pool.h"
+#include "job_system.h"
 #include "timer.h"
+#include "timer_service.h"
+#include "transform_store.h"
 #include "audio_manager.h"
+#include "game_config.h"
+#include "phase_timer.h"
+#include "spatial_grid.h"
+#include "swept_circle.h"
+#include "collision_checks.h"
+#include "command_buffer.h"
+#include "random_streams.h"
+#include "input_recording.h"
+#include "frame_histogram.h"
+#include "profiler.h"
+#include "perf_hud.h"
+#include "flow_field.h"
+#include "spawn_director.h"
+#include "snapshot.h"
+#include "ik_solver.h"
+#include "view_culler.h"
+#include "chunk_streamer.h"
+#include "lod_scheduler.h"
 
 #define PrintException(exception_object)\
     std::cerr << exception_object.what() << std::endl
@@ -32,8 +56,8 @@ namespace game {
             ~Game();
 
             // Call Init() before calling any other method
-            // Initialize graphics libraries and main window
-            void Init(void); 
+            // Initialize graphics libraries and main window (skipped when running headless)
+            void Init(const GameConfig &config = GameConfig()); 
 
             // Set up the game (scene, game objects, etc.)
             void Setup(void);
@@ -41,6 +65,26 @@ namespace game {
             // Run the game (keep the game active)
             void MainLoop(void); 
 
+            // Save the whole game world to a snapshot, objects, timers, random numbers and all
+            void SaveSnapshot(Snapshot &snapshot) const;
+
+            // Put the game world back exactly as a snapshot has it, the game then plays on the same as it did from there
+            // Throws if the snapshot doesnt fit this game's pools (a stress scenario's snapshot needs the same scenario), or is cut
+            // short or doesnt add up, and then the game is left as it was before the call
+            void LoadSnapshot(Snapshot &snapshot);
+
+            // Run one tick with the next input, the way the headless loop does
+            void Step(void);
+
+            // Run one tick with input instead of the replay's or the keyboard's
+            void Step(InputState input);
+
+            // The sea's sleeping chunks, and how many enemies and collectibles are awake
+            inline const ChunkStreamer &GetChunks(void) const { return chunks_; }
+            inline const LodScheduler &GetLod(void) const { return lod_; }
+            inline int GetEnemyCount(void) const { return enemy_game_objects_.GetSize(); }
+            inline int GetCollectibleCount(void) const { return collectible_game_objects_.GetSize(); }
+
         private:
             // Main window: pointer to the GLFW window structure
             GLFWwindow *window_;
@@ -62,6 +106,7 @@ namespace game {
             // References to textures
             // This needs to be a pointer
             GLuint *tex_;
+            int num_textures_;
 
             // The player object
             PlayerGameObject* player_;
@@ -78,25 +123,59 @@ namespace game {
             std::vector<GameObject*> ui_objects_;
             std::vector<GameObject*> timer_objects_;
 
-            // A vector of enemy entities
-            std::vector<EnemyGameObject*> enemy_game_objects_;
+            // Preallocated storage for the objects that come and go, declared before the maps so they outlive them
+            ObjectPool<EnemyGameObject> enemy_pool_;
+            ObjectPool<CollectibleGameObject> collectible_pool_;
+            ObjectPool<ProjectileGameObject> bullet_pool_;
+            ObjectPool<ProjectileGameObject> spike_pool_;
+            ObjectPool<ParticleSystem> trail_pool_;
+            ObjectPool<ParticleSystem> explosion_pool_;
 
-            // A vecotr of collectible objects
-            std::vector<CollectibleGameObject*> collectible_game_objects_;
+            // The game's entities, anything destroyed during a tick goes back to its pool in FlushDestroyed() at the end of it
+            // enemy entities
+            EntityMap<EnemyGameObject> enemy_game_objects_;
 
-            // A vector of basic game objects used for the explosions
-            std::vector<GameObject*> explosions_;
+            // collectible objects
+            EntityMap<CollectibleGameObject> collectible_game_objects_;
+
+            // particle systems used for the explosions
+            EntityMap<ParticleSystem> explosions_;
 
             // a collection of bullet objects
-            std::vector<ProjectileGameObject*> bullets_;
-            std::vector<ProjectileGameObject*> spikes_;
+            EntityMap<ProjectileGameObject> bullets_;
+            EntityMap<ProjectileGameObject> spikes_;
 
-            // particle object to render
-            std::vector<GameObject*> particle_game_objects_;
+            // bullet trails, each follows its bullet by handle
+            EntityMap<ParticleSystem> particle_game_objects_;
 
-            //
-            EnemyGameObject* boss_game_object_;
-            std::vector<ChildGameObject*> child_game_objects_;
+            // broadphase grids rebuilt every tick for the collision checks
+            SpatialGrid enemy_grid_;
+            SpatialGrid collectible_grid_;
+
+            // which way the intercepting enemies head to reach the player, shared by all of them
+            FlowField flow_field_;
+
+            // one per job system thread, so the collision passes can run in parallel
+            std::vector<CollisionScratch> scratch_;
+
+            // what the collision passes decided should happen, carried out by ApplyCommands() at the end of the tick
+            CommandBuffer commands_;
+
+            // the sea's chunks, the ones far from the player hold their enemies and collectibles asleep
+            ChunkStreamer chunks_;
+
+            // which enemies are far enough away to update less often this tick
+            LodScheduler lod_;
+
+            // a chunk's record while its objects wake up
+            Snapshot waking_;
+
+            // the kraken boss, and its tentacles: an IK chain each, drawn as a sprite per segment
+            EntityHandle boss_handle_;
+            IkSolver tentacles_;
+            std::vector<GameObject*> tentacle_objects_;
+
+            EntityMap<ChildGameObject> child_game_objects_;
             
             // Keep track of time
             double current_time_;
@@ -120,14 +199,23 @@ namespace game {
             // the number of buffs on the map
             int num_buffs_;
 
-            // a timer thatll help with spawning enemies over time
-            Timer* enemy_timer_;
+            // the clock and timers every object in the game runs on
+            TimerService *timers_;
+
+            // the transforms of every object in the game
+            TransformStore *transforms_;
+
+            // worker threads for the per object updates
+            JobSystem *jobs_;
 
-            // a timer for spawning buffs over time
-            Timer* buff_timer_;
+            // the random numbers for spawning, loot drops and effects
+            RandomStreams *random_;
+
+            // decides when and where enemies and buffs spawn in the normal game, from its wave table
+            SpawnDirector spawn_director_;
 
             // a timer to determine if it is appropriate to spawn another bullet
-            Timer* bullet_timer_;
+            Timer bullet_timer_;
 
             // instance of audio manager that lets us play wav files.
             audio_manager::AudioManager am;
@@ -138,6 +226,131 @@ namespace game {
             // refrence index for the looping music
             int background_index_;
 
+            // running without a window, GL context or audio device
+            bool headless_;
+
+            // the number of ticks to simulate when headless
+            long headless_ticks_;
+
+            // fixed simulation steps per second
+            long tick_rate_;
+
+            // cap on steps per rendered frame so a slow frame doesnt snowball
+            long max_ticks_per_frame_;
+
+            // set once the player has died and the last explosion has faded
+            bool game_over_;
+
+            // time spent in each phase of HandleControls and Update
+            PhaseTimer phase_timer_;
+
+            // how long each whole tick took
+            FrameHistogram tick_histogram_;
+
+            // every tick's input, recorded from the keyboard or loaded from a replay
+            InputRecording recording_;
+
+            // where the recording gets saved once the game ends, empty when not recording
+            std::string record_path_;
+
+            // playing back recording_ instead of reading the keyboard
+            bool replaying_;
+
+            // ticks simulated so far, so also which tick of the recording is next
+            long tick_count_;
+
+            // where to save a snapshot once the game ends, and where to load one from at the start, empty when not
+            std::string save_snapshot_path_;
+            std::string load_snapshot_path_;
+
+            // F5 saves the game here and F8 rolls it back
+            Snapshot quicksave_;
+
+            // the world as it was before a load, to go back to if the snapshot turns out to be bad
+            Snapshot undo_;
+
+            // the performance overlay, F3 shows and hides it
+            PerfHud perf_hud_;
+
+            // works out which objects are on screen before Render draws them, with its batch packed here
+            ViewCuller culler_;
+            std::vector<float> cull_x_;
+            std::vector<float> cull_y_;
+            std::vector<float> cull_radius_;
+            std::vector<int> visible_;
+
+            // where the profiler's trace gets written, empty when not tracing
+            std::string trace_path_;
+
+            // running a stress scenario instead of the normal game
+            bool stress_;
+            Scenario scenario_;
+
+            // the centres of the scenario's clumps, when it has them
+            std::vector<glm::vec3> cluster_centres_;
+
+            // which way the scenario's auto fire points next
+            float fire_angle_;
+
+            // Run the simulation without rendering for a fixed number of ticks and report the cost
+            void HeadlessLoop(void);
+
+            // Store every object's transform before a tick so Render can interpolate from it
+            void SaveTransforms(void);
+
+            // Play a loaded sound unless it is already playing (or audio never loaded)
+            void PlaySound(int index);
+
+            // Carry out everything the collision passes emitted this tick, in the merged order
+            void ApplyCommands(void);
+
+            // Carry out one command, killing an enemy rolls for a drop, leaves an explosion and scores a point
+            void ApplyCommand(const Command &command);
+
+            // Free everything destroyed during the tick
+            void FlushDestroyed(void);
+
+            // Take an object from its pool and add it to the game, these return NULL (and do nothing) if the pool is empty
+            EnemyGameObject *SpawnEnemy(const glm::vec3 &position, GLuint texture, int health = 1, int state = 0);
+            CollectibleGameObject *SpawnCollectible(const glm::vec3 &position, GLuint texture, int type);
+
+            // Leave an explosion at position that fades after a second
+            void SpawnExplosion(const glm::vec3 &position);
+
+            // Fire a bullet (with its trail) from the player in the direction given by rotation
+            void FireBullet(float rotation);
+
+            // Give the boss its tentacles, rooted round position
+            void SpawnTentacles(const glm::vec3 &position);
+
+            // Make a sprite for every segment of every tentacle and put them in place
+            void MakeTentacleObjects(void);
+
+            // Drop the tentacles and their sprites, once the boss is gone
+            void ClearTentacles(void);
+
+            // Move the tentacle roots with the boss, point each one at the player (if it can reach) or its sway, and solve them
+            void UpdateTentacles(void);
+
+            // Put every segment's sprite along its piece of its chain
+            void PlaceTentacles(void);
+
+            // Put the enemies and collectibles that left the awake chunks to sleep, and wake the sleeping chunks
+            // that came into range (as far as the pools have room for them)
+            void StreamChunks(void);
+
+            // Whether the boss has come and every enemy, awake or asleep, is gone
+            bool IsWon(void) const;
+
+            // Top every population in the stress scenario back up to its target
+            void FillScenario(void);
+
+            // A random spawn point following the scenario's layout
+            glm::vec3 ScenarioPosition(Random &random) const;
+
+            // Print how full each object pool got
+            void ReportPools(std::ostream &out) const;
+
             // Callback for when the window is resized
             static void ResizeCallback(GLFWwindow* window, int width, int height);
 
@@ -147,14 +360,47 @@ namespace game {
             // Load all textures
             void SetAllTextures();
 
+            // The input for the next tick, from the replay or the keyboard (recording it if asked to)
+            InputState NextInput(void);
+
+            // Save the recording if asked to
+            void FinishRecording(void);
+
+            // Save a snapshot of the game as it ended if asked to
+            void WriteSnapshot(void);
+
+            // Where a texture is in tex_, so snapshots can save it as an index
+            int TextureIndex(GLuint texture) const;
+
+            // Replace the world with the snapshot's, throws part way through on a bad one (LoadSnapshot puts things back)
+            void ReadSnapshot(Snapshot &snapshot);
+
+            // Save an object along with its texture, and load one back (setting its texture)
+            void SaveObject(const GameObject *object, Snapshot &snapshot) const;
+            void LoadObject(GameObject *object, Snapshot &snapshot);
+
+            // Write the profiler's zones so far to the trace file if asked to
+            void WriteTrace(void);
+
+            // Give the performance overlay this frame's times and the current entity counts
+            void UpdatePerfHud(double frame_ms, double update_ms, double render_ms);
+
+            // Draw the first count objects of a list (an EntityMap or a vector) that are on screen, radius times an
+            // object's scale is how far its drawing reaches from its centre
+            template <class Objects>
+            void RenderVisible(Objects &objects, int count, float radius, const glm::mat4 &view_matrix, float alpha);
+
             // Handle user input
-            void HandleControls(double delta_time);
+            void HandleControls(InputState input, double delta_time);
+
+            // One tick: advance the clock, handle input and update everything
+            void RunTick(InputState input);
 
             // Update all the game objects
             void Update(double delta_time);
  
-            // Render the game world
-            void Render(void);
+            // Render the game world, alpha is how far we are between the last tick and the next one
+            void Render(float alpha);
 
     }; // class Game
 
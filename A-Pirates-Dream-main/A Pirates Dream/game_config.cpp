@@ -0,0 +1,136 @@
+#include <stdexcept>
+#include <string>
+#include <cstdlib>
+
+#include "game_config.h"
+
+namespace game {
+
+GameConfig::GameConfig(void)
+{
+    headless = false;
+    ticks = 3600;
+    tick_rate = 60;
+    max_ticks_per_frame = 5;
+    threads = 0;
+    seed = -1;
+    perf_hud = false;
+    chunk_size = 16;
+    active_chunks = 2;
+    lod_distance = 8;
+    stress = false;
+}
+
+
+// Read the value that follows a flag, complaining if there isnt one
+static const char *FlagValue(int argc, char **argv, int &i)
+{
+    if (i + 1 >= argc) {
+        throw(std::invalid_argument(std::string("Missing value for ") + argv[i]));
+    }
+    i++;
+    return argv[i];
+}
+
+
+// Convert a flag value to a number, complaining if it isnt a positive integer
+static long PositiveValue(const char *flag, const char *value)
+{
+    char *end;
+    long number = strtol(value, &end, 10);
+    if (*end != '\0' || number <= 0) {
+        throw(std::invalid_argument(std::string("Expected a positive number for ") + flag + ", got " + value));
+    }
+    return number;
+}
+
+
+// Convert a flag value to a number, complaining if it isnt zero or a positive integer
+static long long NonNegativeValue(const char *flag, const char *value)
+{
+    char *end;
+    long long number = strtoll(value, &end, 10);
+    if (*end != '\0' || end == value || number < 0) {
+        throw(std::invalid_argument(std::string("Expected zero or a positive number for ") + flag + ", got " + value));
+    }
+    return number;
+}
+
+
+GameConfig ParseCommandLine(int argc, char **argv)
+{
+    GameConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--headless") {
+            config.headless = true;
+        }
+        else if (arg == "--ticks") {
+            config.ticks = PositiveValue(arg.c_str(), FlagValue(argc, argv, i));
+        }
+        else if (arg == "--tick-rate") {
+            config.tick_rate = PositiveValue(arg.c_str(), FlagValue(argc, argv, i));
+        }
+        else if (arg == "--max-ticks-per-frame") {
+            config.max_ticks_per_frame = PositiveValue(arg.c_str(), FlagValue(argc, argv, i));
+        }
+        else if (arg == "--threads") {
+            config.threads = PositiveValue(arg.c_str(), FlagValue(argc, argv, i));
+        }
+        else if (arg == "--seed") {
+            config.seed = NonNegativeValue(arg.c_str(), FlagValue(argc, argv, i));
+        }
+        else if (arg == "--record") {
+            config.record = FlagValue(argc, argv, i);
+        }
+        else if (arg == "--replay") {
+            config.replay = FlagValue(argc, argv, i);
+        }
+        else if (arg == "--save-snapshot") {
+            config.save_snapshot = FlagValue(argc, argv, i);
+        }
+        else if (arg == "--load-snapshot") {
+            config.load_snapshot = FlagValue(argc, argv, i);
+        }
+        else if (arg == "--perf-hud") {
+            config.perf_hud = true;
+        }
+        else if (arg == "--trace") {
+            config.trace = FlagValue(argc, argv, i);
+        }
+        else if (arg == "--waves") {
+            config.waves = FlagValue(argc, argv, i);
+        }
+        else if (arg == "--chunk-size") {
+            config.chunk_size = NonNegativeValue(arg.c_str(), FlagValue(argc, argv, i));
+        }
+        else if (arg == "--active-chunks") {
+            config.active_chunks = NonNegativeValue(arg.c_str(), FlagValue(argc, argv, i));
+        }
+        else if (arg == "--lod-distance") {
+            config.lod_distance = NonNegativeValue(arg.c_str(), FlagValue(argc, argv, i));
+        }
+        else if (arg == "--scenario") {
+            config.scenario.Load(FlagValue(argc, argv, i));
+            config.stress = true;
+        }
+        else if (arg == "--scenario-set") {
+            config.scenario.Set(FlagValue(argc, argv, i));
+            config.stress = true;
+        }
+        else {
+            throw(std::invalid_argument(std::string("Unknown argument ") + arg));
+        }
+    }
+
+    // a recording has to start from a new game to play back
+    if (!config.record.empty() && !config.load_snapshot.empty()) {
+        throw(std::invalid_argument(std::string("--record can't be used with --load-snapshot")));
+    }
+
+    return config;
+}
+
+} // namespace game
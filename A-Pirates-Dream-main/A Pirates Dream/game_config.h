@@ -0,0 +1,76 @@
+#ifndef GAME_CONFIG_H_
+#define GAME_CONFIG_H_
+
+#include <string>
+
+#include "scenario.h"
+
+namespace game {
+
+    // Options that control how the game runs, filled in from the command line
+    struct GameConfig {
+
+        // Run the simulation without a window, GL context or audio device
+        bool headless;
+
+        // The number of simulation ticks to run in headless mode
+        long ticks;
+
+        // How many fixed simulation steps to run per second
+        long tick_rate;
+
+        // The most steps a single frame may run before dropping time, so a slow frame cant snowball
+        long max_ticks_per_frame;
+
+        // Threads that share the per object updates, 0 means one per hardware thread
+        long threads;
+
+        // Seed for every random number stream, the same seed plays out the same game, negative picks one from the clock
+        long long seed;
+
+        // Save every tick's input (and the seed) to this file when the game ends, empty to not record
+        std::string record;
+
+        // Play back the input in this file instead of reading the keyboard, empty to play normally
+        std::string replay;
+
+        // Save a snapshot of the whole game to this file when the game ends, empty to not save one
+        std::string save_snapshot;
+
+        // Start from the snapshot in this file instead of a new game, empty to start a new game
+        // With a replay the game picks up from the snapshot's tick, so the replay has to be the one the snapshot came from
+        std::string load_snapshot;
+
+        // Start with the performance overlay showing (F3 toggles it either way)
+        bool perf_hud;
+
+        // Record PROFILE_ZONE timings and write them to this file as a Chrome trace when the game ends (or F9 is pressed), empty to not trace
+        std::string trace;
+
+        // Spawn from the wave table in this file instead of the classic one, empty for the classic one
+        std::string waves;
+
+        // How wide the chunks of sea are that sleep when the player is far away, 0 to keep everything awake,
+        // and how many chunks out from the player's stay awake
+        long chunk_size;
+        long active_chunks;
+
+        // How far from the player enemies update every tick, further out they update every 2nd, 4th or 8th tick,
+        // 0 to update everything every tick
+        long lod_distance;
+
+        // Run a stress scenario instead of the normal game, and what it spawns
+        bool stress;
+        Scenario scenario;
+
+        // Constructor sets the defaults for a normal windowed game
+        GameConfig(void);
+
+    }; // struct GameConfig
+
+    // Build a configuration from the command line arguments, throws on bad input
+    GameConfig ParseCommandLine(int argc, char **argv);
+
+} // namespace game
+
+#endif // GAME_CONFIG_H_
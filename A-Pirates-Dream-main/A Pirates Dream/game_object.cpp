@@ -3,46 +3,69 @@
 #include <iostream>
 
 #include "game_object.h"
+#include "fast_math.h"
+#include "snapshot.h"
 
 namespace game {
 
+long GameObject::draw_calls_ = 0;
+
+
 GameObject::GameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture) 
 {
 
     // Initialize all attributes
-    position_ = position;
-    velocity_ = glm::vec3(0.0f,0.0f,0.0f);
-    scale_ = 1.0;
-    angle_ = 0.0;
+    // the store starts the row at position, not moving, unrotated and at scale 1
+    transforms_ = &TransformStore::Default();
+    transform_ = transforms_->Create(position);
     geometry_ = geom;
     shader_ = shader;
     texture_ = texture;
-    timer_ = new Timer();
     time_ = 0.0;
 }
 
 
 GameObject::~GameObject()
 { 
-    delete timer_; 
+    transforms_->Destroy(transform_);
 }
 
 void GameObject::SetTimer(float end_time)
 {
-    timer_->Start(end_time);
+    timer_.Start(end_time);
+}
+
+
+void GameObject::Save(Snapshot &snapshot) const
+{
+    transforms_->SaveRow(transform_, snapshot);
+    snapshot.Put(time_);
+    timer_.Save(snapshot);
+}
+
+
+void GameObject::Load(Snapshot &snapshot)
+{
+    transforms_->LoadRow(transform_, snapshot);
+    time_ = snapshot.Get<double>();
+    timer_.Load(snapshot);
 }
 
 
 glm::vec3 GameObject::GetBearing(void) const {
 
-    glm::vec3 dir(cos(angle_), sin(angle_), 0.0);
+    float s, c;
+    FastSinCos(GetRotation(), s, c);
+    glm::vec3 dir(c, s, 0.0f);
     return dir;
 }
 
 glm::vec3 GameObject::GetRight(void) const {
 
-    float pi_over_two = glm::pi<float>() / 2.0f;
-    glm::vec3 dir(cos(angle_ - pi_over_two), sin(angle_ - pi_over_two), 0.0);
+    // a quarter turn clockwise from the bearing, (cos(a - pi/2), sin(a - pi/2)) is (sin a, -cos a)
+    float s, c;
+    FastSinCos(GetRotation(), s, c);
+    glm::vec3 dir(s, -c, 0.0f);
     return dir;
 }
 
@@ -50,19 +73,15 @@ glm::vec3 GameObject::GetRight(void) const {
 void GameObject::SetRotation(float angle){ 
 
     // Set rotation angle of the game object
-    // Make sure angle is in the range [0, 2*pi]
-    float two_pi = 2.0f*glm::pi<float>();
-    angle = fmod(angle, two_pi);
-    if (angle < 0.0){
-        angle += two_pi;
-    }
-    angle_ = angle;
+    // Make sure angle is in the range [0, 2*pi)
+    Angle() = WrapAngle(angle);
 }
 
 
-void GameObject::SetVelocity(glm::vec3 &velocity)
+void GameObject::SetVelocity(const glm::vec3 &velocity)
 {
-    velocity_ = velocity;
+    VelocityX() = velocity.x;
+    VelocityY() = velocity.y;
 }
 
 
@@ -72,7 +91,7 @@ void GameObject::Update(double delta_time) {
 }
 
 
-void GameObject::Render(glm::mat4 view_matrix, double current_time){
+void GameObject::Render(glm::mat4 view_matrix, double current_time, float alpha){
 
     // Set up the shader
     shader_->Enable();
@@ -80,20 +99,8 @@ void GameObject::Render(glm::mat4 view_matrix, double current_time){
     // Set up the view matrix
     shader_->SetUniformMat4("view_matrix", view_matrix);
 
-    // Setup the scaling matrix for the shader
-    glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale_, scale_, 1.0));
-
-    // Setup the rotation matrix for the shader
-    glm::mat4 rotation_matrix = glm::rotate(glm::mat4(1.0f), angle_, glm::vec3(0.0, 0.0, 1.0));
-
-    // Set up the translation matrix for the shader
-    glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), position_);
-
-    // Setup the transformation matrix for the shader
-    glm::mat4 transformation_matrix = translation_matrix * rotation_matrix * scaling_matrix;
-
     // Set the transformation matrix in the shader
-    shader_->SetUniformMat4("transformation_matrix", transformation_matrix);
+    shader_->SetUniformMat4("transformation_matrix", GetTransformation(alpha));
 
     // Set up the geometry
     geometry_->SetGeometry(shader_->GetShaderProgram());
@@ -103,6 +110,7 @@ void GameObject::Render(glm::mat4 view_matrix, double current_time){
 
     // Draw the entity
     glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+    draw_calls_++;
 }
 
 } // namespace game
@@ -12,12 +12,17 @@
 #include "shader.h"
 #include "geometry.h"
 #include "timer.h"
+#include "transform_store.h"
 
 namespace game {
 
+    class Snapshot;
+
     /*
         GameObject is responsible for handling the rendering and updating of one object in the game world
         The update and render methods are virtual, so you can inherit them from GameObject and override the update or render functionality (see PlayerGameObject for reference)
+        The transform itself lives in a row of the TransformStore, the getters and setters here are views into that row
+        An object hung off another with SetTransformParent() has its position and rotation relative to that object's
     */
     class GameObject {
 
@@ -25,27 +30,25 @@ namespace game {
             // Constructor
             GameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture);
 
-            // Destructor
-            ~GameObject();
+            // Destructor, virtual since the game deletes objects through base class pointers
+            virtual ~GameObject();
 
             // Update the GameObject's state. Can be overriden in children
             virtual void Update(double delta_time);
 
-            // Renders the GameObject 
-            virtual void Render(glm::mat4 view_matrix, double current_time);
+            // Renders the GameObject, alpha blends between the previous and current tick's transform
+            virtual void Render(glm::mat4 view_matrix, double current_time, float alpha = 1.0f);
 
             // Getters
-            inline glm::vec3 GetPosition(void) const { return position_; }
-            inline float GetScale(void) const { return scale_; }
-            inline float GetRotation(void) const { return angle_; }
-            int GetTimer(int i = 1) const { return timer_->Finished(i); }
-            inline double GetTimerTime(void) const { return timer_->GetTime(); }
-            glm::vec3 GetVelocity(void) const { return velocity_; }
+            inline glm::vec3 GetPosition(void) const { return glm::vec3(transforms_->X(transform_), transforms_->Y(transform_), 0.0f); }
+            inline float GetScale(void) const { return transforms_->Scale(transform_); }
+            inline float GetRotation(void) const { return transforms_->Angle(transform_); }
+            int GetTimer(int i = 1) const { return timer_.Finished(i); }
+            inline double GetTimerTime(void) const { return timer_.GetTime(); }
+            glm::vec3 GetVelocity(void) const { return glm::vec3(transforms_->VelocityX(transform_), transforms_->VelocityY(transform_), 0.0f); }
             inline double GetTime(void) const { return time_; }
             //inline double 
             virtual inline glm::vec3 GetStart(void) const { return glm::vec3(0.0f,0.0f,0.0f); }
-            // 
-            virtual inline void GetParent(GameObject **parent) {}
 
             // Get bearing direction (direction in which the game object
             // is facing)
@@ -54,27 +57,69 @@ namespace game {
             // Get vector pointing to the right side of the game object
             glm::vec3 GetRight(void) const;
 
+            // Remember the current transform so rendering can blend from it towards the next tick's
+            // (TransformStore::SaveAll does this for every object at once)
+            inline void SavePreviousTransform(void) { transforms_->SaveRow(transform_); }
+
+            // Transform blended between the previous and current tick, alpha in [0, 1] (relative to the transform parent if there is one)
+            inline glm::vec3 GetInterpolatedPosition(float alpha) const { return glm::vec3(transforms_->InterpolatedX(transform_, alpha), transforms_->InterpolatedY(transform_, alpha), 0.0f); }
+            inline float GetInterpolatedRotation(float alpha) const { return transforms_->InterpolatedAngle(transform_, alpha); }
+
+            // The model matrix Render draws with (the parents' translate * rotate, then this object's translate * rotate * scale) at the blended transform
+            // It comes from the store's cache unless something in the chain moved
+            inline const glm::mat4 &GetTransformation(float alpha) const { return transforms_->World(transform_, alpha); }
+
+            // Where the object is in the world at alpha, parents included, without working out its own model matrix
+            inline glm::vec3 GetWorldPosition(float alpha) const { return transforms_->WorldPosition(transform_, alpha); }
+
+            // How much the object is scaled in the world at alpha, parents included
+            inline float GetWorldScale(float alpha) const { return transforms_->WorldScale(transform_, alpha); }
+
+            // Hang this object's transform off another object's, NULL to hang it off nothing
+            // The parent's position and rotation (not its scale) carry down, the parent has to outlive the link
+            inline void SetTransformParent(const GameObject *parent) { transforms_->SetParent(transform_, parent ? parent->transform_ : -1); }
+
             // Setters
-            inline void SetPosition(const glm::vec3& position) { position_ = position; }
-            inline void SetScale(float scale) { scale_ = scale; }
+            inline void SetPosition(const glm::vec3& position) { PositionX() = position.x; PositionY() = position.y; }
+            inline void SetScale(float scale) { transforms_->Scale(transform_) = scale; transforms_->MarkDirty(transform_); }
             virtual void SetRotation(float angle);
             void SetTimer(float end_time);
             void SetTexture(GLuint texture) { texture_ = texture;}
-            virtual void SetVelocity(glm::vec3 &velocity);
+            inline GLuint GetTexture(void) const { return texture_; }
+            virtual void SetVelocity(const glm::vec3 &velocity);
+
+            // Save this object's state to a snapshot and load it back, overridden by objects with more state
+            // The texture, and what the object hangs off, are saved by whoever owns it
+            virtual void Save(Snapshot &snapshot) const;
+            virtual void Load(Snapshot &snapshot);
+
+            // Draw calls every object has made since the count was last reset, for the performance HUD
+            static inline long GetDrawCalls(void) { return draw_calls_; }
+            static inline void ResetDrawCalls(void) { draw_calls_ = 0; }
 
 
         protected:
-            // Object's Transform Variables
-            glm::vec3 position_;
-            glm::vec3 velocity_;
-            float scale_;
-            float angle_;
+            // This object's row of the transform store, for subclasses that move themselves
+            // handing out the position or angle marks the row dirty, since its about to be written
+            inline float &PositionX(void) { transforms_->MarkDirty(transform_); return transforms_->X(transform_); }
+            inline float &PositionY(void) { transforms_->MarkDirty(transform_); return transforms_->Y(transform_); }
+            inline float &VelocityX(void) { return transforms_->VelocityX(transform_); }
+            inline float &VelocityY(void) { return transforms_->VelocityY(transform_); }
+            inline float &Angle(void) { transforms_->MarkDirty(transform_); return transforms_->Angle(transform_); }
+
+            // Render counts every draw here, its only ever called from the main thread
+            static long draw_calls_;
+
+            // Object's Transform Variables, the row they live in
+            TransformStore *transforms_;
+            int transform_;
 
             // a total for the amount of time the object has been alive, helps us keep the enemy movement unique for now 
             double time_;
 
             // a timer for this objects explosion
-            Timer* timer_;
+            // mutable since checking a finished timer also resets it, which GetTimer does from const code
+            mutable Timer timer_;
 
             // Geometry
             Geometry *geometry_;
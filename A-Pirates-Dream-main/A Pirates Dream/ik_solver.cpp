@@ -0,0 +1,224 @@
+#include <cmath>
+#include <ios>
+#include <stdexcept>
+#include <string>
+
+#include "ik_solver.h"
+#include "snapshot.h"
+
+namespace game {
+
+namespace {
+
+    // joints closer than this are treated as on top of each other, so a step never divides by zero
+    const float min_gap_g = 1e-6f;
+
+    // Put joint b length away from joint a, on the line from a through b
+    inline void Place(float ax, float ay, float &bx, float &by, float length)
+    {
+        float dx = bx - ax;
+        float dy = by - ay;
+        float gap = sqrtf(dx * dx + dy * dy);
+
+        // no direction to go in, so carry on along x
+        if (gap < min_gap_g) {
+            bx = ax + length;
+            by = ay;
+            return;
+        }
+
+        float scale = length / gap;
+        bx = ax + dx * scale;
+        by = ay + dy * scale;
+    }
+
+} // namespace
+
+
+IkSolver::IkSolver(void)
+{
+    iterations_ = 8;
+    tolerance_ = 0.01f;
+}
+
+
+int IkSolver::AddChain(const glm::vec3 &root, int segments, float length, float taper, float angle)
+{
+    if (segments <= 0 || length <= 0.0f || taper <= 0.0f) {
+        throw(std::invalid_argument(std::string("A chain needs at least one segment and positive lengths")));
+    }
+
+    first_.push_back(x_.size());
+    segments_.push_back(segments);
+    root_x_.push_back(root.x);
+    root_y_.push_back(root.y);
+
+    float c = cosf(angle);
+    float s = sinf(angle);
+    float reach = 0.0f;
+    float segment = length;
+    for (int j = 0; j <= segments; j++) {
+        x_.push_back(root.x + reach * c);
+        y_.push_back(root.y + reach * s);
+        length_.push_back(j < segments ? segment : 0.0f);
+        if (j < segments) reach += segment;
+        segment *= taper;
+    }
+    reach_.push_back(reach);
+
+    // reaching for where the tip already is, so it holds still until given a target
+    target_x_.push_back(x_.back());
+    target_y_.push_back(y_.back());
+
+    return first_.size() - 1;
+}
+
+
+void IkSolver::Clear(void)
+{
+    x_.clear();
+    y_.clear();
+    length_.clear();
+    first_.clear();
+    segments_.clear();
+    reach_.clear();
+    root_x_.clear();
+    root_y_.clear();
+    target_x_.clear();
+    target_y_.clear();
+}
+
+
+void IkSolver::SetIterations(int iterations)
+{
+    if (iterations <= 0) {
+        throw(std::invalid_argument(std::string("IK needs at least one iteration")));
+    }
+    iterations_ = iterations;
+}
+
+
+void IkSolver::Solve(JobSystem *jobs, int grain)
+{
+    if (!jobs) {
+        for (int c = 0; c < GetChainCount(); c++) SolveChain(c);
+        return;
+    }
+
+    jobs->ParallelFor(GetChainCount(), grain, [&](int begin, int end) {
+        for (int c = begin; c < end; c++) SolveChain(c);
+    });
+}
+
+
+void IkSolver::SolveChain(int chain)
+{
+    float *x = x_.data() + first_[chain];
+    float *y = y_.data() + first_[chain];
+    const float *length = length_.data() + first_[chain];
+    int n = segments_[chain];
+
+    float root_x = root_x_[chain];
+    float root_y = root_y_[chain];
+    float target_x = target_x_[chain];
+    float target_y = target_y_[chain];
+
+    x[0] = root_x;
+    y[0] = root_y;
+
+    // out of reach, the best there is is the chain held straight out towards the target
+    float dx = target_x - root_x;
+    float dy = target_y - root_y;
+    if (dx * dx + dy * dy >= reach_[chain] * reach_[chain]) {
+        for (int j = 0; j < n; j++) {
+            x[j + 1] = target_x;
+            y[j + 1] = target_y;
+            Place(x[j], y[j], x[j + 1], y[j + 1], length[j]);
+        }
+        return;
+    }
+
+    for (int pass = 0; pass < iterations_; pass++) {
+        float tip_x = x[n] - target_x;
+        float tip_y = y[n] - target_y;
+        if (tip_x * tip_x + tip_y * tip_y <= tolerance_ * tolerance_) break;
+
+        // tip to root: the tip goes on the target and each joint follows the one after it
+        x[n] = target_x;
+        y[n] = target_y;
+        for (int j = n - 1; j >= 0; j--) Place(x[j + 1], y[j + 1], x[j], y[j], length[j]);
+
+        // root to tip: the root goes back where it belongs and each joint follows the one before it
+        x[0] = root_x;
+        y[0] = root_y;
+        for (int j = 0; j < n; j++) Place(x[j], y[j], x[j + 1], y[j + 1], length[j]);
+    }
+}
+
+
+void IkSolver::Save(Snapshot &snapshot) const
+{
+    snapshot.Put(static_cast<int>(first_.size()));
+    snapshot.PutArray(segments_.data(), segments_.size());
+    snapshot.PutArray(reach_.data(), reach_.size());
+    snapshot.PutArray(root_x_.data(), root_x_.size());
+    snapshot.PutArray(root_y_.data(), root_y_.size());
+    snapshot.PutArray(target_x_.data(), target_x_.size());
+    snapshot.PutArray(target_y_.data(), target_y_.size());
+
+    snapshot.Put(static_cast<int>(x_.size()));
+    snapshot.PutArray(x_.data(), x_.size());
+    snapshot.PutArray(y_.data(), y_.size());
+    snapshot.PutArray(length_.data(), length_.size());
+}
+
+
+void IkSolver::Load(Snapshot &snapshot)
+{
+    int chains = snapshot.Get<int>();
+    if (chains < 0 || chains > (snapshot.GetSize() - snapshot.GetPosition()) / sizeof(int)) {
+        throw(std::ios_base::failure(std::string("Snapshot is cut short")));
+    }
+    segments_.resize(chains);
+    reach_.resize(chains);
+    root_x_.resize(chains);
+    root_y_.resize(chains);
+    target_x_.resize(chains);
+    target_y_.resize(chains);
+    snapshot.GetArray(segments_.data(), chains);
+    snapshot.GetArray(reach_.data(), chains);
+    snapshot.GetArray(root_x_.data(), chains);
+    snapshot.GetArray(root_y_.data(), chains);
+    snapshot.GetArray(target_x_.data(), chains);
+    snapshot.GetArray(target_y_.data(), chains);
+
+    // the joints are read into the chains one after the other, so there have to be exactly enough for them
+    long long expected = 0;
+    for (int c = 0; c < chains; c++) {
+        if (segments_[c] <= 0) {
+            throw(std::ios_base::failure(std::string("Snapshot has a tentacle with no segments")));
+        }
+        expected += segments_[c] + 1;
+    }
+
+    int joints = snapshot.Get<int>();
+    if (joints != expected) {
+        throw(std::ios_base::failure(std::string("Snapshot's tentacle joints dont match its chains")));
+    }
+    x_.resize(joints);
+    y_.resize(joints);
+    length_.resize(joints);
+    snapshot.GetArray(x_.data(), joints);
+    snapshot.GetArray(y_.data(), joints);
+    snapshot.GetArray(length_.data(), joints);
+
+    // the chains sit one after the other, so where each starts follows from the segment counts
+    first_.resize(chains);
+    int first = 0;
+    for (int c = 0; c < chains; c++) {
+        first_[c] = first;
+        first += segments_[c] + 1;
+    }
+}
+
+} // namespace game
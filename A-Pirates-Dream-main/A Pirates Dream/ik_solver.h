@@ -0,0 +1,85 @@
+#ifndef IK_SOLVER_H_
+#define IK_SOLVER_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "job_system.h"
+
+namespace game {
+
+    class Snapshot;
+
+    /*
+        IkSolver bends chains of rigid segments (the kraken's tentacles) so each one's tip reaches for its
+        target while its root stays put, using FABRIK: walk the chain from the tip to the root pulling each
+        joint towards the one after it, then from the root back out to the tip, and repeat until the tip is
+        close enough. Each pass starts from where the chain was last tick, so it usually settles in one or two.
+
+        Every chain's joints sit in two flat arrays (x and y, chains one after the other) and the chains
+        never touch each other, so Solve() can hand them out to the job system's threads.
+    */
+    class IkSolver {
+
+        public:
+            IkSolver(void);
+
+            // Add a chain of segments joints lying straight out from root at angle, the first segment length long and
+            // each one after taper times the one before, returns the chain's index
+            int AddChain(const glm::vec3 &root, int segments, float length, float taper = 1.0f, float angle = 0.0f);
+
+            // Drop every chain
+            void Clear(void);
+
+            // Where a chain is fixed and what its tip reaches for, the chain only moves once Solve() runs
+            inline void SetRoot(int chain, const glm::vec3 &root) { root_x_[chain] = root.x; root_y_[chain] = root.y; }
+            inline void SetTarget(int chain, const glm::vec3 &target) { target_x_[chain] = target.x; target_y_[chain] = target.y; }
+
+            // Passes per chain per Solve() at most, and how close the tip has to get to stop early
+            void SetIterations(int iterations);
+            inline void SetTolerance(float tolerance) { tolerance_ = tolerance; }
+
+            // Solve every chain, spread across jobs' threads if given (chains per job is grain)
+            void Solve(JobSystem *jobs = NULL, int grain = 4);
+
+            // Solve one chain
+            void SolveChain(int chain);
+
+            inline int GetChainCount(void) const { return first_.size(); }
+            inline int GetSegmentCount(int chain) const { return segments_[chain]; }
+
+            // Joint j of a chain, 0 is the root and GetSegmentCount() the tip
+            inline glm::vec3 GetJoint(int chain, int j) const { return glm::vec3(x_[first_[chain] + j], y_[first_[chain] + j], 0.0f); }
+
+            // How long a chain's segment is, and how far the whole chain reaches
+            inline float GetLength(int chain, int segment) const { return length_[first_[chain] + segment]; }
+            inline float GetReach(int chain) const { return reach_[chain]; }
+
+            // Save and restore every chain's shape and where its root and target are
+            void Save(Snapshot &snapshot) const;
+            void Load(Snapshot &snapshot);
+
+        private:
+            // every chain's joints, a chain's run is first_ to first_ + segments_ inclusive
+            // length_[k] is the segment from joint k to joint k + 1 (unused for a tip)
+            std::vector<float> x_;
+            std::vector<float> y_;
+            std::vector<float> length_;
+
+            // per chain
+            std::vector<int> first_;
+            std::vector<int> segments_;
+            std::vector<float> reach_;
+            std::vector<float> root_x_;
+            std::vector<float> root_y_;
+            std::vector<float> target_x_;
+            std::vector<float> target_y_;
+
+            int iterations_;
+            float tolerance_;
+
+    }; // class IkSolver
+
+} // namespace game
+
+#endif // IK_SOLVER_H_
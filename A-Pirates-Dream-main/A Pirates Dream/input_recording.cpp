@@ -0,0 +1,152 @@
+#include <fstream>
+#include <stdexcept>
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "input_recording.h"
+
+namespace game {
+
+namespace {
+
+    const char file_magic_g[4] = { 'A', 'P', 'D', 'R' };
+    const unsigned int file_version_g = 1;
+
+    // Write and read a number a byte at a time, lowest byte first, so files work across machines
+    void WriteNumber(std::ofstream &f, unsigned long long value, int bytes)
+    {
+        for (int i = 0; i < bytes; i++) {
+            f.put(static_cast<char>((value >> (8 * i)) & 0xff));
+        }
+    }
+
+    unsigned long long ReadNumber(std::ifstream &f, int bytes, const std::string &filename)
+    {
+        unsigned long long value = 0;
+        for (int i = 0; i < bytes; i++) {
+            int c = f.get();
+            if (c == EOF) {
+                throw(std::ios_base::failure(std::string("Input recording ") + filename + " is cut short"));
+            }
+            value |= static_cast<unsigned long long>(c & 0xff) << (8 * i);
+        }
+        return value;
+    }
+
+} // namespace
+
+
+InputState PollInput(GLFWwindow *window)
+{
+    // which key drives which control
+    static const struct { int key; InputState button; } bindings[] = {
+        { GLFW_KEY_W, INPUT_FORWARD },
+        { GLFW_KEY_S, INPUT_BACK },
+        { GLFW_KEY_A, INPUT_TURN_LEFT },
+        { GLFW_KEY_D, INPUT_TURN_RIGHT },
+        { GLFW_KEY_Q, INPUT_STRAFE_LEFT },
+        { GLFW_KEY_E, INPUT_STRAFE_RIGHT },
+        { GLFW_KEY_SPACE, INPUT_FIRE },
+        { GLFW_KEY_LEFT_SHIFT, INPUT_MINE },
+        { GLFW_KEY_ESCAPE, INPUT_QUIT }
+    };
+
+    InputState input = 0;
+    for (int i = 0; i < sizeof(bindings) / sizeof(bindings[0]); i++) {
+        if (glfwGetKey(window, bindings[i].key) == GLFW_PRESS) input |= bindings[i].button;
+    }
+    return input;
+}
+
+
+InputRecording::InputRecording(void)
+{
+    seed_ = 0;
+    tick_rate_ = 60;
+}
+
+
+void InputRecording::Clear(void)
+{
+    input_.clear();
+}
+
+
+void InputRecording::Save(const std::string &filename) const
+{
+    std::ofstream f(filename.c_str(), std::ios::binary);
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+
+    f.write(file_magic_g, sizeof(file_magic_g));
+    WriteNumber(f, file_version_g, 2);
+    WriteNumber(f, tick_rate_, 4);
+    WriteNumber(f, seed_, 8);
+    WriteNumber(f, input_.size(), 4);
+
+    // count the runs first so a reader knows how many follow
+    unsigned int runs = 0;
+    for (int i = 0; i < input_.size(); i++) {
+        if (i == 0 || input_[i] != input_[i - 1]) runs++;
+    }
+    WriteNumber(f, runs, 4);
+
+    int start = 0;
+    while (start < input_.size()) {
+        int end = start + 1;
+        while (end < input_.size() && input_[end] == input_[start]) end++;
+        WriteNumber(f, input_[start], 2);
+        WriteNumber(f, end - start, 4);
+        start = end;
+    }
+
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error writing file ") + filename));
+    }
+}
+
+
+void InputRecording::Load(const std::string &filename)
+{
+    std::ifstream f(filename.c_str(), std::ios::binary);
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+
+    char magic[sizeof(file_magic_g)];
+    f.read(magic, sizeof(magic));
+    if (f.gcount() != sizeof(magic) || std::string(magic, sizeof(magic)) != std::string(file_magic_g, sizeof(file_magic_g))) {
+        throw(std::ios_base::failure(filename + " is not an input recording"));
+    }
+
+    unsigned int version = ReadNumber(f, 2, filename);
+    if (version != file_version_g) {
+        throw(std::ios_base::failure(filename + " is from a different version of the game"));
+    }
+
+    tick_rate_ = ReadNumber(f, 4, filename);
+    if (tick_rate_ <= 0) {
+        throw(std::ios_base::failure(std::string("Input recording ") + filename + " has no tick rate"));
+    }
+    seed_ = ReadNumber(f, 8, filename);
+    unsigned int ticks = ReadNumber(f, 4, filename);
+    unsigned int runs = ReadNumber(f, 4, filename);
+
+    input_.clear();
+    for (unsigned int r = 0; r < runs; r++) {
+        InputState input = ReadNumber(f, 2, filename);
+        unsigned int length = ReadNumber(f, 4, filename);
+        if (length > ticks - input_.size()) {
+            throw(std::ios_base::failure(std::string("Input recording ") + filename + " has more input than ticks"));
+        }
+        input_.insert(input_.end(), length, input);
+    }
+
+    if (input_.size() != ticks) {
+        throw(std::ios_base::failure(std::string("Input recording ") + filename + " is cut short"));
+    }
+}
+
+} // namespace game
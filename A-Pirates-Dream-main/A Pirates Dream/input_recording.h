@@ -0,0 +1,77 @@
+#ifndef INPUT_RECORDING_H_
+#define INPUT_RECORDING_H_
+
+#include <string>
+#include <vector>
+
+struct GLFWwindow;
+
+namespace game {
+
+    // One bit per control held down during a tick
+    enum InputButton {
+        INPUT_FORWARD = 1 << 0,
+        INPUT_BACK = 1 << 1,
+        INPUT_TURN_LEFT = 1 << 2,
+        INPUT_TURN_RIGHT = 1 << 3,
+        INPUT_STRAFE_LEFT = 1 << 4,
+        INPUT_STRAFE_RIGHT = 1 << 5,
+        INPUT_FIRE = 1 << 6,
+        INPUT_MINE = 1 << 7,
+        INPUT_QUIT = 1 << 8
+    };
+
+    // Every control's state for one tick, a mix of InputButton bits
+    typedef unsigned short InputState;
+
+    // Read the keyboard into an InputState
+    InputState PollInput(GLFWwindow *window);
+
+    /*
+        InputRecording is the input for every tick of a game along with the seed and tick rate it ran with,
+        which is everything needed to play the same game out again. Record a live game tick by tick and
+        Save() it, or Load() one and Get() each tick's input back.
+
+        Files are little endian binary: "APDR", a version, the tick rate, the seed and the tick count, then the
+        input as (state, number of ticks) runs, since held keys repeat for many ticks in a row.
+    */
+    class InputRecording {
+
+        public:
+            InputRecording(void);
+
+            // Forget the input (keeps the seed and tick rate)
+            void Clear(void);
+
+            // Drop the input after the first ticks, for when the game rolls back to an earlier tick
+            inline void Truncate(long ticks) { if (ticks < input_.size()) input_.resize(ticks); }
+
+            // Add the next tick's input
+            inline void Record(InputState input) { input_.push_back(input); }
+
+            // Input for a tick, nothing is held after the end of the recording
+            inline InputState Get(long tick) const { return (tick >= 0 && tick < input_.size()) ? input_[tick] : 0; }
+
+            // Number of ticks recorded
+            inline long GetTickCount(void) const { return input_.size(); }
+
+            // What the game was run with
+            inline unsigned long long GetSeed(void) const { return seed_; }
+            inline void SetSeed(unsigned long long seed) { seed_ = seed; }
+            inline long GetTickRate(void) const { return tick_rate_; }
+            inline void SetTickRate(long tick_rate) { tick_rate_ = tick_rate; }
+
+            // Write to and read from a file, these throw if the file cant be opened or isnt a recording
+            void Save(const std::string &filename) const;
+            void Load(const std::string &filename);
+
+        private:
+            std::vector<InputState> input_;
+            unsigned long long seed_;
+            long tick_rate_;
+
+    }; // class InputRecording
+
+} // namespace game
+
+#endif // INPUT_RECORDING_H_
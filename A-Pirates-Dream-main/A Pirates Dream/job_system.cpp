@@ -0,0 +1,228 @@
+#include <algorithm>
+
+#include "job_system.h"
+
+namespace game {
+
+// jobs each queue can hold, a ParallelFor with more chunks than this runs the extras itself
+const int queue_capacity_g = 1024;
+
+// the job system the current thread is working for and the queue it uses there (0 for outside callers)
+static thread_local const JobSystem *current_system_g = NULL;
+static thread_local int current_queue_g = 0;
+
+
+JobSystem::JobSystem(int threads)
+{
+    if (threads <= 0) {
+        threads = std::thread::hardware_concurrency();
+        if (threads <= 0) threads = 1;
+    }
+
+    queued_ = 0;
+    stop_ = false;
+
+    for (int i = 0; i < threads; i++) {
+        Queue *queue = new Queue();
+        queue->jobs.resize(queue_capacity_g);
+        queue->head = 0;
+        queue->size = 0;
+        queues_.push_back(queue);
+    }
+
+    for (int i = 1; i < threads; i++) {
+        workers_.push_back(std::thread(&JobSystem::WorkerLoop, this, i));
+    }
+}
+
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+
+    for (int i = 0; i < workers_.size(); i++) {
+        workers_[i].join();
+    }
+
+    for (int i = 0; i < queues_.size(); i++) {
+        delete queues_[i];
+    }
+}
+
+
+int JobSystem::GetThreadIndex(void) const
+{
+    return (current_system_g == this) ? current_queue_g : 0;
+}
+
+
+void JobSystem::Run(int count, int grain, Function function, const void *context)
+{
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+
+    // not worth waking anyone for
+    if (workers_.empty() || count <= grain) {
+        function(context, 0, count);
+        return;
+    }
+
+    int queue = GetThreadIndex();
+
+    // outside threads all use queue 0, so they take turns
+    // a thread thats already inside one of our ParallelFors (a nested call) already has its turn
+    const JobSystem *outer_system = current_system_g;
+    int outer_queue = current_queue_g;
+    std::unique_lock<std::mutex> caller_lock(caller_mutex_, std::defer_lock);
+    if (outer_system != this) {
+        caller_lock.lock();
+        current_system_g = this;
+        current_queue_g = 0;
+    }
+
+    // aim for a few chunks per thread so stealing has something to even out, but no smaller than grain
+    int chunks = std::min((count + grain - 1) / grain, GetThreadCount() * 4);
+    int chunk_size = (count + chunks - 1) / chunks;
+
+    std::atomic<int> remaining(0);
+    int overflow_begin = count;
+
+    for (int begin = 0; begin < count; begin += chunk_size) {
+        Job job;
+        job.function = function;
+        job.context = context;
+        job.begin = begin;
+        job.end = std::min(count, begin + chunk_size);
+        job.remaining = &remaining;
+
+        remaining++;
+        if (!Push(queue, job)) {
+            // queue full, whatever is left we run ourselves below
+            remaining--;
+            overflow_begin = begin;
+            break;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    wake_.notify_all();
+
+    if (overflow_begin < count) {
+        function(context, overflow_begin, count);
+    }
+
+    // help out until every chunk of ours is done, this may run other callers' jobs too which is fine
+    Job job;
+    while (remaining.load() > 0) {
+        if (FindJob(queue, job)) {
+            Execute(job);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+
+    if (outer_system != this) {
+        current_system_g = outer_system;
+        current_queue_g = outer_queue;
+    }
+}
+
+
+bool JobSystem::Push(int index, const Job &job)
+{
+    Queue &queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.size == queue.jobs.size()) return false;
+
+    int slot = (queue.head + queue.size) % queue.jobs.size();
+    queue.jobs[slot] = job;
+    queue.size++;
+
+    queued_++;
+    return true;
+}
+
+
+bool JobSystem::Pop(int index, Job &job)
+{
+    Queue &queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.size == 0) return false;
+
+    // newest first, its the one most likely to still be in cache
+    queue.size--;
+    int slot = (queue.head + queue.size) % queue.jobs.size();
+    job = queue.jobs[slot];
+
+    queued_--;
+    return true;
+}
+
+
+bool JobSystem::Steal(int index, Job &job)
+{
+    Queue &queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.size == 0) return false;
+
+    // oldest first, the far end from where the owner is working
+    int slot = queue.head;
+    job = queue.jobs[slot];
+    queue.head = (queue.head + 1) % queue.jobs.size();
+    queue.size--;
+
+    queued_--;
+    return true;
+}
+
+
+bool JobSystem::FindJob(int queue, Job &job)
+{
+    if (Pop(queue, job)) return true;
+
+    // try everyone else, starting next to us so threads dont all pile onto the same victim
+    int n = queues_.size();
+    for (int k = 1; k < n; k++) {
+        if (Steal((queue + k) % n, job)) return true;
+    }
+    return false;
+}
+
+
+void JobSystem::Execute(const Job &job)
+{
+    job.function(job.context, job.begin, job.end);
+    (*job.remaining)--;
+}
+
+
+void JobSystem::WorkerLoop(int queue)
+{
+    current_system_g = this;
+    current_queue_g = queue;
+
+    Job job;
+    while (true) {
+        if (FindJob(queue, job)) {
+            Execute(job);
+            continue;
+        }
+
+        // nothing anywhere, sleep until someone queues work or we're shutting down
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_.wait(lock, [this] { return stop_ || queued_.load() > 0; });
+        if (stop_) return;
+    }
+}
+
+} // namespace game
@@ -0,0 +1,109 @@
+#ifndef JOB_SYSTEM_H_
+#define JOB_SYSTEM_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace game {
+
+    /*
+        JobSystem runs work on a fixed pool of worker threads.
+        Every thread (the workers, plus whichever thread calls ParallelFor) has its own queue of jobs. A thread
+        works through its own queue from the back and, once that runs dry, steals from the front of the others,
+        so an uneven split evens itself out without anyone handing work around.
+
+        ParallelFor cuts a range into chunks, queues them, and helps run them until they are all done, so the
+        caller sees an ordinary blocking loop. Queues are fixed size and jobs are plain structs, so running jobs
+        never allocates.
+    */
+    class JobSystem {
+
+        public:
+            // threads counts the calling thread too, so 1 runs everything inline and 0 means one per hardware thread
+            JobSystem(int threads = 0);
+            ~JobSystem();
+
+            // How many threads share the work (workers plus the caller)
+            inline int GetThreadCount(void) const { return workers_.size() + 1; }
+
+            // Which thread this is, from 0 to GetThreadCount() - 1, threads that aren't workers are all 0
+            // Inside a ParallelFor body this picks out per thread scratch space
+            int GetThreadIndex(void) const;
+
+            // Call body(begin, end) over chunks of about grain items covering [0, count), returns once all have run
+            // Chunks run on any thread in any order, so body must only touch what belongs to its own items
+            template <class F>
+            void ParallelFor(int count, int grain, const F &body)
+            {
+                Run(count, grain, &Invoke<F>, &body);
+            }
+
+        private:
+            typedef void (*Function)(const void *context, int begin, int end);
+
+            struct Job {
+                Function function;
+                const void *context;
+                int begin;
+                int end;
+                // counts down as the ParallelFor's chunks finish
+                std::atomic<int> *remaining;
+            };
+
+            // A thread's queue, a fixed ring with the owner at the back and thieves at the front
+            struct Queue {
+                std::mutex mutex;
+                std::vector<Job> jobs;
+                int head;
+                int size;
+            };
+
+            template <class F>
+            static void Invoke(const void *context, int begin, int end)
+            {
+                (*static_cast<const F*>(context))(begin, end);
+            }
+
+            // Queue the chunks of one ParallelFor and help until theyre done
+            void Run(int count, int grain, Function function, const void *context);
+
+            // Queue operations, they return false when the queue is full or empty
+            bool Push(int queue, const Job &job);
+            bool Pop(int queue, Job &job);
+            bool Steal(int queue, Job &job);
+
+            // Find a job for the given thread: its own queue first, then the others
+            bool FindJob(int queue, Job &job);
+
+            // Run one job and count it off
+            void Execute(const Job &job);
+
+            // What the worker threads do until shutdown
+            void WorkerLoop(int queue);
+
+            std::vector<std::thread> workers_;
+
+            // queue 0 belongs to outside callers, 1.. to the workers
+            std::vector<Queue*> queues_;
+
+            // jobs sitting in any queue, workers sleep while this is zero
+            std::atomic<int> queued_;
+            std::mutex sleep_mutex_;
+            std::condition_variable wake_;
+            bool stop_;
+
+            // outside callers share queue 0, so only one ParallelFor from outside the pool at a time
+            std::mutex caller_mutex_;
+
+            // a job system owns threads, so it cant be copied
+            JobSystem(const JobSystem &);
+            JobSystem &operator=(const JobSystem &);
+
+    }; // class JobSystem
+
+} // namespace game
+
+#endif // JOB_SYSTEM_H_
@@ -0,0 +1,101 @@
+#include <stdexcept>
+#include <string>
+
+#include "lod_scheduler.h"
+
+namespace game {
+
+LodScheduler::LodScheduler(float near_distance)
+{
+    enabled_ = true;
+    centre_ = glm::vec3(0.0f);
+    tick_ = 0;
+    for (int t = 0; t < NUM_TIERS; t++) {
+        tick_updated_[t] = 0;
+        tick_skipped_[t] = 0;
+    }
+    ResetTotals();
+    Configure(near_distance);
+}
+
+
+void LodScheduler::Configure(float near_distance)
+{
+    if (!(near_distance > 0.0f)) {
+        throw(std::invalid_argument(std::string("The full rate LOD distance has to be positive")));
+    }
+    near_distance_ = near_distance;
+}
+
+
+void LodScheduler::BeginTick(const glm::vec3 &centre, long tick)
+{
+    // the last tick is done with, so it goes into the totals
+    for (int t = 0; t < NUM_TIERS; t++) {
+        total_updated_[t] += tick_updated_[t];
+        total_skipped_[t] += tick_skipped_[t];
+        tick_updated_[t] = 0;
+        tick_skipped_[t] = 0;
+    }
+    total_ticks_++;
+
+    centre_ = centre;
+    tick_ = tick;
+}
+
+
+void LodScheduler::Count(const int *updated, const int *skipped)
+{
+    for (int t = 0; t < NUM_TIERS; t++) {
+        if (updated[t]) tick_updated_[t] += updated[t];
+        if (skipped[t]) tick_skipped_[t] += skipped[t];
+    }
+}
+
+
+void LodScheduler::ResetTotals(void)
+{
+    for (int t = 0; t < NUM_TIERS; t++) {
+        total_updated_[t] = 0;
+        total_skipped_[t] = 0;
+    }
+
+    // BeginTick counts the tick before it, which the totals only start with from the next one
+    total_ticks_ = -1;
+}
+
+
+void LodScheduler::Print(std::ostream &out) const
+{
+    // the tick that's just run hasnt been folded in yet
+    long long updated[NUM_TIERS];
+    long long skipped[NUM_TIERS];
+    long long all_updated = 0;
+    long long all_skipped = 0;
+    for (int t = 0; t < NUM_TIERS; t++) {
+        updated[t] = total_updated_[t] + tick_updated_[t];
+        skipped[t] = total_skipped_[t] + tick_skipped_[t];
+        all_updated += updated[t];
+        all_skipped += skipped[t];
+    }
+    long ticks = total_ticks_ + 1;
+
+    // averages to a tenth, whatever whoever printed last left the stream on
+    std::streamsize precision = out.precision(1);
+    std::ios_base::fmtflags flags = out.flags(std::ios_base::dec | std::ios_base::fixed);
+
+    out << "Enemy LOD: per tick on average";
+    for (int t = 0; t < NUM_TIERS; t++) {
+        out << (t ? ", " : " ") << (ticks > 0 ? static_cast<double>(updated[t] + skipped[t]) / ticks : 0.0);
+        out << (t ? " at 1/" + std::to_string(1 << t) : std::string(" at full rate"));
+    }
+    out << " (full rate within " << static_cast<int>(near_distance_) << " of the player), " << all_skipped << " of "
+        << all_updated + all_skipped << " updates skipped";
+    if (all_updated + all_skipped > 0) out << " (" << 100.0 * all_skipped / (all_updated + all_skipped) << "%)";
+    out << std::endl;
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+} // namespace game
@@ -0,0 +1,107 @@
+#ifndef LOD_SCHEDULER_H_
+#define LOD_SCHEDULER_H_
+
+#include <atomic>
+#include <ostream>
+#include <glm/glm.hpp>
+
+namespace game {
+
+    /*
+        LodScheduler decides how often far away objects get updated. Everything within near_distance of the
+        player is in tier 0 and updates every tick, out to twice that is tier 1 and updates every 2nd tick,
+        out to four times that every 4th and anything further every 8th. An object that gets left out keeps
+        count of the ticks it missed and its next update catches up on all of them at once, so it's only worth
+        putting in a tier above 0 if it can do that cheaply and exactly (the game only does it for patrolling
+        enemies, whose patrol is worked out from the time alone). Until then it stays where it last updated.
+
+        Objects in the same tier are spread over the ticks by their slot, so a crowd far away costs an even
+        eighth every tick instead of all of it every eighth tick. It also counts how many objects each tier
+        had and how many updates that saved, for the HUD and the headless report.
+    */
+    class LodScheduler {
+
+        public:
+            // full rate, 1/2, 1/4 and 1/8
+            enum { NUM_TIERS = 4 };
+
+            // Full rate within near_distance of the player, throws if it isnt positive
+            LodScheduler(float near_distance = 8.0f);
+
+            // Change the full rate distance, throws if it isnt positive
+            void Configure(float near_distance);
+
+            // Whether far objects update less often at all, when off everything is tier 0
+            inline bool IsEnabled(void) const { return enabled_; }
+            inline void SetEnabled(bool enabled) { enabled_ = enabled; }
+
+            inline float GetNearDistance(void) const { return near_distance_; }
+
+            // Start a tick: the tiers are measured from centre, and the last tick's counts start again from 0
+            void BeginTick(const glm::vec3 &centre, long tick);
+
+            // The tier a position is in this tick
+            inline int Tier(const glm::vec3 &position) const
+            {
+                if (!enabled_) return 0;
+                float dx = position.x - centre_.x;
+                float dy = position.y - centre_.y;
+                float distance_sq = dx * dx + dy * dy;
+
+                // every tier reaches twice as far as the one before, so four times as far squared
+                int tier = 0;
+                float edge_sq = near_distance_ * near_distance_;
+                while (tier < NUM_TIERS - 1 && distance_sq > edge_sq) {
+                    tier++;
+                    edge_sq *= 4.0f;
+                }
+                return tier;
+            }
+
+            // Whether something in tier updates this tick, slot (anything that stays the same for the object's life)
+            // picks which of the tier's ticks it gets
+            inline bool IsDue(int tier, int slot) const { return ((tick_ + slot) & ((1 << tier) - 1)) == 0; }
+
+            // Add one batch's updates and skips per tier, any thread can call this
+            void Count(const int *updated, const int *skipped);
+
+            // Objects in tier, and the updates done and saved, over the last tick
+            inline int GetTierCount(int tier) const { return tick_updated_[tier] + tick_skipped_[tier]; }
+            inline int GetUpdated(void) const { return Sum(tick_updated_); }
+            inline int GetSkipped(void) const { return Sum(tick_skipped_); }
+
+            // Start the run's totals again
+            void ResetTotals(void);
+
+            // Print the run's average tier populations and the share of updates saved on one line
+            void Print(std::ostream &out) const;
+
+        private:
+            static inline int Sum(const std::atomic<int> *counts)
+            {
+                int sum = 0;
+                for (int t = 0; t < NUM_TIERS; t++) sum += counts[t];
+                return sum;
+            }
+
+            float near_distance_;
+            bool enabled_;
+
+            // where the tiers are measured from and the tick it is, for this tick
+            glm::vec3 centre_;
+            long tick_;
+
+            // this tick's counts, added to from the update threads
+            std::atomic<int> tick_updated_[NUM_TIERS];
+            std::atomic<int> tick_skipped_[NUM_TIERS];
+
+            // the run's counts, folded in at the start of every tick
+            long long total_updated_[NUM_TIERS];
+            long long total_skipped_[NUM_TIERS];
+            long total_ticks_;
+
+    }; // class LodScheduler
+
+} // namespace game
+
+#endif // LOD_SCHEDULER_H_
@@ -16,26 +16,31 @@
 #include <iostream>
 #include <exception>
 #include "game.h"
+#include "game_config.h"
 
 // Macro for printing exceptions
 #define PrintException(exception_object)\
     std::cerr << exception_object.what() << std::endl
 
 // Main function that builds and runs the game
-int main(void){
+// Pass --headless --ticks N to run the simulation without a window and print its cost
+int main(int argc, char **argv){
     game::Game the_game;
 
     try {
+        // Read the run options
+        game::GameConfig config = game::ParseCommandLine(argc, argv);
         // Initialize graphics libraries and main window
-        the_game.Init();
+        the_game.Init(config);
         // Setup the game (game world, game objects, etc.)
         the_game.Setup();
         // Run the game
         the_game.MainLoop();
     }
     catch (std::exception &e){
-        // Catch and print any errors
+        // Catch and print any errors, and let whoever ran us (a script comparing replays, say) know it failed
         PrintException(e);
+        return 1;
     }
 
     return 0;
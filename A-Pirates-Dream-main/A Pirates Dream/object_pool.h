@@ -0,0 +1,131 @@
+#ifndef OBJECT_POOL_H_
+#define OBJECT_POOL_H_
+
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace game {
+
+    /*
+        ObjectPool is a fixed number of preallocated slots for objects of one type.
+        Acquire() builds an object in a free slot and Release() tears it down and hands the slot back, so
+        objects that come and go all game (bullets, explosions, ...) never touch the heap after startup.
+        When every slot is taken Acquire() returns NULL, the caller decides whether to skip or wait.
+    */
+    template <class T>
+    class ObjectPool {
+
+        public:
+            ObjectPool(int capacity)
+            {
+                if (capacity <= 0) {
+                    throw(std::invalid_argument(std::string("Object pool capacity must be positive")));
+                }
+
+                blocks_.resize(capacity);
+                in_use_flags_.assign(capacity, false);
+
+                // hand slots out from the front first
+                for (int i = capacity - 1; i >= 0; i--) {
+                    free_.push_back(i);
+                }
+
+                in_use_ = 0;
+                high_water_ = 0;
+                failed_ = 0;
+            }
+
+            ~ObjectPool()
+            {
+                // anything still out dies with the pool
+                for (int i = 0; i < blocks_.size(); i++) {
+                    if (in_use_flags_[i]) reinterpret_cast<T*>(blocks_[i].bytes)->~T();
+                }
+            }
+
+            // Build an object in a free slot, NULL if the pool is full
+            template <class... Args>
+            T *Acquire(Args&&... args)
+            {
+                if (free_.empty()) {
+                    failed_++;
+                    return NULL;
+                }
+
+                int index = free_.back();
+                T *object = new (blocks_[index].bytes) T(std::forward<Args>(args)...);
+                free_.pop_back();
+                in_use_flags_[index] = true;
+
+                in_use_++;
+                if (in_use_ > high_water_) high_water_ = in_use_;
+
+                return object;
+            }
+
+            // Grow the pool to at least capacity slots, only while nothing is out since the slots may move
+            void Reserve(int capacity)
+            {
+                if (in_use_ > 0) {
+                    throw(std::logic_error(std::string("Object pool can only grow while it is empty")));
+                }
+                if (capacity <= blocks_.size()) return;
+
+                blocks_.resize(capacity);
+                in_use_flags_.assign(capacity, false);
+                free_.clear();
+                for (int i = capacity - 1; i >= 0; i--) {
+                    free_.push_back(i);
+                }
+            }
+
+            // Destroy an object from this pool and free its slot
+            void Release(T *object)
+            {
+                int index = reinterpret_cast<Block*>(object) - blocks_.data();
+                if (index < 0 || index >= blocks_.size() || !in_use_flags_[index]) {
+                    throw(std::invalid_argument(std::string("Released an object that did not come from this pool")));
+                }
+
+                object->~T();
+                in_use_flags_[index] = false;
+                free_.push_back(index);
+                in_use_--;
+            }
+
+            // Stats
+            inline int GetCapacity(void) const { return blocks_.size(); }
+            inline int GetInUse(void) const { return in_use_; }
+            // the most objects that were ever out at once
+            inline int GetHighWater(void) const { return high_water_; }
+            // how many times Acquire() found the pool full
+            inline int GetFailed(void) const { return failed_; }
+
+        private:
+            // raw memory for one object
+            struct Block {
+                alignas(T) unsigned char bytes[sizeof(T)];
+            };
+
+            std::vector<Block> blocks_;
+            std::vector<bool> in_use_flags_;
+
+            // free slot indices, used as a stack
+            std::vector<int> free_;
+
+            int in_use_;
+            int high_water_;
+            int failed_;
+
+            // the pool owns live objects, so it cant be copied
+            ObjectPool(const ObjectPool &);
+            ObjectPool &operator=(const ObjectPool &);
+
+    }; // class ObjectPool
+
+} // namespace game
+
+#endif // OBJECT_POOL_H_
@@ -6,10 +6,27 @@
 
 namespace game {
 
-ParticleSystem::ParticleSystem(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture, GameObject *parent)
+ParticleSystem::ParticleSystem(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture, const EntityTable *parents, EntityHandle parent)
 	: GameObject(position, geom, shader, texture){
 
+    parents_ = parents;
     parent_ = parent;
+
+    // our transform hangs off the parent's, so we move and turn with it
+    SetTransformParent(parents_->Lookup(parent_));
+}
+
+
+ParticleSystem::ParticleSystem(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture)
+	: GameObject(position, geom, shader, texture){
+
+    parents_ = NULL;
+}
+
+
+bool ParticleSystem::IsOrphaned(void) const {
+
+    return parents_ && !parents_->Lookup(parent_);
 }
 
 
@@ -20,7 +37,10 @@ void ParticleSystem::Update(double delta_time) {
 }
 
 
-void ParticleSystem::Render(glm::mat4 view_matrix, double current_time){
+void ParticleSystem::Render(glm::mat4 view_matrix, double current_time, float alpha){
+
+    // nothing to follow anymore, the game removes us at the end of the tick
+    if (IsOrphaned()) return;
 
     // Set up the shader
     shader_->Enable();
@@ -28,25 +48,8 @@ void ParticleSystem::Render(glm::mat4 view_matrix, double current_time){
     // Set up the view matrix
     shader_->SetUniformMat4("view_matrix", view_matrix);
 
-    // Setup the scaling matrix for the shader
-    glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale_, scale_, 1.0));
-
-    // Setup the rotation matrix for the shader
-    glm::mat4 rotation_matrix = glm::rotate(glm::mat4(1.0f), angle_, glm::vec3(0.0, 0.0, 1.0));
-
-    // Set up the translation matrix for the shader
-    glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), position_);
-
-    // Set up the parent transformation matrix
-    glm::mat4 parent_rotation_matrix = glm::rotate(glm::mat4(1.0f), parent_->GetRotation(), glm::vec3(0.0, 0.0, 1.0));
-    glm::mat4 parent_translation_matrix = glm::translate(glm::mat4(1.0f), parent_->GetPosition());
-    glm::mat4 parent_transformation_matrix = parent_translation_matrix * parent_rotation_matrix;
-
-    // Setup the transformation matrix for the shader
-    glm::mat4 transformation_matrix = parent_transformation_matrix * translation_matrix * rotation_matrix * scaling_matrix;
-
-    // Set the transformation matrix in the shader
-    shader_->SetUniformMat4("transformation_matrix", transformation_matrix);
+    // Set the transformation matrix in the shader, the parent's translation and rotation come with it from the transform store
+    shader_->SetUniformMat4("transformation_matrix", GetTransformation(alpha));
 
     // Set the time in the shader
     shader_->SetUniform1f("time", current_time);
@@ -59,6 +62,7 @@ void ParticleSystem::Render(glm::mat4 view_matrix, double current_time){
 
     // Draw the entity
     glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+    draw_calls_++;
 }
 
 } // namespace game
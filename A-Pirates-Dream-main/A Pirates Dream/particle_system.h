@@ -2,6 +2,7 @@
 #define PARTICLE_SYSTEM_H_
 
 #include "game_object.h"
+#include "entity_map.h"
 
 namespace game {
 
@@ -9,16 +10,26 @@ namespace game {
     class ParticleSystem : public GameObject {
 
         public:
-            ParticleSystem(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture, GameObject *parent);
+            // A system that follows the object parent refers to in parents, its position is relative to that object
+            ParticleSystem(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture, const EntityTable *parents, EntityHandle parent);
+
+            // A system that stays where it is put (explosions), its position is in world space
+            ParticleSystem(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture);
 
             void Update(double delta_time) override;
 
-            void Render(glm::mat4 view_matrix, double current_time);
+            void Render(glm::mat4 view_matrix, double current_time, float alpha = 1.0f) override;
+
+            // true once the object this system follows has been destroyed
+            bool IsOrphaned(void) const;
 
-            inline void GetParent(GameObject **parent) { *parent =  parent_; }
+            // The object this system follows
+            inline EntityHandle GetParent(void) const { return parent_; }
 
         private:
-            GameObject *parent_;
+            // where to find the parent, NULL if the system has no parent
+            const EntityTable *parents_;
+            EntityHandle parent_;
 
     }; // class ParticleSystem
 
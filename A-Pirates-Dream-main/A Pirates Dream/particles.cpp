@@ -3,6 +3,7 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "particles.h"
+#include "random_streams.h"
 
 namespace game {
 
@@ -19,11 +20,9 @@ Particles::Particles(const glm::vec3 &color_value, float spread, float length, f
 }
 
 
-void Particles::CreateGeometry(void)
+void Particles::BuildVertices(std::vector<GLfloat> &particles, int count) const
 {
 
-    // Each particle is a square with four vertices and two triangles
-
     // Number of attributes for vertices and faces
     const int vertex_attr = 10;  // 7 attributes per vertex: 2D (or 3D) position (2), direction (2), 2D texture coordinates (2), time (1)
                                 //    const int face_att = 3; // Vertex indices (3)
@@ -38,19 +37,16 @@ void Particles::CreateGeometry(void)
         -0.5f, -0.5f,    1.0f, 1.0f, 1.0f,    0.0f, 1.0f  // Bottom-left
     };
 
-    // Two triangles referencing the vertices
-    GLuint face[] = {
-        0, 1, 2, // t1
-        2, 3, 0  // t2
-    };
-
     // Initialize all the particle vertices
-    GLfloat particles[NUM_PARTICLES * vertex_attr];
+    particles.resize(count * vertex_attr);
     float theta, r, tmod;
     float pi = glm::pi<float>();
     float two_pi = 2.0f*pi;
 
-    for (int i = 0; i < NUM_PARTICLES; i++){
+    // particle effects draw from their own stream so they dont change what spawns
+    Random &fx = RandomStreams::Default().Get(RandomStreams::FX);
+
+    for (int i = 0; i < count; i++){
         // Check if we are initializing a new particle
         //
         // A particle has four vertices, so every four vertices we need
@@ -58,9 +54,9 @@ void Particles::CreateGeometry(void)
         if (i % 4 == 0){
             // Get three random values
             //theta = (two_pi*(rand() % 1000) / 1000.0f);
-            theta = (2.0*(rand() % 10000) / 10000.0f -1.0f)*spread_ + pi;
-            r = 0.0f + 0.4*(rand() % 10000) / 10000.0f;
-            tmod = (rand() % 10000) / (t_ * 10000.0f);
+            theta = fx.Range(-1.0f, 1.0f)*spread_ + pi;
+            r = 0.0f + 0.4f*fx.Float();
+            tmod = fx.Float() / t_;
         }
 
         // Copy position from standard sprite
@@ -82,6 +78,23 @@ void Particles::CreateGeometry(void)
         particles[i*vertex_attr + 8] = color_value_.y;
         particles[i*vertex_attr + 9] = color_value_.z;
     }
+}
+
+
+void Particles::CreateGeometry(void)
+{
+
+    // Each particle is a square with four vertices and two triangles
+
+    // Initialize all the particle vertices
+    std::vector<GLfloat> particles;
+    BuildVertices(particles, NUM_PARTICLES);
+
+    // Two triangles referencing the vertices
+    GLuint face[] = {
+        0, 1, 2, // t1
+        2, 3, 0  // t2
+    };
 
     // Initialize all the particle faces
     GLuint manyfaces[NUM_PARTICLES * 6];
@@ -95,7 +108,7 @@ void Particles::CreateGeometry(void)
     // Create buffer for vertices
     glGenBuffers(1, &vbo_);
     glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(particles), particles, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, particles.size() * sizeof(GLfloat), particles.data(), GL_STATIC_DRAW);
 
     // Create buffer for faces (index buffer)
     glGenBuffers(1, &ebo_);
@@ -1,6 +1,8 @@
 #ifndef PARTICLES_H_
 #define PARTICLES_H_
 
+#include <vector>
+
 #include "geometry.h"
 
 #define NUM_PARTICLES 4000
@@ -16,6 +18,9 @@ namespace game {
             // Create the geometry (called once)
             void CreateGeometry(void);
 
+            // Fill in count particle vertices (10 floats each) with random directions and phases, the CPU half of CreateGeometry
+            void BuildVertices(std::vector<GLfloat> &particles, int count) const;
+
             // Use the geometry
             void SetGeometry(GLuint shader_program);
 
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <cmath>
+
+#include "perf_hud.h"
+
+namespace game {
+
+const double PerfHud::refresh_seconds_ = 0.5;
+
+namespace {
+
+    // Where the column sits with the camera left out: the left edge of the screen, under the health
+    const float left_g = -5.0f;
+    const float top_g = 2.9f;
+    const float row_height_g = 0.32f;
+    const float digit_width_g = 0.22f;
+    const float digit_scale_g = 0.3f;
+
+    // Numbers are right aligned in this many digits, anything bigger shows as all nines
+    const int num_digits_g = 6;
+
+} // namespace
+
+
+PerfHud::PerfHud(void)
+{
+    stamp_ = NULL;
+    visible_ = false;
+    frame_ms_.assign(window_frames_, 0.0);
+    update_ms_.assign(window_frames_, 0.0);
+    render_ms_.assign(window_frames_, 0.0);
+    next_ = 0;
+    frames_ = 0;
+    draw_calls_ = 0;
+    for (int r = 0; r < NUM_ROWS; r++) {
+        icons_[r] = 0;
+        counts_[r] = 0;
+        values_[r] = 0;
+    }
+    for (int d = 0; d < 10; d++) {
+        digits_[d] = 0;
+    }
+    until_refresh_ = 0.0;
+}
+
+
+PerfHud::~PerfHud()
+{
+    delete stamp_;
+}
+
+
+void PerfHud::Init(Geometry *geom, Shader *shader, const GLuint *digits)
+{
+    for (int d = 0; d < 10; d++) {
+        digits_[d] = digits[d];
+    }
+    stamp_ = new GameObject(glm::vec3(0.0f, 0.0f, 0.0f), geom, shader, digits_[0]);
+    stamp_->SetScale(digit_scale_g);
+}
+
+
+void PerfHud::SetIcon(Row row, GLuint texture)
+{
+    icons_[row] = texture;
+}
+
+
+void PerfHud::AddFrame(double frame_ms, double update_ms, double render_ms, long draw_calls)
+{
+    frame_ms_[next_] = frame_ms;
+    update_ms_[next_] = update_ms;
+    render_ms_[next_] = render_ms;
+    next_ = (next_ + 1) % window_frames_;
+    if (frames_ < window_frames_) frames_++;
+    draw_calls_ = draw_calls;
+
+    until_refresh_ -= frame_ms / 1000.0;
+    if (until_refresh_ <= 0.0) {
+        Refresh();
+        until_refresh_ = refresh_seconds_;
+    }
+}
+
+
+void PerfHud::Refresh(void)
+{
+    if (frames_ == 0) return;
+
+    double total_ms = 0.0;
+    double update_total = 0.0;
+    double render_total = 0.0;
+    sorted_.assign(frame_ms_.begin(), frame_ms_.begin() + frames_);
+    for (int i = 0; i < frames_; i++) {
+        total_ms += frame_ms_[i];
+        update_total += update_ms_[i];
+        render_total += render_ms_[i];
+    }
+    std::sort(sorted_.begin(), sorted_.end());
+
+    // nearest rank, so p99 of a couple of seconds is the worst frame or close to it
+    const double fractions[] = { 0.5, 0.95, 0.99 };
+    for (int p = 0; p < 3; p++) {
+        int rank = static_cast<int>(std::ceil(fractions[p] * frames_)) - 1;
+        values_[FRAME_P50 + p] = static_cast<long>(sorted_[std::max(rank, 0)] * 1000.0 + 0.5);
+    }
+
+    values_[FPS] = (total_ms > 0.0) ? static_cast<long>(frames_ * 1000.0 / total_ms + 0.5) : 0;
+    values_[UPDATE_US] = static_cast<long>(update_total * 1000.0 / frames_ + 0.5);
+    values_[RENDER_US] = static_cast<long>(render_total * 1000.0 / frames_ + 0.5);
+    values_[DRAW_CALLS] = draw_calls_;
+    for (int r = DRAWN; r < NUM_ROWS; r++) {
+        values_[r] = counts_[r];
+    }
+}
+
+
+void PerfHud::Render(const glm::mat4 &view_matrix, double current_time)
+{
+    if (!visible_ || !stamp_) return;
+
+    // the stamp moves between draws, so it renders at alpha 1 to skip blending from where it was last tick
+    for (int r = 0; r < NUM_ROWS; r++) {
+        float y = top_g - r * row_height_g;
+
+        if (icons_[r]) {
+            stamp_->SetTexture(icons_[r]);
+            stamp_->SetPosition(glm::vec3(left_g, y, 0.0f));
+            stamp_->Render(view_matrix, current_time, 1.0f);
+        }
+
+        long value = values_[r];
+        long limit = 1;
+        for (int d = 0; d < num_digits_g; d++) limit *= 10;
+        if (value >= limit) value = limit - 1;
+        if (value < 0) value = 0;
+
+        // right to left, leaving off leading zeros
+        for (int d = 0; d < num_digits_g; d++) {
+            if (d > 0 && value == 0) break;
+            stamp_->SetTexture(digits_[value % 10]);
+            stamp_->SetPosition(glm::vec3(left_g + digit_width_g * (num_digits_g - d), y, 0.0f));
+            stamp_->Render(view_matrix, current_time, 1.0f);
+            value /= 10;
+        }
+    }
+}
+
+} // namespace game
@@ -0,0 +1,112 @@
+#ifndef PERF_HUD_H_
+#define PERF_HUD_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+#include "game_object.h"
+
+namespace game {
+
+    /*
+        PerfHud is the performance overlay toggled with F3: a column of numbers drawn with the same digit
+        textures as the score. There are no letter textures, so the rows always come in the same order
+        (see Row), and the entity counts get the texture of what they count as an icon.
+
+        The game hands it every frame's times and the entity counts, it keeps the last window_frames_ frames
+        and works out the numbers from them twice a second so they can actually be read.
+    */
+    class PerfHud {
+
+        public:
+            // The rows top to bottom, times are in microseconds
+            enum Row {
+                FPS,
+                FRAME_P50,
+                FRAME_P95,
+                FRAME_P99,
+                // average time per frame spent running ticks, and drawing
+                UPDATE_US,
+                RENDER_US,
+                DRAW_CALLS,
+                // objects drawn and objects culled for being off screen in the last frame
+                DRAWN,
+                CULLED,
+                // enemy updates left out last tick for being far from the player
+                LOD_SKIPPED,
+                ENEMIES,
+                COLLECTIBLES,
+                BULLETS,
+                SPIKES,
+                EXPLOSIONS,
+                TRAILS,
+                CHILDREN,
+                NUM_ROWS
+            };
+
+            PerfHud(void);
+            ~PerfHud();
+
+            // Set up the sprite the digits are drawn with, digits holds the textures for 0 to 9
+            void Init(Geometry *geom, Shader *shader, const GLuint *digits);
+
+            // Texture drawn in front of a row's number, 0 (the default) for none
+            void SetIcon(Row row, GLuint texture);
+
+            inline bool IsVisible(void) const { return visible_; }
+            inline void SetVisible(bool visible) { visible_ = visible; }
+            inline void Toggle(void) { visible_ = !visible_; }
+
+            // Count one frame: how long it took in total, in ticks and in Render, and its draw calls
+            void AddFrame(double frame_ms, double update_ms, double render_ms, long draw_calls);
+
+            // How many of something there are now
+            inline void SetCount(Row row, long count) { counts_[row] = count; }
+
+            // Draw the overlay, view_matrix should leave out the camera so it stays put on screen
+            void Render(const glm::mat4 &view_matrix, double current_time);
+
+            // The number a row shows at the moment
+            inline long GetValue(Row row) const { return values_[row]; }
+
+        private:
+            // Work out every row's number from the frames in the window
+            void Refresh(void);
+
+            // frames kept for the percentiles, a couple of seconds at 60 fps
+            static const int window_frames_ = 120;
+
+            // how often the numbers change, in seconds
+            static const double refresh_seconds_;
+
+            // the digits are drawn one by one with this
+            GameObject *stamp_;
+            GLuint digits_[10];
+            GLuint icons_[NUM_ROWS];
+
+            bool visible_;
+
+            // the last window_frames_ frames as a ring, next_ is where the next one goes
+            std::vector<double> frame_ms_;
+            std::vector<double> update_ms_;
+            std::vector<double> render_ms_;
+            int next_;
+            int frames_;
+
+            // scratch space for sorting the frame times
+            std::vector<double> sorted_;
+
+            long draw_calls_;
+            long counts_[NUM_ROWS];
+
+            // what each row shows, and how long until it changes
+            long values_[NUM_ROWS];
+            double until_refresh_;
+
+    }; // class PerfHud
+
+} // namespace game
+
+#endif // PERF_HUD_H_
@@ -0,0 +1,76 @@
+#include <iomanip>
+
+#include "phase_timer.h"
+
+namespace game {
+
+PhaseTimer::PhaseTimer(void)
+{
+    current_ = -1;
+}
+
+
+void PhaseTimer::Begin(const char *name)
+{
+    Clock::time_point now = Clock::now();
+
+    // close off the phase that was running
+    if (current_ >= 0) {
+        phases_[current_].total_ms += std::chrono::duration<double, std::milli>(now - start_).count();
+    }
+
+    // find the phase, theres only a handful so a linear scan is fine
+    current_ = -1;
+    for (int i = 0; i < phases_.size(); i++) {
+        if (phases_[i].name == name) {
+            current_ = i;
+            break;
+        }
+    }
+    if (current_ < 0) {
+        Phase phase = { name, 0.0 };
+        phases_.push_back(phase);
+        current_ = phases_.size() - 1;
+    }
+
+    start_ = now;
+}
+
+
+void PhaseTimer::End(void)
+{
+    if (current_ < 0) return;
+
+    phases_[current_].total_ms += std::chrono::duration<double, std::milli>(Clock::now() - start_).count();
+    current_ = -1;
+}
+
+
+void PhaseTimer::Reset(void)
+{
+    phases_.clear();
+    current_ = -1;
+}
+
+
+void PhaseTimer::Report(std::ostream &out, long ticks) const
+{
+    double total = 0.0;
+    for (int i = 0; i < phases_.size(); i++) {
+        total += phases_[i].total_ms;
+    }
+
+    out << std::left << std::setw(16) << "phase" << std::right
+        << std::setw(12) << "total ms" << std::setw(12) << "us/tick" << std::setw(8) << "%" << std::endl;
+
+    for (int i = 0; i < phases_.size(); i++) {
+        double per_tick = (ticks > 0) ? phases_[i].total_ms * 1000.0 / ticks : 0.0;
+        double share = (total > 0.0) ? 100.0 * phases_[i].total_ms / total : 0.0;
+        out << std::left << std::setw(16) << phases_[i].name << std::right << std::fixed << std::setprecision(3)
+            << std::setw(12) << phases_[i].total_ms << std::setw(12) << per_tick
+            << std::setprecision(1) << std::setw(8) << share << std::endl;
+    }
+    out.unsetf(std::ios_base::floatfield);
+}
+
+} // namespace game
@@ -0,0 +1,50 @@
+#ifndef PHASE_TIMER_H_
+#define PHASE_TIMER_H_
+
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+namespace game {
+
+    // Accumulates wall clock time spent in named phases of the game loop
+    class PhaseTimer {
+
+        public:
+            PhaseTimer(void);
+
+            // Start timing the named phase, ending the phase that was running
+            // Names are compared by pointer, so pass string literals
+            void Begin(const char *name);
+
+            // Stop timing the phase that is running, if any
+            void End(void);
+
+            // Forget everything measured so far
+            void Reset(void);
+
+            // Print the total and per tick cost of every phase
+            void Report(std::ostream &out, long ticks) const;
+
+        private:
+            typedef std::chrono::steady_clock Clock;
+
+            struct Phase {
+                const char *name;
+                double total_ms;
+            };
+
+            // the phases in the order they were first seen
+            std::vector<Phase> phases_;
+
+            // index of the running phase, -1 if none
+            int current_;
+
+            // when the running phase started
+            Clock::time_point start_;
+
+    }; // class PhaseTimer
+
+} // namespace game
+
+#endif // PHASE_TIMER_H_
@@ -14,20 +14,22 @@ PlayerGameObject::PlayerGameObject(const glm::vec3 &position, Geometry *geom, Sh
 void PlayerGameObject::Update(double delta_time) {
 
 	// Special player updates go here
-	
-	position_.x += velocity_.x;
-	position_.y += velocity_.y;
+
+	// velocity is tuned as distance per 60th of a second, so scale it by the tick length to keep the speed the same at any tick rate
+	float steps = static_cast<float>(delta_time * 60.0);
+	PositionX() += VelocityX() * steps;
+	PositionY() += VelocityY() * steps;
 
 	// Call the parent's update method to move the object in standard way, if desired
 	GameObject::Update(delta_time);
 }
 
-void PlayerGameObject::SetVelocity(glm::vec3 &velocity)
+void PlayerGameObject::SetVelocity(const glm::vec3 &velocity)
 {
 	//weird jerky thing when reversing direction
 
-	float x = velocity.x + velocity_.x;
-	float y = velocity.y + velocity_.y;
+	float x = velocity.x + VelocityX();
+	float y = velocity.y + VelocityY();
 
 	x /= 0.01f;
 	y /= 0.01f;
@@ -40,8 +42,8 @@ void PlayerGameObject::SetVelocity(glm::vec3 &velocity)
 	x *= 0.01f;
 	y *= 0.01f; 
 
-	velocity_.x = x;
-	velocity_.y = y;
+	VelocityX() = x;
+	VelocityY() = y;
 }
 
 } // namespace game
@@ -11,7 +11,7 @@ namespace game {
         public:
             PlayerGameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture);
 
-            void SetVelocity(glm::vec3 &velocity) override;
+            void SetVelocity(const glm::vec3 &velocity) override;
 
             // Update function for moving the player object around
             void Update(double delta_time) override;
@@ -0,0 +1,126 @@
+#include <fstream>
+#include <iomanip>
+
+#include "profiler.h"
+
+namespace game {
+
+namespace {
+
+    // the buffer the calling thread records into, and which profiler it belongs to
+    struct ThreadSlot {
+        const void *owner;
+        void *buffer;
+    };
+
+    thread_local ThreadSlot thread_slot_g = { NULL, NULL };
+
+} // namespace
+
+
+Profiler::Profiler(int capacity)
+{
+    epoch_ = Clock::now();
+    capacity_ = (capacity > 0) ? capacity : 1;
+    recording_ = false;
+}
+
+
+Profiler::~Profiler()
+{
+    for (int i = 0; i < buffers_.size(); i++) {
+        delete buffers_[i];
+    }
+}
+
+
+Profiler &Profiler::Default(void)
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+
+void Profiler::Start(void)
+{
+    recording_.store(true, std::memory_order_relaxed);
+}
+
+
+void Profiler::Stop(void)
+{
+    recording_.store(false, std::memory_order_relaxed);
+}
+
+
+long long Profiler::Now(void) const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch_).count();
+}
+
+
+Profiler::Buffer *Profiler::ThreadBuffer(void)
+{
+    if (thread_slot_g.owner == this) return static_cast<Buffer *>(thread_slot_g.buffer);
+
+    // first zone on this thread, so give it a buffer of its own
+    Buffer *buffer = new Buffer;
+    buffer->zones.resize(capacity_);
+    buffer->written = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer->thread = buffers_.size();
+        buffers_.push_back(buffer);
+    }
+
+    thread_slot_g.owner = this;
+    thread_slot_g.buffer = buffer;
+    return buffer;
+}
+
+
+void Profiler::Record(const char *name, long long start, long long end)
+{
+    Buffer *buffer = ThreadBuffer();
+    Zone &zone = buffer->zones[buffer->written % capacity_];
+    zone.name = name;
+    zone.start = start;
+    zone.end = end;
+    buffer->written++;
+}
+
+
+void Profiler::WriteTrace(const std::string &filename) const
+{
+    std::ofstream f(filename.c_str());
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // complete ("X") events with times in microseconds, plus a name for each thread
+    f << std::fixed << std::setprecision(3);
+    f << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::endl;
+    bool first = true;
+    for (int b = 0; b < buffers_.size(); b++) {
+        const Buffer *buffer = buffers_[b];
+
+        if (!first) f << "," << std::endl;
+        first = false;
+        f << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->thread
+          << ", \"args\": {\"name\": \"thread " << buffer->thread << "\"}}";
+
+        // once the ring has wrapped, the oldest zone left is the one about to be overwritten
+        long long count = (buffer->written < capacity_) ? buffer->written : capacity_;
+        for (long long i = buffer->written - count; i < buffer->written; i++) {
+            const Zone &zone = buffer->zones[i % capacity_];
+            f << "," << std::endl;
+            f << "{\"name\": \"" << zone.name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->thread
+              << ", \"ts\": " << zone.start / 1000.0 << ", \"dur\": " << (zone.end - zone.start) / 1000.0 << "}";
+        }
+    }
+    f << std::endl << "]}" << std::endl;
+}
+
+} // namespace game
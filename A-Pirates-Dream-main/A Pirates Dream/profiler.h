@@ -0,0 +1,112 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// PROFILE_ZONE("name") times the rest of the enclosing scope into the Profiler, pass a string literal
+// Builds without APD_PROFILE (the CMake option) compile every zone away to nothing
+#ifdef APD_PROFILE
+#define PROFILE_ZONE_JOIN2(a, b) a##b
+#define PROFILE_ZONE_JOIN(a, b) PROFILE_ZONE_JOIN2(a, b)
+#define PROFILE_ZONE(name) ::game::ProfileZone PROFILE_ZONE_JOIN(profile_zone_, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#endif
+
+namespace game {
+
+    /*
+        Profiler collects timed zones from every thread and writes them out as a Chrome trace_event file
+        (open it at chrome://tracing or ui.perfetto.dev).
+
+        Each thread writes its zones into its own ring buffer, so recording a zone never takes a lock and a long
+        run just keeps the most recent zones. Nothing is recorded until Start() is called, so a build with the
+        zones compiled in costs one flag check per zone when nobody is tracing.
+        WriteTrace() reads every thread's buffer, so call it while the worker threads are idle (between ticks).
+    */
+    class Profiler {
+
+        public:
+            // zones kept per thread before the oldest get overwritten
+            Profiler(int capacity = 1 << 16);
+            ~Profiler();
+
+            // The profiler the PROFILE_ZONE macro records into
+            static Profiler &Default(void);
+
+            // Start or stop recording zones
+            void Start(void);
+            void Stop(void);
+            inline bool IsRecording(void) const { return recording_.load(std::memory_order_relaxed); }
+
+            // Record one zone on the calling thread, start and end as from Now()
+            void Record(const char *name, long long start, long long end);
+
+            // Nanoseconds since the profiler was made
+            long long Now(void) const;
+
+            // Write every thread's zones as trace_event JSON, throws if the file cant be opened
+            void WriteTrace(const std::string &filename) const;
+
+        private:
+            struct Zone {
+                const char *name;
+                long long start;
+                long long end;
+            };
+
+            // one thread's zones, only that thread writes to it
+            struct Buffer {
+                std::vector<Zone> zones;
+                // zones ever recorded, the next one goes in zones[written % capacity]
+                long long written;
+                // the thread's number in the trace, in the order threads first recorded something
+                int thread;
+            };
+
+            // The calling thread's buffer, made the first time it records
+            Buffer *ThreadBuffer(void);
+
+            typedef std::chrono::steady_clock Clock;
+            Clock::time_point epoch_;
+
+            int capacity_;
+            std::atomic<bool> recording_;
+
+            // every thread's buffer, the mutex is only taken when a new thread shows up and when writing the trace
+            mutable std::mutex mutex_;
+            std::vector<Buffer *> buffers_;
+
+    }; // class Profiler
+
+
+    // Times its own lifetime into the default Profiler, use it through PROFILE_ZONE
+    class ProfileZone {
+
+        public:
+            inline ProfileZone(const char *name) : name_(name), start_(-1)
+            {
+                if (Profiler::Default().IsRecording()) start_ = Profiler::Default().Now();
+            }
+
+            inline ~ProfileZone()
+            {
+                if (start_ >= 0) Profiler::Default().Record(name_, start_, Profiler::Default().Now());
+            }
+
+        private:
+            ProfileZone(const ProfileZone &);
+            ProfileZone &operator=(const ProfileZone &);
+
+            const char *name_;
+            long long start_;
+
+    }; // class ProfileZone
+
+} // namespace game
+
+#endif // PROFILER_H_
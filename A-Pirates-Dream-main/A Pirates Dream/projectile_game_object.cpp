@@ -1,4 +1,5 @@
 #include "projectile_game_object.h"
+#include "snapshot.h"
 
 namespace game {
 
@@ -20,8 +21,8 @@ void ProjectileGameObject::Update(double delta_time) {
 	
 	//std::cout << time_ << std::endl;
 
-	position_.x = start_pos_.x + (velocity_.x * 100 * time_);
-	position_.y = start_pos_.y + (velocity_.y * 100 * time_);
+	PositionX() = start_pos_.x + (VelocityX() * 100 * time_);
+	PositionY() = start_pos_.y + (VelocityY() * 100 * time_);
 	
 
 	
@@ -30,9 +31,21 @@ void ProjectileGameObject::Update(double delta_time) {
 	GameObject::Update(delta_time);
 }
 
-void ProjectileGameObject::SetVelocity(glm::vec3 &velocity)
+void ProjectileGameObject::SetVelocity(const glm::vec3 &velocity)
 {
-	velocity_ = velocity;
+	GameObject::SetVelocity(velocity);
+}
+
+void ProjectileGameObject::Save(Snapshot &snapshot) const
+{
+	GameObject::Save(snapshot);
+	snapshot.PutArray(&start_pos_.x, 3);
+}
+
+void ProjectileGameObject::Load(Snapshot &snapshot)
+{
+	GameObject::Load(snapshot);
+	snapshot.GetArray(&start_pos_.x, 3);
 }
 
 }
\ No newline at end of file
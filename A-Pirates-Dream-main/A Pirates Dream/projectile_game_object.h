@@ -11,7 +11,7 @@ namespace game {
         public:
             ProjectileGameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture);
 
-            void SetVelocity(glm::vec3 &velocity) override;
+            void SetVelocity(const glm::vec3 &velocity) override;
 
             // Update function for moving the player object around
             void Update(double delta_time) override;
@@ -19,6 +19,10 @@ namespace game {
             // getter
             inline glm::vec3 GetStart(void) const { return start_pos_;}
 
+            // Save and load the firing point along with the rest of the object
+            void Save(Snapshot &snapshot) const override;
+            void Load(Snapshot &snapshot) override;
+
         private:
             glm::vec3 start_pos_;
 
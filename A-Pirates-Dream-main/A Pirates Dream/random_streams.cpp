@@ -0,0 +1,113 @@
+#include "random_streams.h"
+#include "snapshot.h"
+
+namespace game {
+
+namespace {
+
+    // splitmix64, spreads any seed (even 0, 1, 2...) into well mixed bits, used to fill the generator state
+    unsigned long long SplitMix(unsigned long long &x)
+    {
+        unsigned long long z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    inline unsigned int RotateLeft(unsigned int x, int k)
+    {
+        return (x << k) | (x >> (32 - k));
+    }
+
+} // namespace
+
+
+Random::Random(unsigned long long seed)
+{
+    Seed(seed);
+}
+
+
+void Random::Seed(unsigned long long seed)
+{
+    unsigned long long a = SplitMix(seed);
+    unsigned long long b = SplitMix(seed);
+    state_[0] = static_cast<unsigned int>(a);
+    state_[1] = static_cast<unsigned int>(a >> 32);
+    state_[2] = static_cast<unsigned int>(b);
+    state_[3] = static_cast<unsigned int>(b >> 32);
+}
+
+
+unsigned int Random::Next(void)
+{
+    unsigned int result = RotateLeft(state_[1] * 5, 7) * 9;
+    unsigned int t = state_[1] << 9;
+
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = RotateLeft(state_[3], 11);
+
+    return result;
+}
+
+
+RandomStreams::RandomStreams(unsigned long long seed)
+{
+    Seed(seed);
+}
+
+
+RandomStreams &RandomStreams::Default(void)
+{
+    static RandomStreams streams;
+    return streams;
+}
+
+
+void RandomStreams::Seed(unsigned long long seed)
+{
+    seed_ = seed;
+
+    // the shared generators use a key no parallel item will, so they never repeat a Fork()ed sequence
+    for (int i = 0; i < NUM_STREAMS; i++) {
+        streams_[i] = Fork(static_cast<Stream>(i), ~0ULL);
+    }
+}
+
+
+Random RandomStreams::Fork(Stream stream, unsigned long long key) const
+{
+    // mix the three together so neighbouring keys and streams land far apart
+    unsigned long long x = seed_;
+    unsigned long long mixed = SplitMix(x) ^ (static_cast<unsigned long long>(stream) + 1) * 0xd1b54a32d192ed03ULL;
+    mixed = SplitMix(mixed) ^ key;
+    return Random(SplitMix(mixed));
+}
+
+
+void RandomStreams::Save(Snapshot &snapshot) const
+{
+    snapshot.Put(seed_);
+    for (int i = 0; i < NUM_STREAMS; i++) {
+        unsigned int state[4];
+        streams_[i].GetState(state);
+        snapshot.PutArray(state, 4);
+    }
+}
+
+
+void RandomStreams::Load(Snapshot &snapshot)
+{
+    seed_ = snapshot.Get<unsigned long long>();
+    for (int i = 0; i < NUM_STREAMS; i++) {
+        unsigned int state[4];
+        snapshot.GetArray(state, 4);
+        streams_[i].SetState(state);
+    }
+}
+
+} // namespace game
@@ -0,0 +1,81 @@
+#ifndef RANDOM_STREAMS_H_
+#define RANDOM_STREAMS_H_
+
+namespace game {
+
+    class Snapshot;
+
+    // A small fast random number generator (xoshiro128**), the same seed always gives the same numbers
+    class Random {
+
+        public:
+            Random(unsigned long long seed = 0);
+
+            // Start the sequence over from a seed
+            void Seed(unsigned long long seed);
+
+            // Next 32 random bits
+            unsigned int Next(void);
+
+            // A float in [0, 1)
+            inline float Float(void) { return (Next() >> 8) * (1.0f / 16777216.0f); }
+
+            // A float in [low, high)
+            inline float Range(float low, float high) { return low + (high - low) * Float(); }
+
+            // An int in [0, n)
+            inline int Below(int n) { return static_cast<int>((static_cast<unsigned long long>(Next()) * static_cast<unsigned int>(n)) >> 32); }
+
+            // The generator's whole state, for snapshots
+            inline void GetState(unsigned int state[4]) const { for (int i = 0; i < 4; i++) state[i] = state_[i]; }
+            inline void SetState(const unsigned int state[4]) { for (int i = 0; i < 4; i++) state_[i] = state[i]; }
+
+        private:
+            unsigned int state_[4];
+
+    }; // class Random
+
+
+    /*
+        RandomStreams holds the game's random number generators, one per named stream, all derived from one seed.
+        Each stream is seeded independently, so drawing more numbers from one (say an extra particle effect)
+        doesnt change what the others produce, and a seed from the command line replays the same game.
+
+        Get() hands out a stream's generator for code that runs on one thread. Code running in parallel uses
+        Fork(), which makes a private generator from the seed, the stream and a key; keying it on the item being
+        worked on (rather than the thread) gives the same numbers however the work is split between threads.
+        Games use the Default() streams, tests can make their own.
+    */
+    class RandomStreams {
+
+        public:
+            enum Stream { SPAWN, LOOT, FX, NUM_STREAMS };
+
+            RandomStreams(unsigned long long seed = 0);
+
+            // The streams the game uses unless given others
+            static RandomStreams &Default(void);
+
+            // Reseed every stream from one seed
+            void Seed(unsigned long long seed);
+            inline unsigned long long GetSeed(void) const { return seed_; }
+
+            // Save and restore the seed and where every stream is up to
+            void Save(Snapshot &snapshot) const;
+            void Load(Snapshot &snapshot);
+
+            // A stream's shared generator, not thread safe
+            inline Random &Get(Stream stream) { return streams_[stream]; }
+
+            // A private generator for one item of parallel work, safe to call from any thread
+            Random Fork(Stream stream, unsigned long long key) const;
+
+        private:
+            unsigned long long seed_;
+            Random streams_[NUM_STREAMS];
+
+    }; // class RandomStreams
+
+} // namespace game
+
+#endif // RANDOM_STREAMS_H_
@@ -0,0 +1,150 @@
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+#include "scenario.h"
+
+namespace game {
+
+namespace {
+
+    // Strip spaces and tabs from both ends
+    std::string Trim(const std::string &text)
+    {
+        size_t begin = text.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos) return "";
+        size_t end = text.find_last_not_of(" \t\r\n");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    int CountValue(const std::string &key, const std::string &value)
+    {
+        char *end;
+        long number = strtol(value.c_str(), &end, 10);
+        if (value.empty() || *end != '\0' || number < 0 || number > 10000000) {
+            throw(std::invalid_argument(std::string("Expected a count for scenario ") + key + ", got " + value));
+        }
+        return static_cast<int>(number);
+    }
+
+    float DistanceValue(const std::string &key, const std::string &value)
+    {
+        char *end;
+        float number = strtof(value.c_str(), &end);
+        if (value.empty() || *end != '\0' || !(number > 0.0f)) {
+            throw(std::invalid_argument(std::string("Expected a positive distance for scenario ") + key + ", got " + value));
+        }
+        return number;
+    }
+
+} // namespace
+
+
+Scenario::Scenario(void)
+{
+    navy_ships = 100;
+    sea_monsters = 50;
+    collectibles = 50;
+    projectiles = 20;
+    layout = UNIFORM;
+    extent = 20.0f;
+    clusters = 4;
+    cluster_radius = 3.0f;
+    invincible = true;
+    streaming = false;
+}
+
+
+void Scenario::Set(const std::string &key, const std::string &value)
+{
+    if (key == "navy_ships") {
+        navy_ships = CountValue(key, value);
+    }
+    else if (key == "sea_monsters") {
+        sea_monsters = CountValue(key, value);
+    }
+    else if (key == "collectibles") {
+        collectibles = CountValue(key, value);
+    }
+    else if (key == "projectiles") {
+        projectiles = CountValue(key, value);
+    }
+    else if (key == "layout") {
+        if (value == "uniform") layout = UNIFORM;
+        else if (value == "clustered") layout = CLUSTERED;
+        else if (value == "ring") layout = RING;
+        else throw(std::invalid_argument(std::string("Expected uniform, clustered or ring for scenario layout, got ") + value));
+    }
+    else if (key == "extent") {
+        extent = DistanceValue(key, value);
+    }
+    else if (key == "clusters") {
+        clusters = CountValue(key, value);
+        if (clusters == 0) throw(std::invalid_argument(std::string("Scenario clusters must be at least 1")));
+    }
+    else if (key == "cluster_radius") {
+        cluster_radius = DistanceValue(key, value);
+    }
+    else if (key == "invincible") {
+        if (value == "true" || value == "1") invincible = true;
+        else if (value == "false" || value == "0") invincible = false;
+        else throw(std::invalid_argument(std::string("Expected true or false for scenario invincible, got ") + value));
+    }
+    else if (key == "streaming") {
+        if (value == "true" || value == "1") streaming = true;
+        else if (value == "false" || value == "0") streaming = false;
+        else throw(std::invalid_argument(std::string("Expected true or false for scenario streaming, got ") + value));
+    }
+    else {
+        throw(std::invalid_argument(std::string("Unknown scenario setting ") + key));
+    }
+}
+
+
+void Scenario::Set(const std::string &assignment)
+{
+    size_t equals = assignment.find('=');
+    if (equals == std::string::npos) {
+        throw(std::invalid_argument(std::string("Expected key=value for a scenario setting, got ") + assignment));
+    }
+    Set(Trim(assignment.substr(0, equals)), Trim(assignment.substr(equals + 1)));
+}
+
+
+void Scenario::Load(const std::string &filename)
+{
+    std::ifstream f(filename.c_str());
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+
+    std::string line;
+    int line_number = 0;
+    while (std::getline(f, line)) {
+        line_number++;
+        line = Trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        try {
+            Set(line);
+        }
+        catch (std::invalid_argument &e) {
+            throw(std::invalid_argument(filename + ":" + std::to_string(line_number) + ": " + e.what()));
+        }
+    }
+}
+
+
+void Scenario::Print(std::ostream &out) const
+{
+    const char *layouts[] = { "uniform", "clustered", "ring" };
+
+    out << "Scenario: " << navy_ships << " navy ships, " << sea_monsters << " sea monsters, " << collectibles << " collectibles, "
+        << projectiles << " projectiles, " << layouts[layout] << " layout over " << extent << " units";
+    if (layout == CLUSTERED) out << " (" << clusters << " clusters of radius " << cluster_radius << ")";
+    if (invincible) out << ", invincible player";
+    if (streaming) out << ", streaming";
+    out << std::endl;
+}
+
+} // namespace game
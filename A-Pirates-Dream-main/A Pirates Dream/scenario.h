@@ -0,0 +1,59 @@
+#ifndef SCENARIO_H_
+#define SCENARIO_H_
+
+#include <ostream>
+#include <string>
+
+namespace game {
+
+    // A stress test setup: how many of each object to keep in the world and where they spawn
+    // Filled in from a scenario file and/or --scenario-set on the command line
+    struct Scenario {
+
+        // Where objects spawn around the player: anywhere in a square, in a few clumps, or in a ring
+        enum Layout { UNIFORM, CLUSTERED, RING };
+
+        // How many of each object to keep around, anything destroyed is replaced on the next tick
+        int navy_ships;
+        int sea_monsters;
+        int collectibles;
+
+        // Bullets the player keeps in flight, firing round in a circle as the old ones land or run out
+        int projectiles;
+
+        Layout layout;
+
+        // Half the width of the square, or the outer radius of the ring, in world units
+        float extent;
+
+        // Number of clumps and how far objects stray from their clump's centre, for CLUSTERED
+        int clusters;
+        float cluster_radius;
+
+        // Whether the player ignores damage so the run lasts
+        bool invincible;
+
+        // Whether far away chunks of the sea go to sleep like in the normal game, what's asleep still counts
+        // towards the numbers above
+        bool streaming;
+
+        // Constructor sets a small scenario
+        Scenario(void);
+
+        // Set one key (named like the fields above) from its text value, throws on unknown keys or bad values
+        void Set(const std::string &key, const std::string &value);
+
+        // Same, from "key=value"
+        void Set(const std::string &assignment);
+
+        // Read "key = value" lines, blank lines and lines starting with # are skipped, throws on a bad file
+        void Load(const std::string &filename);
+
+        // Print the settings on one line
+        void Print(std::ostream &out) const;
+
+    }; // struct Scenario
+
+} // namespace game
+
+#endif // SCENARIO_H_
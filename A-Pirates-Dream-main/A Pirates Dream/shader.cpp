@@ -121,7 +121,10 @@ void Shader::SetUniformMat4(const GLchar *name, const glm::mat4 &matrix)
 Shader::~Shader() 
 {
 
-    glDeleteProgram(shader_program_);
+    // headless runs never create a program, and have no context to delete one from
+    if (shader_program_ != 0) {
+        glDeleteProgram(shader_program_);
+    }
 }
 
 
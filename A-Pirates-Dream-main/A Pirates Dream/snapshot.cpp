@@ -0,0 +1,92 @@
+#include <fstream>
+
+#include "snapshot.h"
+
+namespace game {
+
+namespace {
+
+    const char snapshot_magic_g[4] = { 'A', 'P', 'D', 'S' };
+
+    // bump whenever anything saves more, less or in a different order
+    const unsigned short snapshot_version_g = 7;
+
+    // reads back as 0x0201 on a machine with the other byte order
+    const unsigned short byte_order_g = 0x0102;
+
+} // namespace
+
+
+Snapshot::Snapshot(void)
+{
+    size_ = 0;
+    read_ = 0;
+}
+
+
+void Snapshot::Begin(void)
+{
+    size_ = 0;
+    read_ = 0;
+    PutArray(snapshot_magic_g, sizeof(snapshot_magic_g));
+    Put(snapshot_version_g);
+    Put(byte_order_g);
+}
+
+
+void Snapshot::Open(void)
+{
+    read_ = 0;
+    if (size_ < sizeof(snapshot_magic_g) || memcmp(data_.data(), snapshot_magic_g, sizeof(snapshot_magic_g)) != 0) {
+        throw(std::ios_base::failure(std::string("Not a game snapshot")));
+    }
+    read_ += sizeof(snapshot_magic_g);
+
+    if (Get<unsigned short>() != snapshot_version_g) {
+        throw(std::ios_base::failure(std::string("Snapshot is from a different version of the game")));
+    }
+    if (Get<unsigned short>() != byte_order_g) {
+        throw(std::ios_base::failure(std::string("Snapshot was saved on a machine with a different byte order")));
+    }
+}
+
+
+bool Snapshot::operator==(const Snapshot &other) const
+{
+    return size_ == other.size_ && (size_ == 0 || memcmp(data_.data(), other.data_.data(), size_) == 0);
+}
+
+
+void Snapshot::Save(const std::string &filename) const
+{
+    std::ofstream f(filename.c_str(), std::ios::binary);
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+
+    f.write(reinterpret_cast<const char *>(data_.data()), size_);
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error writing file ") + filename));
+    }
+}
+
+
+void Snapshot::Load(const std::string &filename)
+{
+    std::ifstream f(filename.c_str(), std::ios::binary | std::ios::ate);
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+
+    std::streamoff length = f.tellg();
+    f.seekg(0);
+    data_.resize(length);
+    f.read(reinterpret_cast<char *>(data_.data()), length);
+    if (f.gcount() != length) {
+        throw(std::ios_base::failure(std::string("Snapshot ") + filename + " is cut short"));
+    }
+    size_ = length;
+    read_ = 0;
+}
+
+} // namespace game
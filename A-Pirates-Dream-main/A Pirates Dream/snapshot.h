@@ -0,0 +1,109 @@
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <algorithm>
+#include <cstring>
+#include <ios>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace game {
+
+    /*
+        Snapshot is a flat binary blob of game state: Put() appends values, Get() reads them back in the same
+        order. Values are copied as raw bytes in the machine's own layout, so saving is a run of memcpys into one
+        growing buffer that keeps its memory between saves. The header records the format version and a byte
+        order marker, and Open() refuses a snapshot from another version or a machine with the other byte order.
+
+        What goes in and in what order is up to whoever saves it (see Game::SaveSnapshot), each piece of the
+        game saves and loads its own state.
+    */
+    class Snapshot {
+
+        public:
+            Snapshot(void);
+
+            // Start a new snapshot with just the header, keeping the buffer's memory
+            void Begin(void);
+
+            // Check the header and start reading after it, throws if the snapshot is from another version or machine
+            void Open(void);
+
+            // Append a value, or count values from an array
+            template <class T>
+            inline void Put(const T &value)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "Snapshots only hold plain values");
+                Grow(sizeof(T));
+                memcpy(data_.data() + size_, &value, sizeof(T));
+                size_ += sizeof(T);
+            }
+
+            template <class T>
+            inline void PutArray(const T *values, int count)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "Snapshots only hold plain values");
+                Grow(sizeof(T) * count);
+                if (count > 0) memcpy(data_.data() + size_, values, sizeof(T) * count);
+                size_ += sizeof(T) * count;
+            }
+
+            // Read the next value, or count values into an array, throws if the snapshot runs out
+            template <class T>
+            inline T Get(void)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "Snapshots only hold plain values");
+                T value;
+                Take(&value, sizeof(T));
+                return value;
+            }
+
+            template <class T>
+            inline void GetArray(T *values, int count)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "Snapshots only hold plain values");
+                Take(values, sizeof(T) * count);
+            }
+
+            // Bytes written, and bytes read so far
+            inline size_t GetSize(void) const { return size_; }
+            inline size_t GetPosition(void) const { return read_; }
+
+            // The bytes written, for copying one snapshot into another
+            inline const unsigned char *GetData(void) const { return data_.data(); }
+
+            // The same bytes as another snapshot
+            bool operator==(const Snapshot &other) const;
+
+            // Write to and read from a file, these throw if the file cant be opened or is cut short
+            void Save(const std::string &filename) const;
+            void Load(const std::string &filename);
+
+        private:
+            // Make room for bytes more, doubling so a big save only reallocates a few times
+            inline void Grow(size_t bytes)
+            {
+                if (size_ + bytes > data_.size()) data_.resize(std::max(size_ + bytes, 2 * data_.size()));
+            }
+
+            // Copy the next bytes out
+            inline void Take(void *destination, size_t bytes)
+            {
+                if (read_ + bytes > size_) {
+                    throw(std::ios_base::failure(std::string("Snapshot is cut short")));
+                }
+                memcpy(destination, data_.data() + read_, bytes);
+                read_ += bytes;
+            }
+
+            // the buffer is only ever grown, size_ is how much of it holds the snapshot
+            std::vector<unsigned char> data_;
+            size_t size_;
+            size_t read_;
+
+    }; // class Snapshot
+
+} // namespace game
+
+#endif // SNAPSHOT_H_
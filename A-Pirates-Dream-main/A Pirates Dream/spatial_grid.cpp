@@ -0,0 +1,132 @@
+#include "spatial_grid.h"
+
+namespace game {
+
+SpatialGrid::SpatialGrid(float cell_size)
+{
+    cell_size_ = cell_size;
+    inverse_cell_size_ = 1.0f / cell_size;
+    table_mask_ = 0;
+    bucket_start_.assign(2, 0);
+}
+
+
+void SpatialGrid::Clear(void)
+{
+    entries_.clear();
+}
+
+
+void SpatialGrid::Insert(int id, const glm::vec3 &position)
+{
+    Entry entry;
+    entry.x = position.x;
+    entry.y = position.y;
+    entry.cell_x = CellCoord(position.x);
+    entry.cell_y = CellCoord(position.y);
+    entry.id = id;
+    entries_.push_back(entry);
+}
+
+
+void SpatialGrid::Build(void)
+{
+    // keep around two buckets per object so most buckets hold a single cell
+    unsigned int table_size = 64;
+    while (table_size < 2 * entries_.size()) table_size *= 2;
+    table_mask_ = table_size - 1;
+
+    // counting sort by bucket: count, prefix sum, then scatter
+    bucket_start_.assign(table_size + 1, 0);
+    for (int i = 0; i < entries_.size(); i++) {
+        bucket_start_[Bucket(entries_[i].cell_x, entries_[i].cell_y) + 1]++;
+    }
+    for (int b = 0; b < table_size; b++) {
+        bucket_start_[b + 1] += bucket_start_[b];
+    }
+
+    sorted_.resize(entries_.size());
+    for (int i = 0; i < entries_.size(); i++) {
+        // bucket_start_[b] doubles as the write cursor, and ends up at the start of bucket b + 1
+        int b = Bucket(entries_[i].cell_x, entries_[i].cell_y);
+        sorted_[bucket_start_[b]++] = entries_[i];
+    }
+
+    // shift the cursors back so bucket_start_[b] is the start of bucket b again
+    for (int b = table_size; b > 0; b--) {
+        bucket_start_[b] = bucket_start_[b - 1];
+    }
+    bucket_start_[0] = 0;
+}
+
+
+void SpatialGrid::QueryRadius(const glm::vec3 &centre, float radius, std::vector<int> &out) const
+{
+    if (sorted_.empty()) return;
+
+    float radius_squared = radius * radius;
+    int min_x = CellCoord(centre.x - radius);
+    int max_x = CellCoord(centre.x + radius);
+    int min_y = CellCoord(centre.y - radius);
+    int max_y = CellCoord(centre.y + radius);
+
+    for (int cy = min_y; cy <= max_y; cy++) {
+        for (int cx = min_x; cx <= max_x; cx++) {
+            int b = Bucket(cx, cy);
+            for (int i = bucket_start_[b]; i < bucket_start_[b + 1]; i++) {
+                const Entry &e = sorted_[i];
+
+                // other cells can share the bucket, only look at this one so nothing is reported twice
+                if (e.cell_x != cx || e.cell_y != cy) continue;
+
+                float dx = e.x - centre.x;
+                float dy = e.y - centre.y;
+                if (dx * dx + dy * dy < radius_squared) {
+                    out.push_back(e.id);
+                }
+            }
+        }
+    }
+}
+
+
+void SpatialGrid::QuerySegment(const glm::vec3 &start, const glm::vec3 &end, float radius, std::vector<int> &out) const
+{
+    if (sorted_.empty()) return;
+
+    float radius_squared = radius * radius;
+    float seg_x = end.x - start.x;
+    float seg_y = end.y - start.y;
+    float seg_length_squared = seg_x * seg_x + seg_y * seg_y;
+
+    // every cell the segment's bounding box (grown by the radius) touches
+    int min_x = CellCoord(fminf(start.x, end.x) - radius);
+    int max_x = CellCoord(fmaxf(start.x, end.x) + radius);
+    int min_y = CellCoord(fminf(start.y, end.y) - radius);
+    int max_y = CellCoord(fmaxf(start.y, end.y) + radius);
+
+    for (int cy = min_y; cy <= max_y; cy++) {
+        for (int cx = min_x; cx <= max_x; cx++) {
+            int b = Bucket(cx, cy);
+            for (int i = bucket_start_[b]; i < bucket_start_[b + 1]; i++) {
+                const Entry &e = sorted_[i];
+                if (e.cell_x != cx || e.cell_y != cy) continue;
+
+                // closest point on the segment to the object's centre
+                float t = 0.0f;
+                if (seg_length_squared > 0.0f) {
+                    t = ((e.x - start.x) * seg_x + (e.y - start.y) * seg_y) / seg_length_squared;
+                    if (t < 0.0f) t = 0.0f;
+                    if (t > 1.0f) t = 1.0f;
+                }
+                float dx = e.x - (start.x + t * seg_x);
+                float dy = e.y - (start.y + t * seg_y);
+                if (dx * dx + dy * dy < radius_squared) {
+                    out.push_back(e.id);
+                }
+            }
+        }
+    }
+}
+
+} // namespace game
@@ -0,0 +1,76 @@
+#ifndef SPATIAL_GRID_H_
+#define SPATIAL_GRID_H_
+
+#include <cmath>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace game {
+
+    /*
+        SpatialGrid is a uniform grid broadphase for finding which objects are near a point or a path.
+        The world is cut into square cells that are hashed into a fixed size table, so the grid covers an
+        unbounded world without allocating memory for empty space. Fill it with Insert() and then call Build()
+        once per tick before querying; rebuilding from scratch is a couple of linear passes, and the arrays
+        keep their capacity between ticks so steady state rebuilding doesnt allocate.
+    */
+    class SpatialGrid {
+
+        public:
+            // cell_size should be around the largest query radius
+            SpatialGrid(float cell_size = 1.0f);
+
+            // Forget every object (keeps the memory for next time)
+            void Clear(void);
+
+            // Add an object centred at position, id is whatever the caller uses to find it again (usually an index)
+            void Insert(int id, const glm::vec3 &position);
+
+            // Sort the inserted objects into their cells, call after the last Insert() and before any query
+            void Build(void);
+
+            // Append the ids of objects whose centre is closer than radius to centre
+            void QueryRadius(const glm::vec3 &centre, float radius, std::vector<int> &out) const;
+
+            // Append the ids of objects whose centre is closer than radius to the segment from start to end
+            void QuerySegment(const glm::vec3 &start, const glm::vec3 &end, float radius, std::vector<int> &out) const;
+
+            // Number of objects inserted
+            inline int GetSize(void) const { return entries_.size(); }
+
+            inline float GetCellSize(void) const { return cell_size_; }
+
+        private:
+            struct Entry {
+                float x;
+                float y;
+                int cell_x;
+                int cell_y;
+                int id;
+            };
+
+            // Which cell a coordinate falls in
+            inline int CellCoord(float v) const { return static_cast<int>(floorf(v * inverse_cell_size_)); }
+
+            // Which table bucket a cell hashes to
+            inline int Bucket(int cell_x, int cell_y) const {
+                unsigned int h = (static_cast<unsigned int>(cell_x) * 73856093u) ^ (static_cast<unsigned int>(cell_y) * 19349663u);
+                return static_cast<int>(h & table_mask_);
+            }
+
+            float cell_size_;
+            float inverse_cell_size_;
+
+            // objects in insertion order, then sorted by bucket
+            std::vector<Entry> entries_;
+            std::vector<Entry> sorted_;
+
+            // sorted_[bucket_start_[b] .. bucket_start_[b + 1]) are the objects in bucket b
+            std::vector<int> bucket_start_;
+            unsigned int table_mask_;
+
+    }; // class SpatialGrid
+
+} // namespace game
+
+#endif // SPATIAL_GRID_H_
@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <glm/gtc/constants.hpp>
+
+#include "spawn_director.h"
+#include "snapshot.h"
+
+namespace game {
+
+namespace {
+
+    // the table the game has always played: five navy ships to start, one more every 5 seconds up to five alive
+    // (three in five of them sea monsters past 10 points) while the score and the enemies alive add up to less than
+    // 25, so the last ship is sunk as 25 points brings the boss, and a buff every 5 seconds up to five
+    const SpawnWave classic_waves_g[] = {
+        { SpawnWave::ENEMY, 0, 25, 0.0f, 5, 5, 25, 0.0f, 1.5f, 4.0f },
+        { SpawnWave::ENEMY, 0, 11, 5.0f, 1, 5, 25, 0.0f, 2.0f, 5.0f },
+        { SpawnWave::ENEMY, 11, 25, 5.0f, 1, 5, 25, 0.6f, 2.0f, 5.0f },
+        { SpawnWave::BUFF, 0, 1000000, 5.0f, 1, 5, 0, 0.0f, 1.0f, 4.0f },
+    };
+
+    // Whether a row queues spawns at score, with alive of its kind alive and queued of them queued
+    bool Applies(const SpawnWave &wave, int score, int alive, int queued)
+    {
+        if (score < wave.from_score || score >= wave.to_score) return false;
+        return wave.limit <= 0 || score + alive + queued < wave.limit;
+    }
+
+    // how many spawn points each row gets, enough that a wave rarely lands two things in the same place
+    const int spawn_points_g = 48;
+
+    // dart throwing gives up after this many misses per point, a thin ring just ends up with fewer points
+    const int dart_tries_g = 30;
+
+    // Shuffle the points so they come out in a fresh order
+    void Shuffle(std::vector<glm::vec3> &points, Random &random)
+    {
+        for (int i = static_cast<int>(points.size()) - 1; i > 0; i--) {
+            std::swap(points[i], points[random.Below(i + 1)]);
+        }
+    }
+
+} // namespace
+
+
+SpawnDirector::SpawnDirector(void)
+{
+    waves_.assign(classic_waves_g, classic_waves_g + sizeof(classic_waves_g) / sizeof(classic_waves_g[0]));
+    budget_ = 2;
+    budget_left_ = budget_;
+    Reset();
+}
+
+
+void SpawnDirector::Load(const std::string &filename)
+{
+    std::ifstream f(filename.c_str());
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+
+    std::vector<SpawnWave> waves;
+    int budget = budget_;
+
+    std::string line;
+    int line_number = 0;
+    while (std::getline(f, line)) {
+        line_number++;
+        std::istringstream words(line);
+        std::string first;
+        if (!(words >> first) || first[0] == '#') continue;
+
+        std::string where = filename + ":" + std::to_string(line_number) + ": ";
+        if (first == "budget") {
+            if (!(words >> budget) || budget <= 0) throw(std::invalid_argument(where + "Expected a positive spawn budget"));
+            continue;
+        }
+
+        SpawnWave wave;
+        if (first == "enemy") wave.kind = SpawnWave::ENEMY;
+        else if (first == "buff") wave.kind = SpawnWave::BUFF;
+        else throw(std::invalid_argument(where + "Expected enemy, buff or budget, got " + first));
+
+        if (!(words >> wave.from_score >> wave.to_score >> wave.every >> wave.count >> wave.cap >> wave.limit >> wave.tough >> wave.near >> wave.far)) {
+            throw(std::invalid_argument(where + "Expected from_score to_score every count cap limit tough near far"));
+        }
+        if (wave.from_score >= wave.to_score || wave.every < 0.0f || wave.count <= 0 || wave.cap <= 0 || wave.limit < 0
+                || wave.tough < 0.0f || wave.tough > 1.0f || wave.near < 0.0f || wave.near >= wave.far) {
+            throw(std::invalid_argument(where + "Wave values out of range"));
+        }
+        waves.push_back(wave);
+    }
+
+    waves_ = waves;
+    budget_ = budget;
+    Reset();
+}
+
+
+void SpawnDirector::SetBudget(int budget)
+{
+    if (budget <= 0) {
+        throw(std::invalid_argument(std::string("Spawn budget must be at least 1")));
+    }
+    budget_ = budget;
+}
+
+
+void SpawnDirector::Reset(void)
+{
+    wait_.assign(waves_.size(), 0.0);
+    done_.assign(waves_.size(), false);
+    points_.assign(waves_.size(), std::vector<glm::vec3>());
+    next_point_.assign(waves_.size(), 0);
+    for (int w = 0; w < waves_.size(); w++) wait_[w] = waves_[w].every;
+
+    queue_.clear();
+    queued_[SpawnWave::ENEMY] = 0;
+    queued_[SpawnWave::BUFF] = 0;
+}
+
+
+void SpawnDirector::Start(Random &random)
+{
+    Reset();
+
+    for (int w = 0; w < waves_.size(); w++) {
+        const SpawnWave &wave = waves_[w];
+        std::vector<glm::vec3> &points = points_[w];
+        points.reserve(spawn_points_g);
+
+        // spaced so that many points would about fill the ring
+        float area = glm::pi<float>() * (wave.far * wave.far - wave.near * wave.near);
+        float spacing = 0.7f * sqrtf(area / spawn_points_g);
+
+        for (int tries = 0; tries < spawn_points_g * dart_tries_g && points.size() < spawn_points_g; tries++) {
+            // even over the ring's area, so the square root on the radius
+            float angle = random.Range(0.0f, 2.0f * glm::pi<float>());
+            float radius = sqrtf(random.Range(wave.near * wave.near, wave.far * wave.far));
+            glm::vec3 point(radius * cosf(angle), radius * sinf(angle), 0.0f);
+
+            bool clear = true;
+            for (int p = 0; p < points.size() && clear; p++) {
+                glm::vec3 d = points[p] - point;
+                clear = d.x * d.x + d.y * d.y >= spacing * spacing;
+            }
+            if (clear) points.push_back(point);
+        }
+        Shuffle(points, random);
+    }
+}
+
+
+void SpawnDirector::Update(double delta_time, int score, int enemies, int buffs)
+{
+    budget_left_ = budget_;
+
+    // spawns queued before the score moved on (past their row, or up to its limit) never come out
+    int kept = 0;
+    queued_[SpawnWave::ENEMY] = 0;
+    queued_[SpawnWave::BUFF] = 0;
+    for (int i = 0; i < queue_.size(); i++) {
+        const SpawnWave &wave = waves_[queue_[i]];
+        int alive = (wave.kind == SpawnWave::ENEMY) ? enemies : buffs;
+        if (!Applies(wave, score, alive, queued_[wave.kind])) continue;
+        queue_[kept++] = queue_[i];
+        queued_[wave.kind]++;
+    }
+    queue_.resize(kept);
+
+    for (int w = 0; w < waves_.size(); w++) {
+        const SpawnWave &wave = waves_[w];
+
+        // a row that doesnt apply, or has nowhere to put anything, starts its count over
+        int alive = (wave.kind == SpawnWave::ENEMY) ? enemies : buffs;
+        int room = wave.cap - alive - queued_[wave.kind];
+        if (wave.limit > 0) room = std::min(room, wave.limit - score - alive - queued_[wave.kind]);
+        if (!Applies(wave, score, alive, queued_[wave.kind]) || points_[w].empty() || room <= 0) {
+            wait_[w] = wave.every;
+            continue;
+        }
+
+        if (wave.every <= 0.0f) {
+            if (done_[w]) continue;
+            done_[w] = true;
+        }
+        else {
+            wait_[w] -= delta_time;
+            if (wait_[w] > 0.0) continue;
+            wait_[w] = wave.every;
+        }
+
+        int count = std::min(wave.count, room);
+        for (int i = 0; i < count; i++) queue_.push_back(w);
+        queued_[wave.kind] += count;
+    }
+}
+
+
+bool SpawnDirector::Next(const glm::vec3 &centre, Random &random, Spawn &spawn)
+{
+    if (budget_left_ <= 0 || queue_.empty()) return false;
+    budget_left_--;
+
+    int w = queue_.front();
+    queue_.pop_front();
+    const SpawnWave &wave = waves_[w];
+    queued_[wave.kind]--;
+
+    // the row's points in their shuffled order, shuffling again each time round
+    std::vector<glm::vec3> &points = points_[w];
+    if (next_point_[w] >= points.size()) {
+        Shuffle(points, random);
+        next_point_[w] = 0;
+    }
+
+    spawn.kind = wave.kind;
+    spawn.position = centre + points[next_point_[w]++];
+    spawn.tough = wave.kind == SpawnWave::ENEMY && random.Float() < wave.tough;
+    return true;
+}
+
+
+void SpawnDirector::Save(Snapshot &snapshot) const
+{
+    snapshot.Put(budget_);
+    snapshot.Put(budget_left_);
+    snapshot.PutArray(queued_, 2);
+
+    snapshot.Put(static_cast<int>(waves_.size()));
+    snapshot.PutArray(waves_.data(), waves_.size());
+    for (int w = 0; w < waves_.size(); w++) {
+        snapshot.Put(wait_[w]);
+        snapshot.Put(static_cast<bool>(done_[w]));
+        snapshot.Put(next_point_[w]);
+        snapshot.Put(static_cast<int>(points_[w].size()));
+        for (int p = 0; p < points_[w].size(); p++) snapshot.PutArray(&points_[w][p].x, 3);
+    }
+
+    snapshot.Put(static_cast<int>(queue_.size()));
+    for (int i = 0; i < queue_.size(); i++) snapshot.Put(queue_[i]);
+}
+
+
+void SpawnDirector::Load(Snapshot &snapshot)
+{
+    budget_ = snapshot.Get<int>();
+    budget_left_ = snapshot.Get<int>();
+    snapshot.GetArray(queued_, 2);
+
+    waves_.resize(snapshot.Get<int>());
+    snapshot.GetArray(waves_.data(), waves_.size());
+    wait_.resize(waves_.size());
+    done_.resize(waves_.size());
+    next_point_.resize(waves_.size());
+    points_.resize(waves_.size());
+    for (int w = 0; w < waves_.size(); w++) {
+        wait_[w] = snapshot.Get<double>();
+        done_[w] = snapshot.Get<bool>();
+        next_point_[w] = snapshot.Get<int>();
+        points_[w].resize(snapshot.Get<int>());
+        for (int p = 0; p < points_[w].size(); p++) snapshot.GetArray(&points_[w][p].x, 3);
+    }
+
+    queue_.resize(snapshot.Get<int>());
+    for (int i = 0; i < queue_.size(); i++) queue_[i] = snapshot.Get<int>();
+}
+
+
+void SpawnDirector::Print(std::ostream &out) const
+{
+    out << "Waves (budget " << budget_ << " a tick):" << std::endl;
+    for (int w = 0; w < waves_.size(); w++) {
+        const SpawnWave &wave = waves_[w];
+        out << "  " << ((wave.kind == SpawnWave::ENEMY) ? "enemy" : "buff") << " at " << wave.from_score << " to " << wave.to_score << " points: ";
+        if (wave.every > 0.0f) out << wave.count << " every " << wave.every << "s";
+        else out << wave.count << " once";
+        out << " up to " << wave.cap;
+        if (wave.limit > 0) out << " while the score and those add up to less than " << wave.limit;
+        out << ", " << wave.near << " to " << wave.far << " away";
+        if (wave.kind == SpawnWave::ENEMY && wave.tough > 0.0f) out << ", " << wave.tough << " sea monsters";
+        out << std::endl;
+    }
+}
+
+} // namespace game
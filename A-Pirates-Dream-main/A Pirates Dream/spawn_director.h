@@ -0,0 +1,121 @@
+#ifndef SPAWN_DIRECTOR_H_
+#define SPAWN_DIRECTOR_H_
+
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "random_streams.h"
+
+namespace game {
+
+    class Snapshot;
+
+    // One row of a wave table: while the score is in [from_score, to_score), every `every` seconds queue count
+    // spawns, as long as fewer than cap of that kind are alive or queued (and the score plus those stays under limit)
+    struct SpawnWave {
+
+        enum Kind { ENEMY, BUFF };
+
+        Kind kind;
+        int from_score;
+        int to_score;
+
+        // seconds between waves, 0 for a single wave as soon as the row applies
+        float every;
+        int count;
+        int cap;
+
+        // no spawns once the score plus the kind alive or queued reaches this, 0 for no limit
+        // (the classic game's 25: every enemy it spawns is a point towards the boss, so the boss comes out alone)
+        int limit;
+
+        // chance each enemy is a sea monster rather than a navy ship
+        float tough;
+
+        // the ring round the player (so round the camera) the spawns land in
+        float near;
+        float far;
+
+    }; // struct SpawnWave
+
+
+    // Where and what to spawn, handed out by SpawnDirector::Next()
+    struct Spawn {
+        SpawnWave::Kind kind;
+        glm::vec3 position;
+        bool tough;
+    };
+
+
+    /*
+        SpawnDirector decides when the normal game spawns enemies and buffs, and where, from a wave table.
+        Waves that come due are queued, and Next() hands out at most the budget's worth of the queue each
+        tick, so a big wave lands over a few ticks instead of all at once.
+
+        Each row gets its spawn points when the director starts: a Poisson disk spread (no two closer than a
+        set spacing) over its ring, worked out once. A spawn takes the next of its row's points, in a shuffled
+        order, around the player, so finding somewhere to put it never loops.
+    */
+    class SpawnDirector {
+
+        public:
+            // Starts with the classic table (see waves/classic.cfg) and a budget of 2 spawns a tick
+            SpawnDirector(void);
+
+            // Replace the table with one read from a file: "budget N" lines and rows of
+            // "enemy|buff from_score to_score every count cap limit tough near far", # comments, throws on a bad file
+            void Load(const std::string &filename);
+
+            // Set the most spawns handed out per tick
+            void SetBudget(int budget);
+
+            // Pick every row's spawn points and forget any queued spawns and wave timing, before a game starts
+            void Start(Random &random);
+
+            // Drop queued spawns whose row no longer applies, then count down the rows that apply and queue the waves
+            // that come due, given how many enemies and buffs are alive
+            void Update(double delta_time, int score, int enemies, int buffs);
+
+            // The next queued spawn around centre, false once this tick's budget is spent or the queue is empty
+            // The budget comes back on the next Update()
+            bool Next(const glm::vec3 &centre, Random &random, Spawn &spawn);
+
+            // Spawns queued but not handed out yet
+            inline int GetQueued(void) const { return static_cast<int>(queue_.size()); }
+
+            // Save and restore the table, the spawn points and where every row and the queue are up to
+            void Save(Snapshot &snapshot) const;
+            void Load(Snapshot &snapshot);
+
+            // Print the table
+            void Print(std::ostream &out) const;
+
+        private:
+            // Set up the timing and spawn points for the rows, after the table changes
+            void Reset(void);
+
+            std::vector<SpawnWave> waves_;
+
+            // per row: seconds until its next wave, whether its single wave went out, and its spawn points with the next one to use
+            std::vector<double> wait_;
+            std::vector<bool> done_;
+            std::vector<std::vector<glm::vec3> > points_;
+            std::vector<int> next_point_;
+
+            // rows whose spawns are waiting to be handed out, oldest first
+            std::deque<int> queue_;
+
+            // queued spawns of each kind, counted against the caps
+            int queued_[2];
+
+            int budget_;
+            int budget_left_;
+
+    }; // class SpawnDirector
+
+} // namespace game
+
+#endif // SPAWN_DIRECTOR_H_
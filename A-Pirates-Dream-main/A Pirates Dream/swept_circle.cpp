@@ -0,0 +1,178 @@
+#include <cfloat>
+#include <cmath>
+
+#include "swept_circle.h"
+
+#if defined(__AVX2__)
+#define APD_SWEPT_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define APD_SWEPT_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace game {
+
+void CircleBatch::Clear(void)
+{
+    x_.clear();
+    y_.clear();
+    radius_sq_.clear();
+}
+
+
+int CircleBatch::Add(const glm::vec3 &centre, float radius_sq)
+{
+    x_.push_back(centre.x);
+    y_.push_back(centre.y);
+    radius_sq_.push_back(radius_sq);
+    return x_.size() - 1;
+}
+
+
+// one circle at a time, used for whatever doesnt fill a whole vector register
+// the terms that only depend on the step (dx, dy, a) come in already worked out
+static inline void SweepOne(float sx, float sy, float dx, float dy, float a, float x, float y, float radius_sq, unsigned char *hit, float *toi)
+{
+    // vector from the circle centre to the start of the step
+    float scx = sx - x;
+    float scy = sy - y;
+
+    float b = 2.0f * (dx * scx + dy * scy);
+    float c = scx * scx + scy * scy - radius_sq;
+    float disc = b * b - 4.0f * a * c;
+
+    if (disc < 0.0f || a <= 0.0f) {
+        *hit = 0;
+        *toi = FLT_MAX;
+        return;
+    }
+
+    float root = sqrtf(disc);
+
+    // t1 <= 0 and t2 >= 1, with both sides multiplied by 2a so there's only the one divide for the time of impact
+    *hit = ((-b - root) <= 0.0f && (-b + root) >= 2.0f * a) ? 1 : 0;
+    *toi = (-b - root) / (2.0f * a);
+}
+
+
+int SweepCircles(const glm::vec3 &start, const glm::vec3 &step, const float *x, const float *y, const float *radius_sq, int count, unsigned char *hit, float *toi)
+{
+    const float sx = start.x;
+    const float sy = start.y;
+    const float dx = step.x;
+    const float dy = step.y;
+    const float a = dx * dx + dy * dy;
+
+    int i = 0;
+
+#if defined(APD_SWEPT_AVX2)
+    {
+        const __m256 vsx = _mm256_set1_ps(sx);
+        const __m256 vsy = _mm256_set1_ps(sy);
+        const __m256 vdx2 = _mm256_set1_ps(2.0f * dx);
+        const __m256 vdy2 = _mm256_set1_ps(2.0f * dy);
+        const __m256 va4 = _mm256_set1_ps(4.0f * a);
+        const __m256 va2 = _mm256_set1_ps(2.0f * a);
+        const __m256 vinv = _mm256_set1_ps(a > 0.0f ? 1.0f / (2.0f * a) : 0.0f);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 miss = _mm256_set1_ps(FLT_MAX);
+        const __m256 valid = (a > 0.0f) ? _mm256_castsi256_ps(_mm256_set1_epi32(-1)) : zero;
+
+        for (; i + 8 <= count; i += 8) {
+            __m256 scx = _mm256_sub_ps(vsx, _mm256_loadu_ps(x + i));
+            __m256 scy = _mm256_sub_ps(vsy, _mm256_loadu_ps(y + i));
+
+            __m256 b = _mm256_add_ps(_mm256_mul_ps(vdx2, scx), _mm256_mul_ps(vdy2, scy));
+            __m256 c = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(scx, scx), _mm256_mul_ps(scy, scy)), _mm256_loadu_ps(radius_sq + i));
+            __m256 disc = _mm256_sub_ps(_mm256_mul_ps(b, b), _mm256_mul_ps(va4, c));
+
+            __m256 real = _mm256_and_ps(_mm256_cmp_ps(disc, zero, _CMP_GE_OQ), valid);
+            __m256 root = _mm256_sqrt_ps(_mm256_max_ps(disc, zero));
+            __m256 near_root = _mm256_sub_ps(_mm256_sub_ps(zero, b), root);
+            __m256 far_root = _mm256_add_ps(_mm256_sub_ps(zero, b), root);
+
+            __m256 inside = _mm256_and_ps(_mm256_cmp_ps(near_root, zero, _CMP_LE_OQ), _mm256_cmp_ps(far_root, va2, _CMP_GE_OQ));
+            int mask = _mm256_movemask_ps(_mm256_and_ps(real, inside));
+
+            _mm256_storeu_ps(toi + i, _mm256_blendv_ps(miss, _mm256_mul_ps(near_root, vinv), real));
+            for (int k = 0; k < 8; k++) {
+                hit[i + k] = (mask >> k) & 1;
+            }
+        }
+    }
+#elif defined(APD_SWEPT_SSE2)
+    {
+        const __m128 vsx = _mm_set1_ps(sx);
+        const __m128 vsy = _mm_set1_ps(sy);
+        const __m128 vdx2 = _mm_set1_ps(2.0f * dx);
+        const __m128 vdy2 = _mm_set1_ps(2.0f * dy);
+        const __m128 va4 = _mm_set1_ps(4.0f * a);
+        const __m128 va2 = _mm_set1_ps(2.0f * a);
+        const __m128 vinv = _mm_set1_ps(a > 0.0f ? 1.0f / (2.0f * a) : 0.0f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 miss = _mm_set1_ps(FLT_MAX);
+        const __m128 valid = (a > 0.0f) ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : zero;
+
+        for (; i + 4 <= count; i += 4) {
+            __m128 scx = _mm_sub_ps(vsx, _mm_loadu_ps(x + i));
+            __m128 scy = _mm_sub_ps(vsy, _mm_loadu_ps(y + i));
+
+            __m128 b = _mm_add_ps(_mm_mul_ps(vdx2, scx), _mm_mul_ps(vdy2, scy));
+            __m128 c = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(scx, scx), _mm_mul_ps(scy, scy)), _mm_loadu_ps(radius_sq + i));
+            __m128 disc = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(va4, c));
+
+            __m128 real = _mm_and_ps(_mm_cmpge_ps(disc, zero), valid);
+            __m128 root = _mm_sqrt_ps(_mm_max_ps(disc, zero));
+            __m128 near_root = _mm_sub_ps(_mm_sub_ps(zero, b), root);
+            __m128 far_root = _mm_add_ps(_mm_sub_ps(zero, b), root);
+
+            __m128 inside = _mm_and_ps(_mm_cmple_ps(near_root, zero), _mm_cmpge_ps(far_root, va2));
+            int mask = _mm_movemask_ps(_mm_and_ps(real, inside));
+
+            // no blendv before SSE4.1, so pick between the two with and/andnot
+            __m128 t = _mm_mul_ps(near_root, vinv);
+            _mm_storeu_ps(toi + i, _mm_or_ps(_mm_and_ps(real, t), _mm_andnot_ps(real, miss)));
+            for (int k = 0; k < 4; k++) {
+                hit[i + k] = (mask >> k) & 1;
+            }
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        SweepOne(sx, sy, dx, dy, a, x[i], y[i], radius_sq[i], hit + i, toi + i);
+    }
+
+    // earliest impact among the hits
+    int best = -1;
+    for (int k = 0; k < count; k++) {
+        if (hit[k] && (best == -1 || toi[k] < toi[best])) best = k;
+    }
+    return best;
+}
+
+
+int SweepCircles(const glm::vec3 &start, const glm::vec3 &step, const CircleBatch &batch, std::vector<unsigned char> &hit, std::vector<float> &toi)
+{
+    int count = batch.GetSize();
+    hit.resize(count);
+    toi.resize(count);
+    if (count == 0) return -1;
+
+    return SweepCircles(start, step, batch.GetX(), batch.GetY(), batch.GetRadiusSq(), count, hit.data(), toi.data());
+}
+
+
+const char *SweepCirclesPath(void)
+{
+#if defined(APD_SWEPT_AVX2)
+    return "avx2";
+#elif defined(APD_SWEPT_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace game
@@ -0,0 +1,54 @@
+#ifndef SWEPT_CIRCLE_H_
+#define SWEPT_CIRCLE_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace game {
+
+    /*
+        Batched swept circle test for projectiles.
+        A projectile's step (start to start + step) is tested against a batch of circles kept as packed x, y and
+        radius squared arrays, so several circles are handled per instruction. Uses AVX2 when the build enables it
+        (APD_AVX2 in CMake), SSE2 on any other x86 build, and plain scalar code everywhere else.
+
+        A circle counts as hit when the whole step lies inside it, the same rule Game::Update has always used for
+        bullets (both roots of the quadratic land outside [0, 1]).
+    */
+    class CircleBatch {
+
+        public:
+            // Forget every circle (keeps the memory for next time)
+            void Clear(void);
+
+            // Add a circle, returns its index in the batch
+            int Add(const glm::vec3 &centre, float radius_sq);
+
+            inline int GetSize(void) const { return x_.size(); }
+
+            inline const float *GetX(void) const { return x_.data(); }
+            inline const float *GetY(void) const { return y_.data(); }
+            inline const float *GetRadiusSq(void) const { return radius_sq_.data(); }
+
+        private:
+            std::vector<float> x_;
+            std::vector<float> y_;
+            std::vector<float> radius_sq_;
+
+    }; // class CircleBatch
+
+    // Test one step against count packed circles
+    // hit[i] is set to 1 or 0, toi[i] to the fraction of the step where it enters circle i (negative when it
+    // started inside, a huge value when the line misses the circle completely)
+    // Returns the hit circle with the earliest time of impact (lowest index on ties), or -1 if nothing was hit
+    int SweepCircles(const glm::vec3 &start, const glm::vec3 &step, const float *x, const float *y, const float *radius_sq, int count, unsigned char *hit, float *toi);
+
+    // Same as above for a whole CircleBatch, hit and toi are resized to fit
+    int SweepCircles(const glm::vec3 &start, const glm::vec3 &step, const CircleBatch &batch, std::vector<unsigned char> &hit, std::vector<float> &toi);
+
+    // Which instruction set the kernel was built for ("avx2", "sse2" or "scalar")
+    const char *SweepCirclesPath(void);
+
+} // namespace game
+
+#endif // SWEPT_CIRCLE_H_
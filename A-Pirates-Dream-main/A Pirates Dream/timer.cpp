@@ -1,46 +1,43 @@
-#include <GLFW/glfw3.h>
 #include <iostream>
 
 #include "timer.h"
 
 namespace game {
 
-Timer::Timer(void)
+Timer::Timer(TimerService *service)
 {
     // by default a timer is not active
-    is_active_ = false;
+    service_ = service ? service : &TimerService::Default();
+    handle_ = service_->Create();
 }
 
 
 Timer::~Timer(void)
 {
+    service_->Destroy(handle_);
 }
 
 
 void Timer::Start(float end_time)
 {
-    // set the start time to now
-    start_time_ = glfwGetTime();
-
-    // mark how long we want the timer to run   
-    end_time_ = end_time;
-
-    // and set the timer to be active
-    is_active_ = true;
+    // the service notes the start time from its clock and flags us once end_time seconds have passed
+    service_->Start(handle_, end_time);
 }
 
 
 
 int Timer::Finished(int i)
 {
+    TimerService::State state = service_->GetState(handle_);
+
     // if the timer hasnt been activated than we can have possibly reached the end
-    if (!is_active_) return 2;
+    if (state == TimerService::IDLE) return 2;
 
-    // if the current time - when we started the timer is greater than the number of seconds we want to run the timer than the timer has finished
-    if (glfwGetTime() - start_time_ > end_time_) 
+    // the service already flagged it as done when the clock passed the end time
+    if (state == TimerService::EXPIRED) 
     {
         // lets set it back to inactive so we can tell if we can use it again
-        if (i == 1) is_active_ = false;
+        if (i == 1) service_->Acknowledge(handle_);
         return 1;
     }
     
@@ -1,35 +1,45 @@
 #ifndef TIMER_H_
 #define TIMER_H_
 
-#include <GLFW/glfw3.h>
+#include <cstddef>
+
+#include "timer_service.h"
 
 namespace game {
 
     // A class implementing a simple timer
+    // This is only a handle, the TimerService keeps the actual state and flags the timer when it runs out
     class Timer {
 
         public:
-            // Constructor and destructor
-            Timer(void);
+            // Constructor and destructor, timers use the default service unless given another
+            Timer(TimerService *service = NULL);
             ~Timer();
 
             // Start the timer now: end time given in seconds
             void Start(float end_time); 
 
-            inline double GetTime(void) { return end_time_ - (glfwGetTime() - start_time_);   }
+            // Seconds left on the timer
+            inline double GetTime(void) const { return service_->Remaining(handle_); }
 
             // Check if timer has finished
+            // returns 2 if the timer isnt running, 1 if it ran out (and with i == 1 marks it as not running again), otherwise 0
             int Finished(int i = 1);
 
+            // Save and restore the timer exactly, for snapshots
+            inline void Save(Snapshot &snapshot) const { service_->Save(handle_, snapshot); }
+            inline void Load(Snapshot &snapshot) { service_->Load(handle_, snapshot); }
+
         private:
-            // the time we started the timer
-            float start_time_;
+            // timers own a slot in the service, so they cant be copied
+            Timer(const Timer &);
+            Timer &operator=(const Timer &);
 
-            // the number of seconds we want to run the timer for
-            float end_time_;
+            // the service that runs this timer
+            TimerService *service_;
 
-            // a checker to see if the timer has been started
-            bool is_active_;
+            // our slot in the service
+            TimerService::Handle handle_;
 
     }; // class Timer
 
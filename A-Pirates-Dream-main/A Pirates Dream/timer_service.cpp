@@ -0,0 +1,324 @@
+#include <cmath>
+
+#include "timer_service.h"
+#include "snapshot.h"
+
+namespace game {
+
+// one millisecond per wheel tick, so the four levels reach about four and a half hours
+const double TimerService::resolution_ = 0.001;
+
+
+TimerService::TimerService(void)
+{
+    buckets_.resize(num_levels_ * buckets_per_level_);
+    free_head_ = -1;
+    Reset(0.0);
+}
+
+
+TimerService &TimerService::Default(void)
+{
+    static TimerService service;
+    return service;
+}
+
+
+void TimerService::Reset(double now)
+{
+    // every slot goes back on the free list, bumping generations so old handles stop working
+    free_head_ = -1;
+    for (int i = slots_.size() - 1; i >= 0; i--) {
+        slots_[i].generation++;
+        slots_[i].state = IDLE;
+        slots_[i].bucket = -1;
+        slots_[i].prev = -1;
+        slots_[i].next = free_head_;
+        free_head_ = i;
+    }
+
+    for (int i = 0; i < buckets_.size(); i++) {
+        buckets_[i] = -1;
+    }
+
+    now_ = now;
+    current_tick_ = static_cast<long long>(floor(now_ / resolution_));
+    pending_ = 0;
+}
+
+
+void TimerService::Advance(double delta_time)
+{
+    now_ += delta_time;
+    long long target = static_cast<long long>(floor(now_ / resolution_));
+
+    // nothing can fire, so skip straight there
+    if (pending_ == 0) {
+        current_tick_ = target;
+        return;
+    }
+
+    const long long mask = buckets_per_level_ - 1;
+
+    while (current_tick_ < target) {
+        current_tick_++;
+
+        // when a lower level wraps around, the next bucket up gets spread back down
+        // go from the top so anything dropped from level 2 into level 1 is there when level 1 cascades
+        for (int level = num_levels_ - 1; level > 0; level--) {
+            int shift = bits_per_level_ * level;
+            if ((current_tick_ & ((1LL << shift) - 1)) == 0) {
+                Cascade(level, static_cast<int>((current_tick_ >> shift) & mask));
+            }
+        }
+
+        // everything left in this level 0 bucket runs out now
+        int bucket = static_cast<int>(current_tick_ & mask);
+        int index = buckets_[bucket];
+        while (index != -1) {
+            int next = slots_[index].next;
+            if (slots_[index].expire_tick <= current_tick_) {
+                Unlink(index);
+                slots_[index].state = EXPIRED;
+            }
+            index = next;
+        }
+
+        if (pending_ == 0) {
+            current_tick_ = target;
+        }
+    }
+}
+
+
+TimerService::Handle TimerService::Create(void)
+{
+    if (free_head_ == -1) {
+        Slot slot;
+        slot.generation = 0;
+        slot.next = -1;
+        slots_.push_back(slot);
+        free_head_ = slots_.size() - 1;
+    }
+
+    int index = free_head_;
+    Slot &slot = slots_[index];
+    free_head_ = slot.next;
+
+    slot.start = now_;
+    slot.duration = 0.0;
+    slot.expire_tick = 0;
+    slot.state = IDLE;
+    slot.next = -1;
+    slot.prev = -1;
+    slot.bucket = -1;
+
+    Handle handle = { index, slot.generation };
+    return handle;
+}
+
+
+void TimerService::Destroy(Handle handle)
+{
+    Slot *slot = Find(handle);
+    if (!slot) return;
+
+    if (slot->bucket != -1) Unlink(handle.index);
+
+    slot->generation++;
+    slot->state = IDLE;
+    slot->next = free_head_;
+    free_head_ = handle.index;
+}
+
+
+void TimerService::Start(Handle handle, double duration)
+{
+    Slot *slot = Find(handle);
+    if (!slot) return;
+
+    if (slot->bucket != -1) Unlink(handle.index);
+
+    slot->start = now_;
+    slot->duration = duration;
+    slot->expire_tick = static_cast<long long>(ceil((now_ + duration) / resolution_));
+    slot->state = RUNNING;
+
+    Insert(handle.index);
+}
+
+
+TimerService::State TimerService::GetState(Handle handle) const
+{
+    const Slot *slot = Find(handle);
+    return slot ? slot->state : IDLE;
+}
+
+
+void TimerService::Acknowledge(Handle handle)
+{
+    Slot *slot = Find(handle);
+    if (slot && slot->state == EXPIRED) slot->state = IDLE;
+}
+
+
+double TimerService::Remaining(Handle handle) const
+{
+    const Slot *slot = Find(handle);
+    if (!slot) return 0.0;
+
+    return slot->duration - (now_ - slot->start);
+}
+
+
+void TimerService::Save(Snapshot &snapshot) const
+{
+    snapshot.Put(now_);
+    snapshot.Put(current_tick_);
+}
+
+
+void TimerService::Load(Snapshot &snapshot)
+{
+    now_ = snapshot.Get<double>();
+    current_tick_ = snapshot.Get<long long>();
+
+    // the buckets a timer sits in depend on the tick it was put in at, so everything still running gets sorted in again
+    for (int i = 0; i < slots_.size(); i++) {
+        if (slots_[i].bucket != -1) {
+            Unlink(i);
+            Insert(i);
+        }
+    }
+}
+
+
+void TimerService::Save(Handle handle, Snapshot &snapshot) const
+{
+    const Slot *slot = Find(handle);
+    snapshot.Put(slot ? slot->start : now_);
+    snapshot.Put(slot ? slot->duration : 0.0);
+    snapshot.Put(slot ? slot->expire_tick : 0LL);
+    snapshot.Put(static_cast<int>(slot ? slot->state : IDLE));
+}
+
+
+void TimerService::Load(Handle handle, Snapshot &snapshot)
+{
+    double start = snapshot.Get<double>();
+    double duration = snapshot.Get<double>();
+    long long expire_tick = snapshot.Get<long long>();
+    State state = static_cast<State>(snapshot.Get<int>());
+
+    Slot *slot = Find(handle);
+    if (!slot) return;
+
+    if (slot->bucket != -1) Unlink(handle.index);
+    slot->start = start;
+    slot->duration = duration;
+    slot->expire_tick = expire_tick;
+    slot->state = state;
+    if (state == RUNNING) Insert(handle.index);
+}
+
+
+TimerService::Slot *TimerService::Find(Handle handle)
+{
+    if (handle.index < 0 || handle.index >= slots_.size()) return NULL;
+    Slot &slot = slots_[handle.index];
+    return (slot.generation == handle.generation) ? &slot : NULL;
+}
+
+
+const TimerService::Slot *TimerService::Find(Handle handle) const
+{
+    if (handle.index < 0 || handle.index >= slots_.size()) return NULL;
+    const Slot &slot = slots_[handle.index];
+    return (slot.generation == handle.generation) ? &slot : NULL;
+}
+
+
+void TimerService::Insert(int index)
+{
+    Slot &slot = slots_[index];
+
+    // the bucket for the current tick has already been handled, so the soonest we can fire is the next one
+    long long tick = slot.expire_tick;
+    if (tick <= current_tick_) tick = current_tick_ + 1;
+
+    // pick the lowest level whose span covers the wait
+    long long delta = tick - current_tick_;
+    int level = 0;
+    while (level < num_levels_ - 1 && delta >= (1LL << (bits_per_level_ * (level + 1)))) {
+        level++;
+    }
+
+    // too far out for the whole wheel, park it in the furthest bucket and it gets re-sorted when that cascades
+    long long span = 1LL << (bits_per_level_ * num_levels_);
+    if (delta >= span) {
+        tick = current_tick_ + span - 1;
+    }
+
+    int shift = bits_per_level_ * level;
+    int bucket = level * buckets_per_level_ + static_cast<int>((tick >> shift) & (buckets_per_level_ - 1));
+
+    // push onto the front of the bucket list
+    slot.bucket = bucket;
+    slot.prev = -1;
+    slot.next = buckets_[bucket];
+    if (slot.next != -1) slots_[slot.next].prev = index;
+    buckets_[bucket] = index;
+
+    pending_++;
+}
+
+
+void TimerService::Unlink(int index)
+{
+    Slot &slot = slots_[index];
+
+    if (slot.prev != -1) slots_[slot.prev].next = slot.next;
+    else buckets_[slot.bucket] = slot.next;
+    if (slot.next != -1) slots_[slot.next].prev = slot.prev;
+
+    slot.bucket = -1;
+    slot.next = -1;
+    slot.prev = -1;
+
+    pending_--;
+}
+
+
+void TimerService::Cascade(int level, int bucket_index)
+{
+    int bucket = level * buckets_per_level_ + bucket_index;
+
+    // detach the whole list first, since re-inserting could land timers back in this same bucket
+    int index = buckets_[bucket];
+    buckets_[bucket] = -1;
+
+    while (index != -1) {
+        int next = slots_[index].next;
+        slots_[index].bucket = -1;
+        pending_--;
+
+        // timers due right now belong in the level 0 bucket that is about to fire
+        if (slots_[index].expire_tick <= current_tick_) {
+            int now_bucket = static_cast<int>(current_tick_ & (buckets_per_level_ - 1));
+            Slot &slot = slots_[index];
+            slot.bucket = now_bucket;
+            slot.prev = -1;
+            slot.next = buckets_[now_bucket];
+            if (slot.next != -1) slots_[slot.next].prev = index;
+            buckets_[now_bucket] = index;
+            pending_++;
+        }
+        else {
+            Insert(index);
+        }
+
+        index = next;
+    }
+}
+
+} // namespace game
@@ -0,0 +1,118 @@
+#ifndef TIMER_SERVICE_H_
+#define TIMER_SERVICE_H_
+
+#include <vector>
+
+namespace game {
+
+    class Snapshot;
+
+    /*
+        TimerService owns every timer in the game and the simulation clock they run on.
+        The game advances the clock once per tick, and timers that run out on the way are flagged by a
+        hierarchical timing wheel, so checking a timer is just reading its flag (no clock reads, no scanning).
+        Games use the Default() service, tests and replays can make their own and drive time however they like.
+    */
+    class TimerService {
+
+        public:
+            // Lightweight reference to a timer slot, the generation catches use after Destroy
+            struct Handle {
+                int index;
+                unsigned int generation;
+            };
+
+            // What a timer is doing
+            enum State { IDLE = 0, RUNNING = 1, EXPIRED = 2 };
+
+            TimerService(void);
+
+            // The service the game's objects use unless they were given another one
+            static TimerService &Default(void);
+
+            // The clock snapshot for the current tick, in seconds
+            inline double Now(void) const { return now_; }
+
+            // Move the clock forward, flagging every timer that runs out along the way
+            void Advance(double delta_time);
+
+            // Drop every timer and set the clock back to the given time
+            void Reset(double now = 0.0);
+
+            // Allocate and free timer slots
+            Handle Create(void);
+            void Destroy(Handle handle);
+
+            // (Re)start a timer so it expires duration seconds from now
+            void Start(Handle handle, double duration);
+
+            // Current state of a timer, and flip an expired timer back to idle
+            State GetState(Handle handle) const;
+            void Acknowledge(Handle handle);
+
+            // Seconds left before the timer runs out (negative once it has)
+            double Remaining(Handle handle) const;
+
+            // Number of timers waiting in the wheel
+            inline int GetPendingCount(void) const { return pending_; }
+
+            // Save and restore the clock, restoring keeps every running timer's expiry tick
+            void Save(Snapshot &snapshot) const;
+            void Load(Snapshot &snapshot);
+
+            // Save and restore one timer exactly (not just the time left), so it runs out on the same tick as before
+            void Save(Handle handle, Snapshot &snapshot) const;
+            void Load(Handle handle, Snapshot &snapshot);
+
+        private:
+            // Wheel resolution in seconds, and shape: each level has 64 buckets, each covering 64 buckets of the level below
+            static const double resolution_;
+            static const int bits_per_level_ = 6;
+            static const int buckets_per_level_ = 1 << bits_per_level_;
+            static const int num_levels_ = 4;
+
+            struct Slot {
+                double start;
+                double duration;
+                long long expire_tick;
+                unsigned int generation;
+                State state;
+                // intrusive list links for the bucket the timer sits in, -1 terminated
+                int next;
+                int prev;
+                // which bucket it sits in, -1 when not in the wheel
+                int bucket;
+            };
+
+            // Look up a slot, returns NULL for stale handles
+            Slot *Find(Handle handle);
+            const Slot *Find(Handle handle) const;
+
+            // Put a running timer into the bucket its expiry tick falls in
+            void Insert(int index);
+
+            // Take a timer out of whatever bucket it is in
+            void Unlink(int index);
+
+            // Move every timer in a higher level bucket down to where it belongs now
+            void Cascade(int level, int bucket_index);
+
+            // clock in seconds and in wheel ticks
+            double now_;
+            long long current_tick_;
+
+            // all slots, and the head of the free slot list
+            std::vector<Slot> slots_;
+            int free_head_;
+
+            // heads of the bucket lists, level by level
+            std::vector<int> buckets_;
+
+            // timers currently in the wheel
+            int pending_;
+
+    }; // class TimerService
+
+} // namespace game
+
+#endif // TIMER_SERVICE_H_
@@ -0,0 +1,220 @@
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+
+#include "transform_store.h"
+#include "snapshot.h"
+
+namespace game {
+
+TransformStore::TransformStore(void)
+{
+    count_ = 0;
+    world_updates_ = 0;
+}
+
+
+TransformStore &TransformStore::Default(void)
+{
+    static TransformStore store;
+    return store;
+}
+
+
+int TransformStore::Create(const glm::vec3 &position)
+{
+    int index;
+
+    // fill holes first so the live rows stay packed towards the front
+    if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+    }
+    else {
+        index = x_.size();
+        x_.push_back(0.0f);
+        y_.push_back(0.0f);
+        vx_.push_back(0.0f);
+        vy_.push_back(0.0f);
+        angle_.push_back(0.0f);
+        scale_.push_back(0.0f);
+        prev_x_.push_back(0.0f);
+        prev_y_.push_back(0.0f);
+        prev_angle_.push_back(0.0f);
+        parent_.push_back(-1);
+        first_child_.push_back(-1);
+        next_sibling_.push_back(-1);
+        frame_.push_back(glm::mat4(1.0f));
+        world_.push_back(glm::mat4(1.0f));
+        alpha_.push_back(0.0f);
+        dirty_.push_back(1);
+        stamp_.push_back(0);
+        parent_stamp_.push_back(0);
+    }
+
+    x_[index] = position.x;
+    y_[index] = position.y;
+    vx_[index] = 0.0f;
+    vy_[index] = 0.0f;
+    angle_[index] = 0.0f;
+    scale_[index] = 1.0f;
+    prev_x_[index] = position.x;
+    prev_y_[index] = position.y;
+    prev_angle_[index] = 0.0f;
+    parent_[index] = -1;
+    first_child_[index] = -1;
+    next_sibling_[index] = -1;
+    dirty_[index] = 1;
+
+    count_++;
+    return index;
+}
+
+
+void TransformStore::Destroy(int index)
+{
+    if (index < 0 || index >= x_.size()) return;
+
+    // off its own parent's list, and its children let go of it, the row could be anything once it's reused
+    SetParent(index, -1);
+    for (int child = first_child_[index]; child >= 0; ) {
+        int next = next_sibling_[child];
+        parent_[child] = -1;
+        next_sibling_[child] = -1;
+        dirty_[child] = 1;
+        child = next;
+    }
+    first_child_[index] = -1;
+
+    free_.push_back(index);
+    count_--;
+}
+
+
+void TransformStore::SetParent(int i, int parent)
+{
+    // out of the old parent's list, rows only ever have a handful of children so walking it is cheap
+    int old = parent_[i];
+    if (old >= 0) {
+        int *link = &first_child_[old];
+        while (*link >= 0 && *link != i) link = &next_sibling_[*link];
+        if (*link == i) *link = next_sibling_[i];
+        next_sibling_[i] = -1;
+    }
+
+    parent_[i] = parent;
+    if (parent >= 0) {
+        next_sibling_[i] = first_child_[parent];
+        first_child_[parent] = i;
+    }
+    dirty_[i] = 1;
+}
+
+
+void TransformStore::SaveAll(void)
+{
+    // free rows get copied too, its cheaper than checking and they get overwritten by Create() anyway
+    // a row that moved last tick blends from somewhere new now, rows that stayed put keep their cached matrices
+    int n = x_.size();
+    for (int i = 0; i < n; i++) {
+        if (prev_x_[i] != x_[i] || prev_y_[i] != y_[i] || prev_angle_[i] != angle_[i]) dirty_[i] = 1;
+        prev_x_[i] = x_[i];
+        prev_y_[i] = y_[i];
+        prev_angle_[i] = angle_[i];
+    }
+}
+
+
+float TransformStore::InterpolatedAngle(int i, float alpha) const
+{
+    // Blend along the shorter way around the circle so we dont spin when the angle wraps past 2*pi
+    float pi = glm::pi<float>();
+    float diff = angle_[i] - prev_angle_[i];
+    if (diff > pi) diff -= 2.0f * pi;
+    if (diff < -pi) diff += 2.0f * pi;
+    return prev_angle_[i] + diff * alpha;
+}
+
+
+const glm::mat4 &TransformStore::Frame(int i, float alpha)
+{
+    int p = parent_[i];
+    const glm::mat4 *parent = (p >= 0) ? &Frame(p, alpha) : NULL;
+
+    // a row that didnt move last tick looks the same at any alpha, one that did is only the same at the alpha it was worked out at
+    bool still = prev_x_[i] == x_[i] && prev_y_[i] == y_[i] && prev_angle_[i] == angle_[i];
+    if (!dirty_[i] && (still || alpha_[i] == alpha) && (p < 0 || parent_stamp_[i] == stamp_[p])) return frame_[i];
+
+    // translate * rotate, written out since it only has the four numbers in it
+    float angle = InterpolatedAngle(i, alpha);
+    float c = cosf(angle);
+    float s = sinf(angle);
+    glm::mat4 local(1.0f);
+    local[0][0] = c;
+    local[0][1] = s;
+    local[1][0] = -s;
+    local[1][1] = c;
+    local[3][0] = InterpolatedX(i, alpha);
+    local[3][1] = InterpolatedY(i, alpha);
+
+    frame_[i] = parent ? *parent * local : local;
+
+    // scaling only stretches the x and y columns
+    world_[i] = frame_[i];
+    world_[i][0] *= scale_[i];
+    world_[i][1] *= scale_[i];
+
+    alpha_[i] = alpha;
+    dirty_[i] = 0;
+    stamp_[i]++;
+    parent_stamp_[i] = (p >= 0) ? stamp_[p] : 0;
+    world_updates_++;
+    return frame_[i];
+}
+
+
+glm::vec3 TransformStore::WorldPosition(int i, float alpha)
+{
+    glm::vec3 position(InterpolatedX(i, alpha), InterpolatedY(i, alpha), 0.0f);
+    if (parent_[i] < 0) return position;
+
+    const glm::mat4 &parent = Frame(parent_[i], alpha);
+    return glm::vec3(parent * glm::vec4(position, 1.0f));
+}
+
+
+float TransformStore::WorldScale(int i, float alpha)
+{
+    if (parent_[i] < 0) return fabsf(scale_[i]);
+
+    // whatever the parents did to it, the drawn sprite's corners are the x and y columns out from its centre
+    const glm::mat4 &world = World(i, alpha);
+    float x = world[0][0] * world[0][0] + world[0][1] * world[0][1];
+    float y = world[1][0] * world[1][0] + world[1][1] * world[1][1];
+    return sqrtf(x > y ? x : y);
+}
+
+
+void TransformStore::SaveRow(int i, Snapshot &snapshot) const
+{
+    float row[] = { x_[i], y_[i], vx_[i], vy_[i], angle_[i], scale_[i], prev_x_[i], prev_y_[i], prev_angle_[i] };
+    snapshot.PutArray(row, 9);
+}
+
+
+void TransformStore::LoadRow(int i, Snapshot &snapshot)
+{
+    float row[9];
+    snapshot.GetArray(row, 9);
+    x_[i] = row[0];
+    y_[i] = row[1];
+    vx_[i] = row[2];
+    vy_[i] = row[3];
+    angle_[i] = row[4];
+    scale_[i] = row[5];
+    prev_x_[i] = row[6];
+    prev_y_[i] = row[7];
+    prev_angle_[i] = row[8];
+    dirty_[i] = 1;
+}
+
+} // namespace game
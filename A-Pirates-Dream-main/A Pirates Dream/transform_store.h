@@ -0,0 +1,151 @@
+#ifndef TRANSFORM_STORE_H_
+#define TRANSFORM_STORE_H_
+
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace game {
+
+    class Snapshot;
+
+    /*
+        TransformStore keeps the position, velocity, rotation and scale of every game object in parallel arrays
+        (structure of arrays), one row per object. Passes that touch every object's transform, like saving the
+        previous tick's transform for interpolation, walk the arrays front to back instead of hopping between
+        objects scattered across the heap. GameObject's getters and setters read and write its row.
+        Games use the Default() store, tests and benchmarks can make their own.
+
+        Rows can hang off another row, then their position and rotation are relative to that parent's (the
+        parent's scale isnt passed down) and parents can nest any number of levels deep. Each row caches the
+        world matrix it was last drawn with: anything that writes a row marks it dirty with MarkDirty(), and a
+        row whose parent's matrix changed is redone too. A row that is dirty, or moved last tick and so gets
+        blended at a new alpha every frame, is worked out again, everything else just hands back its cache.
+    */
+    class TransformStore {
+
+        public:
+            TransformStore(void);
+
+            // The store the game's objects use unless they were given another one
+            static TransformStore &Default(void);
+
+            // Allocate a row for an object starting at position (not moving, no rotation, scale 1)
+            int Create(const glm::vec3 &position);
+
+            // Give a row back, its index gets reused by the next Create()
+            // Rows hanging off it are cut loose (left with no parent) so they never follow whatever reuses it
+            void Destroy(int index);
+
+            // Copy every row's position and rotation into its previous transform, one linear pass
+            void SaveAll(void);
+
+            // Same for a single row
+            inline void SaveRow(int i) { prev_x_[i] = x_[i]; prev_y_[i] = y_[i]; prev_angle_[i] = angle_[i]; dirty_[i] = 1; }
+
+            // Save and restore one row, previous transform included, for snapshots
+            void SaveRow(int i, Snapshot &snapshot) const;
+            void LoadRow(int i, Snapshot &snapshot);
+
+            // Say a row's position, rotation or scale changed, so its cached matrices (and its children's) get redone
+            // Rows are only ever marked by whoever owns them, so objects on different threads can mark their own rows
+            inline void MarkDirty(int i) { dirty_[i] = 1; }
+
+            // Hang a row off another, -1 for none, a new row starts with none
+            // The caller never makes a loop, and a parent that's destroyed lets go of its rows
+            void SetParent(int i, int parent);
+            inline int GetParent(int i) const { return parent_[i]; }
+
+            // The row's world matrix blended alpha of the way from the previous tick's transform to the current one,
+            // translate * rotate from every parent down to the row, then scaled by the row's own scale
+            inline const glm::mat4 &World(int i, float alpha)
+            {
+                Frame(i, alpha);
+                return world_[i];
+            }
+
+            // Where the row is in the world at alpha, only its parents' matrices get worked out for it (a row
+            // hanging off nothing is just its blended position), for culling before deciding to draw it
+            glm::vec3 WorldPosition(int i, float alpha);
+
+            // How much the row's world matrix scales things up at alpha (its longest basis column), so culling never
+            // takes a bounding circle smaller than what's drawn, just the row's scale for a row hanging off nothing
+            float WorldScale(int i, float alpha);
+
+            // Transform blended between the previous and current tick, alpha in [0, 1], relative to the parent
+            inline float InterpolatedX(int i, float alpha) const { return prev_x_[i] + (x_[i] - prev_x_[i]) * alpha; }
+            inline float InterpolatedY(int i, float alpha) const { return prev_y_[i] + (y_[i] - prev_y_[i]) * alpha; }
+            float InterpolatedAngle(int i, float alpha) const;
+
+            // How many times a row's matrices have been worked out rather than taken from the cache
+            inline long GetWorldUpdates(void) const { return world_updates_; }
+
+            // Rows in use, and rows allocated (the arrays' length)
+            inline int GetCount(void) const { return count_; }
+            inline int GetCapacity(void) const { return x_.size(); }
+
+            // Access to one row
+            inline float &X(int i) { return x_[i]; }
+            inline float &Y(int i) { return y_[i]; }
+            inline float &VelocityX(int i) { return vx_[i]; }
+            inline float &VelocityY(int i) { return vy_[i]; }
+            inline float &Angle(int i) { return angle_[i]; }
+            inline float &Scale(int i) { return scale_[i]; }
+
+            inline float X(int i) const { return x_[i]; }
+            inline float Y(int i) const { return y_[i]; }
+            inline float VelocityX(int i) const { return vx_[i]; }
+            inline float VelocityY(int i) const { return vy_[i]; }
+            inline float Angle(int i) const { return angle_[i]; }
+            inline float Scale(int i) const { return scale_[i]; }
+            inline float PreviousX(int i) const { return prev_x_[i]; }
+            inline float PreviousY(int i) const { return prev_y_[i]; }
+            inline float PreviousAngle(int i) const { return prev_angle_[i]; }
+
+        private:
+            // The row's world translate * rotate at alpha (no scale, this is what its children hang off), redoing it and
+            // world_[i] if the cache is out of date, parents first
+            const glm::mat4 &Frame(int i, float alpha);
+
+            // the current transform
+            std::vector<float> x_;
+            std::vector<float> y_;
+            std::vector<float> vx_;
+            std::vector<float> vy_;
+            std::vector<float> angle_;
+            std::vector<float> scale_;
+
+            // transform at the start of the tick, for interpolated rendering
+            std::vector<float> prev_x_;
+            std::vector<float> prev_y_;
+            std::vector<float> prev_angle_;
+
+            // the row each row hangs off, -1 for none
+            std::vector<int> parent_;
+
+            // the rows hanging off each row as a list, the first one and then each one's next, -1 ends it
+            std::vector<int> first_child_;
+            std::vector<int> next_sibling_;
+
+            // the cached matrices: frame_ without the row's scale (what children build on) and world_ with it,
+            // the alpha they were worked out at, and whether the row changed since
+            std::vector<glm::mat4> frame_;
+            std::vector<glm::mat4> world_;
+            std::vector<float> alpha_;
+            std::vector<unsigned char> dirty_;
+
+            // bumped every time a row's matrices are redone, a child redoes its own when its parent's stamp isnt the one it was built from
+            std::vector<unsigned int> stamp_;
+            std::vector<unsigned int> parent_stamp_;
+
+            long world_updates_;
+
+            // rows given back by Destroy(), reused before the arrays grow
+            std::vector<int> free_;
+
+            int count_;
+
+    }; // class TransformStore
+
+} // namespace game
+
+#endif // TRANSFORM_STORE_H_
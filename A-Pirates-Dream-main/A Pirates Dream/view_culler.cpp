@@ -0,0 +1,65 @@
+#include <cmath>
+
+#include "view_culler.h"
+
+namespace game {
+
+ViewCuller::ViewCuller(void)
+{
+    // nothing is culled until there's a view
+    for (int e = 0; e < 4; e++) {
+        a_[e] = 0.0f;
+        b_[e] = 0.0f;
+        d_[e] = 1.0f;
+    }
+    tested_ = 0;
+    drawn_ = 0;
+}
+
+
+void ViewCuller::SetView(const glm::mat4 &view_matrix)
+{
+    // glm matrices are indexed column first, so row r is view_matrix[0][r], [1][r] and [3][r] (z is always 0)
+    const float sign[] = { 1.0f, -1.0f, 1.0f, -1.0f };
+    const int row[] = { 0, 0, 1, 1 };
+    for (int e = 0; e < 4; e++) {
+        float a = view_matrix[0][3] + sign[e] * view_matrix[0][row[e]];
+        float b = view_matrix[1][3] + sign[e] * view_matrix[1][row[e]];
+        float d = view_matrix[3][3] + sign[e] * view_matrix[3][row[e]];
+
+        // a view that squashes everything onto a line has no inside to speak of, so let it all through
+        float length = sqrtf(a * a + b * b);
+        if (length == 0.0f) {
+            a_[e] = 0.0f;
+            b_[e] = 0.0f;
+            d_[e] = 1.0f;
+            continue;
+        }
+
+        a_[e] = a / length;
+        b_[e] = b / length;
+        d_[e] = d / length;
+    }
+}
+
+
+int ViewCuller::Cull(const float *x, const float *y, const float *radius, int count, int *visible)
+{
+    // every index gets written and the count only moves on for circles on screen, so theres no branch to mispredict
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        float r = -radius[i];
+        bool inside = (a_[0] * x[i] + b_[0] * y[i] + d_[0] >= r)
+                    & (a_[1] * x[i] + b_[1] * y[i] + d_[1] >= r)
+                    & (a_[2] * x[i] + b_[2] * y[i] + d_[2] >= r)
+                    & (a_[3] * x[i] + b_[3] * y[i] + d_[3] >= r);
+        visible[n] = i;
+        n += inside;
+    }
+
+    tested_ += count;
+    drawn_ += n;
+    return n;
+}
+
+} // namespace game
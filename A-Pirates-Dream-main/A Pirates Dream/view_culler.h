@@ -0,0 +1,57 @@
+#ifndef VIEW_CULLER_H_
+#define VIEW_CULLER_H_
+
+#include <glm/glm.hpp>
+
+namespace game {
+
+    /*
+        ViewCuller works out which objects the camera can see before anything is drawn. The four edges of the
+        screen are taken straight from the view matrix the objects are drawn with (clip space runs -1 to 1, so
+        each edge is the matrix's w row plus or minus its x or y row) and an object counts as seen when its
+        bounding circle is on the inside of all four, or crosses one.
+
+        Cull() takes a whole batch of circles as packed x, y and radius arrays and hands back the indices of the
+        ones on screen, and keeps a count of how many it passed and how many it threw away for the HUD.
+    */
+    class ViewCuller {
+
+        public:
+            ViewCuller(void);
+
+            // Take the screen's edges from the view matrix, everything lies at z = 0
+            void SetView(const glm::mat4 &view_matrix);
+
+            // Whether a circle is at least partly on screen
+            inline bool IsVisible(float x, float y, float radius) const
+            {
+                for (int e = 0; e < 4; e++) {
+                    if (a_[e] * x + b_[e] * y + d_[e] < -radius) return false;
+                }
+                return true;
+            }
+
+            // Test count circles, writes the index of each one on screen to visible (which has room for count) in
+            // order, and returns how many there were
+            int Cull(const float *x, const float *y, const float *radius, int count, int *visible);
+
+            // Circles Cull() has passed and thrown away since the counts were last reset
+            inline long GetDrawn(void) const { return drawn_; }
+            inline long GetCulled(void) const { return tested_ - drawn_; }
+            inline void ResetCounts(void) { tested_ = 0; drawn_ = 0; }
+
+        private:
+            // the edges as a * x + b * y + d >= 0 on the inside, scaled so that's the distance in world units:
+            // left, right, bottom, top
+            float a_[4];
+            float b_[4];
+            float d_[4];
+
+            long tested_;
+            long drawn_;
+
+    }; // class ViewCuller
+
+} // namespace game
+
+#endif // VIEW_CULLER_H_